@@ -0,0 +1,106 @@
+#define DT_DRV_COMPAT zephyr_pwm_emul
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/pwm.h>
+#include "pwm_emul.h"
+
+/**
+ * @file pwm_emul.c
+ * @brief PWM controller emulator for native_sim.
+ *
+ * Generates no waveform: it keeps the period, pulse and flags last set on
+ * each channel so that the TC74 emulator can heat its thermal model with
+ * the duty cycle, as the real heater averages the PWM output.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define PWM_EMUL_CHANNELS 4                 /**< Channels per controller */
+#define PWM_EMUL_CYCLES_PER_SEC 1000000ULL  /**< One cycle per microsecond */
+
+/** Last setting of a channel */
+struct pwm_emul_channel {
+    uint32_t period;                /**< Period (cycles), 0 if never set */
+    uint32_t pulse;                 /**< Active time (cycles) */
+    pwm_flags_t flags;              /**< Polarity */
+};
+
+/** Per-instance emulator state */
+struct pwm_emul_data {
+    struct k_spinlock lock;         /**< Protects the channels */
+    struct pwm_emul_channel channels[PWM_EMUL_CHANNELS];
+};
+
+
+static int pwm_emul_set_cycles(const struct device *dev, uint32_t channel, uint32_t period_cycles,
+                               uint32_t pulse_cycles, pwm_flags_t flags) {
+    struct pwm_emul_data *data = dev->data;
+
+    if (channel >= PWM_EMUL_CHANNELS || pulse_cycles > period_cycles) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    data->channels[channel].period = period_cycles;
+    data->channels[channel].pulse = pulse_cycles;
+    data->channels[channel].flags = flags;
+    k_spin_unlock(&data->lock, key);
+    return 0;
+}
+
+
+static int pwm_emul_get_cycles_per_sec(const struct device *dev, uint32_t channel, uint64_t *cycles) {
+    ARG_UNUSED(dev);
+
+    if (channel >= PWM_EMUL_CHANNELS) {
+        return -EINVAL;
+    }
+    *cycles = PWM_EMUL_CYCLES_PER_SEC;
+    return 0;
+}
+
+
+/**
+ * @brief Get the duty cycle of an emulated PWM channel.
+ * @param dev PWM emulator device.
+ * @param channel Channel number.
+ * @param permille Fraction of the period the output is high, in ‰.
+ * @return 0 on success, -EINVAL for a bad channel, -ENODATA if never set.
+ */
+int pwm_emul_duty_get(const struct device *dev, uint32_t channel, uint16_t *permille) {
+    struct pwm_emul_data *data = dev->data;
+
+    if (channel >= PWM_EMUL_CHANNELS) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    struct pwm_emul_channel ch = data->channels[channel];
+    k_spin_unlock(&data->lock, key);
+
+    if (ch.period == 0) {
+        return -ENODATA;
+    }
+
+    uint32_t high = (ch.flags & PWM_POLARITY_INVERTED) ? ch.period - ch.pulse : ch.pulse;
+    *permille = (uint16_t)((uint64_t)high * 1000U / ch.period);
+    return 0;
+}
+
+
+static const struct pwm_driver_api pwm_emul_api = {
+    .set_cycles = pwm_emul_set_cycles,
+    .get_cycles_per_sec = pwm_emul_get_cycles_per_sec,
+};
+
+
+#define PWM_EMUL(inst)                                                          \
+    static struct pwm_emul_data pwm_emul_data_##inst;                          \
+    DEVICE_DT_INST_DEFINE(inst, NULL, NULL, &pwm_emul_data_##inst, NULL,        \
+                          POST_KERNEL, CONFIG_PWM_INIT_PRIORITY, &pwm_emul_api);
+
+DT_INST_FOREACH_STATUS_OKAY(PWM_EMUL)
@@ -0,0 +1,19 @@
+#ifndef PWM_EMUL_H
+#define PWM_EMUL_H
+
+#include <zephyr/device.h>
+#include <stdint.h>
+
+/**
+ * @brief Get the duty cycle of an emulated PWM channel.
+ *
+ * @param dev PWM emulator device.
+ * @param channel Channel number.
+ * @param permille Fraction of the period the output is high, in ‰
+ *                 (inverted polarity already taken into account).
+ * @return 0 on success, -EINVAL for a bad channel, -ENODATA if the
+ *         channel was never set.
+ */
+int pwm_emul_duty_get(const struct device *dev, uint32_t channel, uint16_t *permille);
+
+#endif
@@ -0,0 +1,183 @@
+#define DT_DRV_COMPAT microchip_tc74
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/sys/atomic.h>
+#include "tc74.h"
+
+/**
+ * @file tc74.c
+ * @brief Driver for the Microchip TC74 I2C temperature sensor.
+ *
+ * Implements the Zephyr sensor API (SENSOR_CHAN_AMBIENT_TEMP, 1 °C
+ * resolution) for every enabled "microchip,tc74" devicetree node. Each
+ * read is an SMBus Read Byte of the temperature register (RTR), so no
+ * register pointer state has to be kept between reads.
+ *
+ * tc74_fetch_async() issues the same transaction with i2c_transfer_cb()
+ * so that a caller can keep several sensors in flight and sleep until
+ * they complete.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define TC74_CMD_RTR 0x00           /**< Read temperature register */
+#define TC74_CMD_RWCR 0x01          /**< Read/write configuration register */
+#define TC74_CFG_STANDBY BIT(7)     /**< Configuration register standby bit */
+
+/** Per-instance constant configuration */
+struct tc74_config {
+    struct i2c_dt_spec i2c;         /**< Bus and address of the sensor */
+};
+
+/** Per-instance runtime data */
+struct tc74_data {
+    int8_t sample;                  /**< Last temperature read, in °C */
+    atomic_t busy;                  /**< Set while an asynchronous fetch is in flight */
+    uint8_t cmd;                    /**< Command byte of the asynchronous fetch */
+    uint8_t rx;                     /**< Receive byte of the asynchronous fetch */
+    struct i2c_msg msgs[2];         /**< Messages of the asynchronous fetch */
+    tc74_callback_t cb;             /**< Completion callback of the asynchronous fetch */
+    void *user_data;                /**< Argument of the completion callback */
+};
+
+
+/**
+ * @brief Reads the temperature register (blocking).
+ */
+static int tc74_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    const struct tc74_config *cfg = dev->config;
+    struct tc74_data *data = dev->data;
+    uint8_t cmd = TC74_CMD_RTR;
+    uint8_t val;
+
+    if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_AMBIENT_TEMP) {
+        return -ENOTSUP;
+    }
+
+    int ret = i2c_write_read_dt(&cfg->i2c, &cmd, 1, &val, 1);
+    if (ret == 0) {
+        data->sample = (int8_t)val;
+    }
+    return ret;
+}
+
+
+/**
+ * @brief Returns the last fetched temperature.
+ */
+static int tc74_channel_get(const struct device *dev, enum sensor_channel chan,
+                            struct sensor_value *val) {
+    struct tc74_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_AMBIENT_TEMP) {
+        return -ENOTSUP;
+    }
+
+    val->val1 = data->sample;
+    val->val2 = 0;
+    return 0;
+}
+
+
+#if defined(CONFIG_I2C_CALLBACK)
+/**
+ * @brief Bus completion callback of an asynchronous fetch (interrupt context).
+ */
+static void tc74_transfer_done(const struct device *bus, int result, void *arg) {
+    const struct device *dev = arg;
+    struct tc74_data *data = dev->data;
+
+    ARG_UNUSED(bus);
+
+    if (result == 0) {
+        data->sample = (int8_t)data->rx;
+    }
+    atomic_clear(&data->busy);
+    data->cb(dev, result, data->user_data);
+}
+#endif
+
+
+int tc74_fetch_async(const struct device *dev, tc74_callback_t cb, void *user_data) {
+    struct tc74_data *data = dev->data;
+    int ret;
+
+    /* The messages and buffers belong to the transfer until it completes */
+    if (!atomic_cas(&data->busy, 0, 1)) {
+        return -EBUSY;
+    }
+
+#if defined(CONFIG_I2C_CALLBACK)
+    const struct tc74_config *cfg = dev->config;
+
+    data->cb = cb;
+    data->user_data = user_data;
+    data->cmd = TC74_CMD_RTR;
+    data->msgs[0].buf = &data->cmd;
+    data->msgs[0].len = 1;
+    data->msgs[0].flags = I2C_MSG_WRITE;
+    data->msgs[1].buf = &data->rx;
+    data->msgs[1].len = 1;
+    data->msgs[1].flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP;
+
+    ret = i2c_transfer_cb_dt(&cfg->i2c, data->msgs, 2, tc74_transfer_done, (void *)dev);
+    if (ret != -ENOSYS) {
+        if (ret != 0) {
+            atomic_clear(&data->busy);
+        }
+        return ret;
+    }
+#endif
+
+    /* No callback support on this bus: fetch synchronously */
+    ret = tc74_sample_fetch(dev, SENSOR_CHAN_AMBIENT_TEMP);
+    atomic_clear(&data->busy);
+    cb(dev, ret, user_data);
+    return 0;
+}
+
+
+/**
+ * @brief Checks the bus and takes the sensor out of standby if needed.
+ *
+ * A sensor that does not answer yet is not an error: it is reported by
+ * the reads, so a late or hot-plugged sensor can still be used.
+ */
+static int tc74_init(const struct device *dev) {
+    const struct tc74_config *cfg = dev->config;
+    uint8_t cmd = TC74_CMD_RWCR;
+    uint8_t conf;
+
+    if (!i2c_is_ready_dt(&cfg->i2c)) {
+        return -ENODEV;
+    }
+
+    if (i2c_write_read_dt(&cfg->i2c, &cmd, 1, &conf, 1) == 0 && (conf & TC74_CFG_STANDBY)) {
+        uint8_t wr[2] = { TC74_CMD_RWCR, conf & ~TC74_CFG_STANDBY };
+        i2c_write_dt(&cfg->i2c, wr, sizeof(wr));
+    }
+
+    return 0;
+}
+
+
+static const struct sensor_driver_api tc74_api = {
+    .sample_fetch = tc74_sample_fetch,
+    .channel_get = tc74_channel_get,
+};
+
+#define TC74_DEFINE(inst)                                                       \
+    static struct tc74_data tc74_data_##inst;                                  \
+    static const struct tc74_config tc74_config_##inst = {                     \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                                     \
+    };                                                                         \
+    DEVICE_DT_INST_DEFINE(inst, tc74_init, NULL, &tc74_data_##inst,            \
+                          &tc74_config_##inst, POST_KERNEL,                    \
+                          CONFIG_SENSOR_INIT_PRIORITY, &tc74_api);
+
+DT_INST_FOREACH_STATUS_OKAY(TC74_DEFINE)
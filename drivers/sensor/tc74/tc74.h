@@ -0,0 +1,33 @@
+#ifndef TC74_H
+#define TC74_H
+
+#include <zephyr/device.h>
+
+/**
+ * @brief Completion callback of tc74_fetch_async().
+ *
+ * May run in interrupt context.
+ *
+ * @param dev TC74 device whose fetch completed.
+ * @param result 0 on success, negative errno on bus error.
+ * @param user_data Pointer given to tc74_fetch_async().
+ */
+typedef void (*tc74_callback_t)(const struct device *dev, int result, void *user_data);
+
+/**
+ * @brief Start a temperature fetch without blocking.
+ *
+ * On completion the sample is available through sensor_channel_get()
+ * with SENSOR_CHAN_AMBIENT_TEMP, as after sensor_sample_fetch(). If the
+ * bus driver has no callback support, the fetch runs synchronously and
+ * the callback is invoked before returning.
+ *
+ * @param dev TC74 device.
+ * @param cb Completion callback.
+ * @param user_data Pointer passed to the callback.
+ * @return 0 if the fetch was started, -EBUSY if a previous fetch of this
+ *         device is still in flight, other negative errno on bus error.
+ */
+int tc74_fetch_async(const struct device *dev, tc74_callback_t cb, void *user_data);
+
+#endif
@@ -0,0 +1,174 @@
+#define DT_DRV_COMPAT microchip_tc74
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include "plant.h"
+#if defined(CONFIG_PWM_EMUL)
+#include <zephyr/drivers/pwm.h>
+#include "pwm_emul.h"
+#endif
+
+/**
+ * @file tc74_emul.c
+ * @brief I2C emulator of the TC74, driven by a thermal plant model.
+ *
+ * Binds to the "microchip,tc74" nodes on an emulated I2C controller (e.g.
+ * on native_sim) and answers the register pointer writes and reads like
+ * the real part. The temperature comes from a first-order-plus-dead-time
+ * model (plant.c) heated while the emulated fetpin GPIO is high, or with
+ * the duty cycle of the heater-pwm channel when it is an emulated PWM (the
+ * plant averages a PWM much faster than its time constant). A timer
+ * samples the output and advances the model in kernel time, so the model
+ * runs as fast as the simulated clock.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define TC74_CMD_RTR 0x00           /**< Read temperature register */
+#define TC74_CMD_RWCR 0x01          /**< Read/write configuration register */
+#define TC74_CFG_STANDBY BIT(7)     /**< Configuration register standby bit */
+#define TC74_CFG_DATA_READY BIT(6)  /**< Configuration register data ready bit */
+
+#define FET_NODE DT_ALIAS(fetpin)   /**< Heater output the model reacts to */
+#define HEATER_PWM_NODE DT_ALIAS(heater_pwm)  /**< Same output, driven by a PWM */
+
+BUILD_ASSERT(DT_NODE_EXISTS(FET_NODE), "The TC74 emulator needs a fetpin alias");
+
+/** Per-instance emulator state */
+struct tc74_emul_data {
+    struct plant plant;             /**< Thermal model */
+    struct k_spinlock lock;         /**< Protects the model against the step timer */
+    struct k_timer step_timer;      /**< Advances the model */
+    uint8_t pointer;                /**< Register selected by the last write */
+    uint8_t config;                 /**< Configuration register */
+    int8_t temp;                    /**< Temperature register (kept in standby) */
+};
+
+static const struct gpio_dt_spec emul_fet = GPIO_DT_SPEC_GET(FET_NODE, gpios);
+
+#if defined(CONFIG_PWM_EMUL) && DT_NODE_EXISTS(HEATER_PWM_NODE)
+#define TC74_EMUL_PWM 1
+static const struct pwm_dt_spec emul_pwm = PWM_DT_SPEC_GET(HEATER_PWM_NODE);
+#endif
+
+
+/**
+ * @brief Samples the heater output and advances the model by one step.
+ */
+static void tc74_emul_step(struct k_timer *timer) {
+    struct tc74_emul_data *data = CONTAINER_OF(timer, struct tc74_emul_data, step_timer);
+    int on = gpio_emul_output_get(emul_fet.port, emul_fet.pin);
+    uint16_t input = (on > 0) ? 1000 : 0;
+
+#if defined(TC74_EMUL_PWM)
+    uint16_t duty;
+    if (pwm_emul_duty_get(emul_pwm.dev, emul_pwm.channel, &duty) == 0) {
+        input = MAX(input, duty);
+    }
+#endif
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    plant_set_input(&data->plant, input);
+    plant_step(&data->plant, CONFIG_TC74_EMUL_STEP_MS);
+    k_spin_unlock(&data->lock, key);
+}
+
+
+/**
+ * @brief Converts the model temperature to the TC74 register format.
+ */
+static int8_t tc74_emul_temp_reg(struct tc74_emul_data *data) {
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    int32_t mdeg = plant_temp_mdeg(&data->plant);
+    k_spin_unlock(&data->lock, key);
+
+    int32_t deg = (mdeg >= 0) ? (mdeg + 500) / 1000 : (mdeg - 500) / 1000;
+    return (int8_t)CLAMP(deg, -65, 127);
+}
+
+
+/**
+ * @brief Handles one I2C transaction addressed to the emulated TC74.
+ */
+static int tc74_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+                              int addr) {
+    struct tc74_emul_data *data = target->data;
+
+    ARG_UNUSED(addr);
+
+    for (int i = 0; i < num_msgs; i++) {
+        struct i2c_msg *msg = &msgs[i];
+
+        if (msg->len == 0) {
+            return -EIO;
+        }
+
+        if ((msg->flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE) {
+            data->pointer = msg->buf[0];
+            if (msg->len > 1) {
+                if (data->pointer != TC74_CMD_RWCR) {
+                    return -EIO;
+                }
+                data->config = msg->buf[1] & TC74_CFG_STANDBY;
+            }
+            continue;
+        }
+
+        if (!(data->config & TC74_CFG_STANDBY)) {
+            data->temp = tc74_emul_temp_reg(data);
+        }
+        for (uint32_t j = 0; j < msg->len; j++) {
+            msg->buf[j] = (data->pointer == TC74_CMD_RWCR)
+                ? (data->config | ((data->config & TC74_CFG_STANDBY) ? 0 : TC74_CFG_DATA_READY))
+                : (uint8_t)data->temp;
+        }
+    }
+
+    return 0;
+}
+
+
+static const struct i2c_emul_api tc74_emul_api = {
+    .transfer = tc74_emul_transfer,
+};
+
+
+/**
+ * @brief Starts the model at ambient temperature with the heater off.
+ */
+static int tc74_emul_init(const struct emul *target, const struct device *parent) {
+    struct tc74_emul_data *data = target->data;
+    const struct plant_params params = {
+        .ambient_mdeg = CONFIG_TC74_EMUL_AMBIENT_MDEG,
+        .gain_mdeg = CONFIG_TC74_EMUL_GAIN_MDEG,
+        .tau_ms = CONFIG_TC74_EMUL_TAU_MS,
+        .dead_ms = CONFIG_TC74_EMUL_DEAD_MS,
+    };
+
+    ARG_UNUSED(parent);
+
+    plant_init(&data->plant, &params);
+    data->pointer = TC74_CMD_RTR;
+    data->config = 0;
+    data->temp = tc74_emul_temp_reg(data);
+
+    k_timer_init(&data->step_timer, tc74_emul_step, NULL);
+    k_timer_start(&data->step_timer, K_MSEC(CONFIG_TC74_EMUL_STEP_MS),
+                  K_MSEC(CONFIG_TC74_EMUL_STEP_MS));
+    return 0;
+}
+
+
+#define TC74_EMUL(inst)                                                         \
+    static struct tc74_emul_data tc74_emul_data_##inst;                        \
+    EMUL_DT_INST_DEFINE(inst, tc74_emul_init, &tc74_emul_data_##inst, NULL,    \
+                        &tc74_emul_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(TC74_EMUL)
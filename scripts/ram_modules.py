@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Static RAM usage per module, from a GNU ld map file.
+
+Sums the size of every input section placed in the RAM region of the map
+and groups it by object file (application modules) or by library (kernel,
+drivers, libc). Writes a plain-text table, largest users first.
+
+Usage: ram_modules.py <zephyr.map> <output.txt>
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+RAM_REGIONS = ("RAM", "SRAM")
+
+# " .bss.db   0x20000abc   0x4c app/libapp.a(rtdb.c.obj)", possibly split
+# after the section name when it is too long.
+SECTION_RE = re.compile(r"^\s+(\.\S+)?\s*0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+REGION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+
+
+def ram_range(lines):
+    in_config = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            in_config = True
+            continue
+        if in_config and line.startswith("Linker script and memory map"):
+            break
+        m = REGION_RE.match(line) if in_config else None
+        if m and m.group(1) in RAM_REGIONS:
+            start = int(m.group(2), 16)
+            return start, start + int(m.group(3), 16)
+    sys.exit("ram_modules.py: no RAM region in map file")
+
+
+def owner(obj):
+    # "app/libapp.a(rtdb.c.obj)" -> "app: rtdb.c", "zephyr/kernel/libkernel.a(sem.c.obj)" -> "libkernel.a"
+    m = re.match(r"(.*?)([^/]+\.a)\((.+?)(\.obj|\.o)?\)$", obj)
+    if m:
+        if m.group(2) == "libapp.a":
+            return "app: " + m.group(3)
+        return m.group(2)
+    return obj.split("/")[-1]
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    with open(sys.argv[1], encoding="utf-8", errors="replace") as f:
+        lines = f.read().splitlines()
+
+    start, end = ram_range(lines)
+    usage = defaultdict(int)
+    in_map = False
+
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            in_map = True
+            continue
+        if not in_map or line.lstrip().startswith("*"):
+            continue
+        m = SECTION_RE.match(line)
+        if not m:
+            continue
+        addr, size, obj = int(m.group(2), 16), int(m.group(3), 16), m.group(4).strip()
+        if size == 0 or not (start <= addr < end) or obj.startswith("0x"):
+            continue
+        usage[owner(obj)] += size
+
+    total = sum(usage.values())
+    with open(sys.argv[2], "w", encoding="utf-8") as out:
+        out.write("Static RAM per module (bytes)\n")
+        out.write("%-40s %8s\n" % ("module", "bytes"))
+        for name, size in sorted(usage.items(), key=lambda kv: kv[1], reverse=True):
+            out.write("%-40s %8d\n" % (name, size))
+        out.write("%-40s %8d\n" % ("total", total))
+
+
+if __name__ == "__main__":
+    main()
@@ -21,9 +21,17 @@
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
-#include <zephyr/drivers/i2c.h>   /* Required for  I2C */
+#if defined(CONFIG_APP_HEATER_PWM)
+#include <zephyr/drivers/pwm.h>
+#endif
 #include <zephyr/drivers/uart.h>  /* for UART API*/
+#if defined(CONFIG_APP_WATCHDOG)
+#include <zephyr/drivers/watchdog.h>
+#endif
 #include <zephyr/sys/printk.h>
+#if defined(CONFIG_APP_TASK_STATS)
+#include <zephyr/timing/timing.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,22 +39,91 @@
 
 #include "modules/rtdb.h"
 #include "modules/buttons.h"
-#include "modules/PID.h"
+#include "modules/control.h"
 #include "modules/cmdproc.h"
+#include "modules/uartrx.h"
+#include "modules/sched.h"
+#include "modules/taskstats.h"
+#include "modules/health.h"
+#include "modules/sensors.h"
+#include "modules/filter.h"
+#if defined(CONFIG_APP_KALMAN)
+#include <math.h>
+#include "modules/kalman.h"
+#endif
+#if defined(CONFIG_APP_HEATER_TPO)
+#include "modules/tpo.h"
+#endif
+#if !defined(CONFIG_APP_HEATER_PWM)
+#include "modules/governor.h"
+#endif
+#if defined(CONFIG_APP_MEM_REPORT)
+#include "modules/memreport.h"
+#endif
+#if defined(CONFIG_APP_CONTROL_BENCH)
+#include "modules/PID.h"
+#include "modules/mpc.h"
+#endif
 
 #define SUCCESS 0     /**< Operation successful return code */
 #define ERR_FATAL -1  /**< Fatal error return code */
 
 
 
+/* ---------- Task Timing ---------- */
+static volatile uint32_t release_stamp[TASK_COUNT];  /**< Cycle counter value at the last release of each task */
+static volatile uint32_t release_ms[TASK_COUNT];     /**< Uptime (ms) at the last release of each task */
+
+/**
+ * @brief Reads the cycle counter used for task timing.
+ */
+static inline uint32_t stamp_now(void) {
+#if defined(CONFIG_APP_TASK_STATS)
+    return (uint32_t)timing_counter_get();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Marks the release of a job of a task.
+ */
+static inline void task_released(enum task_id task) {
+    release_stamp[task] = stamp_now();
+    release_ms[task] = k_uptime_get_32();
+}
+
+/**
+ * @brief Records the timing of a finished job of a task, checks its
+ * deadline and checks the task in with the supervisor.
+ *
+ * @param task Task identifier.
+ * @param start Cycle counter value when the job started executing.
+ */
+static inline void task_finished(enum task_id task, uint32_t start) {
+#if defined(CONFIG_APP_TASK_STATS)
+    taskstats_record_job(task, release_stamp[task], start, stamp_now());
+#endif
+    uint32_t now = k_uptime_get_32();
+    health_job_done(task, now - release_ms[task], now);
+}
+
+/**
+ * @brief Timer expiry function: marks the release of the task the timer belongs to.
+ */
+static void timer_released(struct k_timer *timer) {
+    task_released((enum task_id)(uintptr_t)k_timer_user_data_get(timer));
+}
+
+
 /* ---------- LED Configuration ---------- */
 #define LED0_NODE DT_ALIAS(led0)  /**< Devicetree alias for LED0 */
 #define LED1_NODE DT_ALIAS(led1)  /**< Devicetree alias for LED1 */
 #define LED2_NODE DT_ALIAS(led2)  /**< Devicetree alias for LED2 */
 #define LED3_NODE DT_ALIAS(led3)  /**< Devicetree alias for LED3 */
 
-#define led_thread_period 500  /**< LED update period in milliseconds */
-K_TIMER_DEFINE(led_thread_timer, NULL, NULL);  /**< Timer for LED thread */
+#define led_thread_period CONFIG_APP_LED_PERIOD_MS  /**< Default LED update period in milliseconds */
+K_TIMER_DEFINE(led_thread_timer, timer_released, NULL);  /**< Timer for LED thread */
 
 static const struct gpio_dt_spec led0 = GPIO_DT_SPEC_GET(LED0_NODE, gpios);  /**< LED0 GPIO specification */
 static const struct gpio_dt_spec led1 = GPIO_DT_SPEC_GET(LED1_NODE, gpios);  /**< LED1 GPIO specification */
@@ -55,28 +132,46 @@ static const struct gpio_dt_spec led3 = GPIO_DT_SPEC_GET(LED3_NODE, gpios);  /**
 
 
 /* ---------- Temperature Sensor Configuration ---------- */
-#define TC74_CMD_RTR 0x00   /**< Read temperature command */
-#define TC74_CMD_RWCR 0x01  /**< Read/write configuration register */
+/* The TC74 sensors are the "microchip,tc74" devicetree nodes (see sensors.c) */
+#define temp_read_thread_period CONFIG_APP_SAMPLE_PERIOD_MS  /**< Default control period in milliseconds */
+K_TIMER_DEFINE(temp_read_thread_timer, timer_released, NULL);  /**< Timer for temperature reading thread */
+
+#if defined(CONFIG_APP_FILTER_MOVING_AVG)
+#define TEMP_FILTER FILTER_MOVING_AVG
+#elif defined(CONFIG_APP_FILTER_MEDIAN)
+#define TEMP_FILTER FILTER_MEDIAN
+#elif defined(CONFIG_APP_FILTER_IIR)
+#define TEMP_FILTER FILTER_IIR
+#else
+#define TEMP_FILTER FILTER_NONE
+#endif
 
-#define I2C0_NID DT_NODELABEL(tc74sensor)  /**< Devicetree node identifier for TC74 sensor */
-static const struct i2c_dt_spec dev_i2c = I2C_DT_SPEC_GET(I2C0_NID);  /**< I2C device specification */
-
-#define temp_read_thread_period 250  /**< Temperature reading period in milliseconds */
-K_TIMER_DEFINE(temp_read_thread_timer, NULL, NULL);  /**< Timer for temperature reading thread */
+/**
+ * @brief Period of the sensor reads for a given control period.
+ *
+ * The sensors are read CONFIG_APP_OVERSAMPLE times per control period.
+ */
+static uint32_t read_period(uint32_t control_period) {
+    return MAX(control_period / CONFIG_APP_OVERSAMPLE, 1u);
+}
 
 
 /* ---------- Heater Control Configuration ---------- */
 #define FET_NODE DT_ALIAS(fetpin)  /**< Devicetree alias for FET control pin */
 static const struct gpio_dt_spec fet = GPIO_DT_SPEC_GET(FET_NODE, gpios);  /**< FET GPIO specification */
+#if defined(CONFIG_APP_HEATER_PWM)
+static const struct pwm_dt_spec heater_pwm = PWM_DT_SPEC_GET(DT_ALIAS(heater_pwm));  /**< PWM channel on the FET */
+#endif
 
 
 /* ---------- UART Configuration ---------- */
 #define UART_NODE DT_NODELABEL(uart0)  /**< Devicetree node identifier for UART0 */
 
-#define RXBUF_SIZE 60      /**< UART receive buffer size */
 #define TXBUF_SIZE 60      /**< UART transmit buffer size */
-#define MSG_BUF_SIZE 100   /**< Complete message buffer size */
+#define MSG_BUF_SIZE (UART_TX_SIZE + 16)   /**< Complete message buffer size ("Response: " + frame) */
 #define RX_TIMEOUT 1000    /**< UART receive timeout in microseconds */
+#define TX_TIMEOUT_MS 100  /**< Maximum time to wait for a response to be transmitted, in milliseconds */
+#define UART_POLL_MS 10    /**< Receive polling period without the async API, in milliseconds */
 
 /** UART configuration structure */
 const struct uart_config uart_cfg = {
@@ -88,18 +183,55 @@ const struct uart_config uart_cfg = {
 };
 
 const struct device *uart_dev = DEVICE_DT_GET(UART_NODE);  /**< UART device instance */
-static uint8_t rx_buf[RXBUF_SIZE];      /**< UART receive buffer */
-static uint8_t rx_chars[RXBUF_SIZE];    /**< Buffer for received characters */
-volatile int uart_rxbuf_nchar = 0;      /**< Number of characters in receive buffer */
+static struct uartrx uart_rx;          /**< UART receive buffers and frame assembler */
 
 /*  - Callback Setup  */
+#if defined(CONFIG_UART_ASYNC_API)
 static void uart_cb(const struct device *dev, struct uart_event *evt, void *user_data);
+#else
+static void uart_poll_rx(struct k_timer *timer);
+K_TIMER_DEFINE(uart_poll_timer, uart_poll_rx, NULL);  /**< Polls the UART for received characters */
+#endif
+
+/*  - Scheduling Setup  */
+static void schedule_apply(void);
 
 
 /* ---------- Semaphores ---------- */
+#if !defined(CONFIG_APP_FUSED_PIPELINE)
 struct k_sem sensor_to_controller_sem = Z_SEM_INITIALIZER(sensor_to_controller_sem, 0, 1); /**< For executing the PID controller on the new value after a sensor read  */
 struct k_sem controller_to_heater_sem = Z_SEM_INITIALIZER(controller_to_heater_sem, 0, 1); /**< For executing the heat control based on the on/off value from the PID  */
+#endif
 struct k_sem uart_full_message_sem = Z_SEM_INITIALIZER(uart_full_message_sem, 0, 1); /**< For executing the command processor when a complete message is received  */
+struct k_sem uart_tx_done_sem = Z_SEM_INITIALIZER(uart_tx_done_sem, 0, 1); /**< For waiting until a response has been transmitted  */
+
+
+/**
+ * @brief Restarts a periodic timer if the task period was changed in the RTDB.
+ *
+ * @param timer Timer releasing the task.
+ * @param task Task identifier used to look up the period.
+ * @param period Pointer to the period the timer is currently running with (ms).
+ */
+static void timer_follow_period(struct k_timer *timer, enum task_id task, uint32_t *period) {
+    uint32_t new_period = rtdb_get_task_period(task);
+
+    if (new_period != 0 && new_period != *period) {
+        *period = new_period;
+        uint32_t run_period = (task == TASK_SENSOR) ? read_period(*period) : *period;
+        k_timer_start(timer, K_MSEC(run_period), K_MSEC(run_period));
+
+        //  Deadlines follow the period the task actually runs with
+        uint32_t now = k_uptime_get_32();
+        health_set_deadline(task, run_period, now);
+#if !defined(CONFIG_APP_FUSED_PIPELINE)
+        if (task == TASK_SENSOR) {
+            health_set_deadline(TASK_PID, *period, now);
+            health_set_deadline(TASK_HEATER, *period, now);
+        }
+#endif
+    }
+}
 
 
 
@@ -113,11 +245,18 @@ struct k_sem uart_full_message_sem = Z_SEM_INITIALIZER(uart_full_message_sem, 0,
  * - LED3: Temperature above desired range
  */
 void led_update_task(void) {
-    k_timer_start(&led_thread_timer, K_MSEC(led_thread_period), K_MSEC(led_thread_period));
+    uint32_t period = led_thread_period;
+    k_timer_user_data_set(&led_thread_timer, (void *)TASK_LED);
+    k_timer_start(&led_thread_timer, K_MSEC(period), K_MSEC(period));
 
     while (1) {
         /*  Wait for timer event  */
-        k_timer_status_sync(&led_thread_timer);
+        uint32_t expiries = k_timer_status_sync(&led_thread_timer);
+        uint32_t start = stamp_now();
+        if (expiries > 1) {
+            health_add_misses(TASK_LED, expiries - 1);
+        }
+        timer_follow_period(&led_thread_timer, TASK_LED, &period);
 
         bool on = rtdb_get_system_on();
         int desired = rtdb_get_desired_temp();
@@ -135,59 +274,631 @@ void led_update_task(void) {
             gpio_pin_set_dt(&led2, (diff < -2) ? 1 : 0);
             gpio_pin_set_dt(&led3, (diff > 2) ? 1 : 0);
         }
+
+        task_finished(TASK_LED, start);
     }
 }
-K_THREAD_DEFINE(led_task_id, 1024, led_update_task, NULL, NULL, NULL, 5, 0, 0);
+K_THREAD_DEFINE(led_task_id, CONFIG_APP_LED_STACK_SIZE, led_update_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
+
+
+/* ---------- Control Pipeline ---------- */
+static struct filter temp_filter;      /**< Filter between the sensor reads and the RTDB */
+static int32_t temp_mdeg = 0;          /**< Last filtered temperature (m°C) */
+static uint32_t sample_cycles = 0;     /**< Cycle counter value when the last sample was read */
+
+#if defined(CONFIG_APP_KALMAN)
+static struct kalman temp_kalman;      /**< Temperature estimate the controller acts on */
+static uint32_t kalman_steps = 0;      /**< Estimator steps, one per sensor task job */
+static const struct plant_estimate kalman_model = {  /**< Estimator model until the identification is valid */
+    .gain_c = CONFIG_APP_KALMAN_MODEL_GAIN_C,
+    .tau_s = CONFIG_APP_KALMAN_MODEL_TAU_S,
+    .dead_s = CONFIG_APP_KALMAN_MODEL_DEAD_MS / 1000.0f,
+};
+#endif
+
+#if defined(CONFIG_APP_HEATER_ONOFF)
+#define heater_full_scale 0            /**< On/off control */
+#else
+#define heater_full_scale CONFIG_APP_HEATER_FULL_SCALE  /**< PID output for 100 % heater duty */
+#endif
+
+#if defined(CONFIG_APP_CONTROLLER_ONOFF)
+#define boot_controller CONTROLLER_ONOFF
+#elif defined(CONFIG_APP_CONTROLLER_PI)
+#define boot_controller CONTROLLER_PI
+#elif defined(CONFIG_APP_CONTROLLER_PID_2DOF)
+#define boot_controller CONTROLLER_PID_2DOF
+#elif defined(CONFIG_APP_CONTROLLER_MPC)
+#define boot_controller CONTROLLER_MPC
+#else
+#define boot_controller CONTROLLER_PID     /**< Control strategy at boot (CONFIG_APP_CONTROLLER) */
+#endif
+
+static struct control ctrl = {         /**< State of the control law */
+    .full_scale = heater_full_scale,
+    .hysteresis = CONFIG_APP_CONTROL_HYSTERESIS_MDEG / 1000.0f,
+    .beta = CONFIG_APP_CONTROL_SETPOINT_WEIGHT / 100.0f,
+    .mpc_model = {
+        .gain_c = CONFIG_APP_MPC_MODEL_GAIN_C,
+        .tau_s = CONFIG_APP_MPC_MODEL_TAU_S,
+        .dead_s = CONFIG_APP_MPC_MODEL_DEAD_MS / 1000.0f,
+    },
+    .move_weight = CONFIG_APP_MPC_MOVE_WEIGHT,
+    .tune_cfg = {
+        .hysteresis = CONFIG_APP_AUTOTUNE_HYSTERESIS_MDEG / 1000.0f,
+        .cycles = CONFIG_APP_AUTOTUNE_CYCLES,
+        .timeout_s = CONFIG_APP_AUTOTUNE_TIMEOUT_S,
+    },
+    .ident_period_s = CONFIG_APP_IDENT_PERIOD_MS / 1000.0f,
+    .ident_memory_s = CONFIG_APP_IDENT_MEMORY_S,
+    .use_estimate = IS_ENABLED(CONFIG_APP_KALMAN),
+};
 
+static volatile uint16_t heater_duty = 0;  /**< Duty currently requested from the heater output (‰) */
+
+static struct governor fet_gov;        /**< Switching limits of the FET */
+static struct k_spinlock fet_lock;     /**< Serializes the FET between threads and timers */
+
+#if defined(CONFIG_APP_HEATER_PWM)
+static uint16_t heater_pulse = 0;      /**< Duty currently set on the PWM channel (‰) */
 
 /**
- * @brief Temperature reading task
+ * @brief Sets the PWM duty, if it changed. Called with fet_lock held.
  *
- * This thread periodically reads the temperature from the TC74 sensor
- * and updates the RTDB with the current temperature value.
+ * @param duty Duty cycle in ‰.
+ */
+static void pwm_set_duty(uint16_t duty) {
+    if (duty != heater_pulse) {
+        pwm_set_pulse_dt(&heater_pwm, (uint32_t)((uint64_t)heater_pwm.period * duty / 1000U));
+        heater_pulse = duty;
+    }
+}
+#else
+static bool fet_state = false;         /**< Current state of the FET */
+
+/**
+ * @brief Drives the FET pin, if its state changed. Called with fet_lock held.
+ *
+ * @param on FET state.
+ */
+static void fet_set(bool on) {
+    if (on != fet_state) {
+        gpio_pin_set_dt(&fet, on);
+        fet_state = on;
+    }
+}
+#endif
+
+#if !defined(CONFIG_APP_HEATER_PWM) && !defined(CONFIG_APP_HEATER_TPO)
+/**
+ * @brief Requests a FET state through the switching governor.
+ *
+ * The FET only switches if the minimum on/off time and the switching rate
+ * allow it; otherwise the request is held back and must be repeated.
+ *
+ * @param on Requested state.
+ */
+static void fet_request(bool on) {
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+
+    fet_set(governor_request(&fet_gov, on, k_uptime_get_32()));
+    k_spin_unlock(&fet_lock, key);
+}
+#endif
+
+/**
+ * @brief Switches the FET off at once, bypassing the governor (fail safe).
+ */
+static void fet_force_off(void) {
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+
+    governor_force_off(&fet_gov, k_uptime_get_32());
+#if defined(CONFIG_APP_HEATER_PWM)
+    pwm_set_duty(0);
+#else
+    fet_set(false);
+#endif
+    k_spin_unlock(&fet_lock, key);
+}
+
+#if defined(CONFIG_APP_HEATER_TPO)
+#define heater_slot_ms (CONFIG_APP_HEATER_WINDOW_MS / CONFIG_APP_HEATER_SLOTS)  /**< Time-proportional slot length */
+BUILD_ASSERT(heater_slot_ms > 0, "CONFIG_APP_HEATER_WINDOW_MS must be at least CONFIG_APP_HEATER_SLOTS");
+
+static struct tpo heater_tpo;          /**< Time-proportional output driving the FET */
+
+/**
+ * @brief Heater slot timer expiry function.
+ *
+ * Starts the next slot of the time-proportional window. The governor has
+ * already quantised the duty of the window, so the slot state goes
+ * straight to the FET.
+ */
+static void heater_slot(struct k_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+
+    fet_set(tpo_tick(&heater_tpo));
+    k_spin_unlock(&fet_lock, key);
+}
+K_TIMER_DEFINE(heater_slot_timer, heater_slot, NULL);  /**< Timer for the heater output slots */
+#endif
+
+/**
+ * @brief Applies a duty cycle to the heater output.
+ *
+ * With the hardware PWM the governor quantises the duty and the new pulse
+ * width starts at the next PWM period, with the CPU doing nothing in
+ * between. The time-proportional output gets the quantised duty at the
+ * next slot. The on/off output requests the FET state from the governor
+ * at once.
+ *
+ * @param duty Heater power in ‰.
+ */
+static void heater_apply(uint16_t duty) {
+#if defined(CONFIG_APP_HEATER_PWM)
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+
+    pwm_set_duty(governor_duty(&fet_gov, duty, heater_pwm.period / NSEC_PER_MSEC, k_uptime_get_32()));
+    k_spin_unlock(&fet_lock, key);
+#elif defined(CONFIG_APP_HEATER_TPO)
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+
+    tpo_set_duty(&heater_tpo, governor_duty(&fet_gov, duty, CONFIG_APP_HEATER_WINDOW_MS, k_uptime_get_32()));
+    k_spin_unlock(&fet_lock, key);
+#else
+    fet_request(duty > 0);
+#endif
+    heater_duty = duty;
+}
+
+/**
+ * @brief Sets up the heater output, off.
  *
  * @return int SUCCESS on success, ERR_FATAL on failure
  */
-int read_temperature_task(void) {
-    int ret = 0;
-    uint8_t temp = 0; 
+static int heater_init(void) {
+    const struct governor_config gov_cfg = {
+        .min_on_ms = CONFIG_APP_HEATER_MIN_ON_MS,
+        .min_off_ms = CONFIG_APP_HEATER_MIN_OFF_MS,
+        .max_per_min = CONFIG_APP_HEATER_MAX_SWITCHES_PER_MIN,
+    };
+
+#if defined(CONFIG_APP_HEATER_PWM)
+    if (!pwm_is_ready_dt(&heater_pwm)) {
+        printk("Heater PWM device %s is not ready!\n\r", heater_pwm.dev->name);
+        return ERR_FATAL;
+    }
+    pwm_set_pulse_dt(&heater_pwm, 0);
+#else
+    gpio_pin_configure_dt(&fet, GPIO_OUTPUT_INACTIVE);
+#endif
+    governor_init(&fet_gov, &gov_cfg, k_uptime_get_32());
+#if defined(CONFIG_APP_HEATER_TPO)
+    tpo_init(&heater_tpo, CONFIG_APP_HEATER_SLOTS);
+    k_timer_start(&heater_slot_timer, K_MSEC(heater_slot_ms), K_MSEC(heater_slot_ms));
+#endif
+    heater_apply(0);
 
-    k_timer_start(&temp_read_thread_timer, K_MSEC(temp_read_thread_period), K_MSEC(temp_read_thread_period));
-    
-    if (!device_is_ready(dev_i2c.bus)) {
-	    printk("I2C bus %s is not ready!\n\r",dev_i2c.bus->name);
-	    return ERR_FATAL;
+    return SUCCESS;
+}
+
+
+/* ---------- Supervision ---------- */
+#if defined(CONFIG_APP_WATCHDOG)
+static const struct device *const wdt_dev = DEVICE_DT_GET(DT_ALIAS(watchdog0));  /**< Hardware watchdog */
+static int wdt_channel = -1;  /**< Watchdog timeout channel */
+#endif
+
+static volatile bool heater_failsafe = false;  /**< Set while the supervisor holds the heater off */
+
+/**
+ * @brief Supervisor timer expiry function.
+ *
+ * Feeds the hardware watchdog only while every monitored task keeps checking
+ * in. As soon as one stalls (e.g. a stuck I2C read or UART transmission),
+ * the heater is forced off and the watchdog is left to expire. The heater
+ * is held off, every tick, until every task has checked in again, which
+ * only happens without a hardware watchdog (or before it bites).
+ */
+static void supervisor_tick(struct k_timer *timer) {
+    if (!health_all_alive(k_uptime_get_32())) {
+        heater_apply(0);
+        //  Neither the next slot nor the minimum on time is waited for
+        fet_force_off();
+        heater_failsafe = true;
+        return;
+    }
+    heater_failsafe = false;
+
+#if defined(CONFIG_APP_WATCHDOG)
+    if (wdt_channel >= 0) {
+        wdt_feed(wdt_dev, wdt_channel);
     }
+#endif
+}
+K_TIMER_DEFINE(supervisor_timer, supervisor_tick, NULL);  /**< Timer for the supervisor */
 
-    /* Write (command RTR) to set the read address to temperature */
-    ret = i2c_write_dt(&dev_i2c, TC74_CMD_RTR, 1);
 
-    while (1) {
-        /*  Wait for timer event  */
-        k_timer_status_sync(&temp_read_thread_timer);
+/**
+ * @brief Registers the task deadlines and starts the supervisor and the hardware watchdog.
+ *
+ * @return int SUCCESS on success, ERR_FATAL on failure
+ */
+static int supervisor_init(void) {
+    uint32_t now = k_uptime_get_32();
+
+    health_init();
+    health_set_deadline(TASK_LED, rtdb_get_task_period(TASK_LED), now);
+    health_set_deadline(TASK_SENSOR, read_period(rtdb_get_task_period(TASK_SENSOR)), now);
+#if !defined(CONFIG_APP_FUSED_PIPELINE)
+    health_set_deadline(TASK_PID, rtdb_get_task_period(TASK_SENSOR), now);
+    health_set_deadline(TASK_HEATER, rtdb_get_task_period(TASK_SENSOR), now);
+#endif
+    health_set_deadline(TASK_UART, rtdb_get_task_period(TASK_UART), now);
+
+#if defined(CONFIG_APP_WATCHDOG)
+    struct wdt_timeout_cfg wdt_cfg = {
+        .window.min = 0,
+        .window.max = CONFIG_APP_WDT_TIMEOUT_MS,
+        .callback = NULL,
+        .flags = WDT_FLAG_RESET_SOC,
+    };
+
+    if (!device_is_ready(wdt_dev)) {
+        printk("Watchdog device %s is not ready!\n\r", wdt_dev->name);
+        return ERR_FATAL;
+    }
+
+    wdt_channel = wdt_install_timeout(wdt_dev, &wdt_cfg);
+    if (wdt_channel < 0) {
+        printk("wdt_install_timeout() error. Error code:%d\n\r", wdt_channel);
+        return ERR_FATAL;
+    }
+
+    int err = wdt_setup(wdt_dev, WDT_OPT_PAUSE_HALTED_BY_DBG);
+    if (err) {
+        printk("wdt_setup() error. Error code:%d\n\r", err);
+        return ERR_FATAL;
+    }
+#endif
+
+    k_timer_start(&supervisor_timer, K_MSEC(CONFIG_APP_SUPERVISOR_PERIOD_MS), K_MSEC(CONFIG_APP_SUPERVISOR_PERIOD_MS));
+
+    return SUCCESS;
+}
+
+
+static struct rtdb_sensor_status sensor_status;  /**< Sensor bus counters published to the RTDB */
+
+/**
+ * @brief Prepares the TC74 sensors for periodic reads.
+ *
+ * @return int SUCCESS on success, ERR_FATAL on failure
+ */
+static int sensor_init(void) {
+    int n = sensors_init();
+    if (n < 0) {
+        return ERR_FATAL;
+    }
 
-        /* Read temperature register */       
-        ret = i2c_read_dt(&dev_i2c, &temp, sizeof(temp));
+    int len = 1, shift = 0;
+#if defined(CONFIG_APP_FILTER_LENGTH)
+    len = CONFIG_APP_FILTER_LENGTH;
+#endif
+#if defined(CONFIG_APP_FILTER_IIR_SHIFT)
+    shift = CONFIG_APP_FILTER_IIR_SHIFT;
+#endif
+    filter_init(&temp_filter, TEMP_FILTER, len, shift);
+#if defined(CONFIG_APP_KALMAN)
+    kalman_init(&temp_kalman, KALMAN_R_WHOLE_DEGREE, KALMAN_Q_TEMP, KALMAN_Q_OFFSET);
+#endif
+
+    printk("%d TC74 sensor(s) found\n\r", n);
+    return SUCCESS;
+}
+
+
+/**
+ * @brief Prints a value in thousandths (e.g. a temperature in m°C) with three decimals.
+ */
+static void print_mdeg(int32_t mdeg) {
+    uint32_t mag = (mdeg < 0) ? -mdeg : mdeg;
+    printk("%s%u.%03u", (mdeg < 0) ? "-" : "", mag / 1000, mag % 1000);
+}
 
-        rtdb_set_current_temp((int8_t)temp);
 
+#if defined(CONFIG_APP_KALMAN)
+/**
+ * @brief Advances the temperature estimate by one sensor task job, with
+ * the heater duty applied during the job and the identified plant model,
+ * or the Kconfig one until the identification is valid.
+ */
+static void kalman_predict_stage(void) {
+    struct plant_estimate est;
+    float dt = read_period(rtdb_get_task_period(TASK_SENSOR)) / 1000.0f;
+
+    rtdb_get_plant_estimate(&est);
+    kalman_set_model(&temp_kalman, est.valid ? &est : &kalman_model);
+    kalman_predict(&temp_kalman, control_heater_duty() / 1000.0f, dt);
+    rtdb_set_estimated_temp_mdeg((int32_t)lroundf(temp_kalman.temp * 1000.0f));
+}
+#endif
+
+
+/**
+ * @brief Sensor stage: reads every TC74, filters and updates the RTDB.
+ *
+ * The raw value is the mean of the sensors read successfully, in m°C, so
+ * the filter output keeps sub-degree precision. If no sensor answered,
+ * the last temperature is kept and the sensor is marked as faulty, which
+ * makes the controller switch the heater off. With the Kalman estimator,
+ * every job predicts the temperature, and only every
+ * CONFIG_APP_KALMAN_READ_DIVIDER-th job reads the sensors and corrects the
+ * prediction with their mean.
+ */
+static void sensor_stage(void) {
+#if defined(CONFIG_APP_KALMAN)
+    kalman_predict_stage();
+    if (kalman_steps++ % CONFIG_APP_KALMAN_READ_DIVIDER != 0) {
+        return;
+    }
+#endif
+
+    bool was_ok = sensor_status.ok;
+    int valid = sensors_sample(&sensor_status);
+    sample_cycles = k_cycle_get_32();
+
+    sensor_status.ok = (valid > 0);
+    rtdb_set_sensor_status(&sensor_status);
+
+    if (valid == 0) {
+        if (was_ok || rtdb_get_verbose()) {
+            printk("Temperature read failed, heater disabled\n\r");
+        }
+        return;
+    }
+
+    int32_t sum = 0;
+    for (int i = 0; i < sensors_count(); i++) {
+        int t;
+        if (sensors_get_temp(i, &t)) {
+            sum += t * 1000;
+        }
+    }
+    int32_t raw_mdeg = (sum >= 0) ? (sum + valid / 2) / valid : (sum - valid / 2) / valid;
+
+    temp_mdeg = filter_update(&temp_filter, raw_mdeg);
+    rtdb_set_current_temp_mdeg(temp_mdeg);
+#if defined(CONFIG_APP_KALMAN)
+    kalman_correct(&temp_kalman, raw_mdeg / 1000.0f);
+    rtdb_set_estimated_temp_mdeg((int32_t)lroundf(temp_kalman.temp * 1000.0f));
+#endif
+
+    if (rtdb_get_verbose()) {
         uint64_t time_ms = k_uptime_get();
         uint32_t time_s = time_ms / 1000;
         uint32_t time_ms_remainder = time_ms % 1000;
 
-        bool verboseMode = rtdb_get_verbose();
+        printk("Read temperature: ");
+        print_mdeg(raw_mdeg);
+        printk(" (filtered ");
+        print_mdeg(temp_mdeg);
+#if defined(CONFIG_APP_KALMAN)
+        printk(", estimated ");
+        print_mdeg(rtdb_get_estimated_temp_mdeg());
+#endif
+        printk(") at time %u.%03u s\n\r", time_s, time_ms_remainder);
+        if (sensors_count() > 1) {
+            for (int i = 0; i < sensors_count(); i++) {
+                int t;
+                if (sensors_get_temp(i, &t)) {
+                    printk("  %s: %d\n\r", sensors_name(i), t);
+                } else {
+                    printk("  %s: --\n\r", sensors_name(i));
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Controller stage: advances the setpoint profile on the kernel
+ * clock, runs the selected control strategy on the latest sample and
+ * stores the resulting heater decision in the RTDB.
+ */
+static void controller_stage(void) {
+    const float dt = rtdb_get_task_period(TASK_SENSOR) / 1000.0f;
+
+    static uint8_t tune_state = AUTOTUNE_IDLE;
+    static uint8_t profile_state = PROFILE_IDLE;
+
+    control_profile(&ctrl, k_uptime_get_32());
+    if (ctrl.profile.status.state != profile_state) {
+        profile_state = ctrl.profile.status.state;
+        if (profile_state == PROFILE_DONE) {
+            printk("Profile done, holding ");
+            print_mdeg(rtdb_get_desired_temp_mdeg());
+            printk("°C\n\r");
+        }
+    }
+
+    // Controller on the RTDB temperatures; the heater decision goes back to the RTDB
+    if (control_step(&ctrl, dt) != 0) {
+        return;
+    }
+
+    if (ctrl.tune.status.state != tune_state) {
+        tune_state = ctrl.tune.status.state;
+        if (tune_state == AUTOTUNE_DONE) {
+            const char *names[] = { "Ku", "Tu", "Kp", "Ki", "Kd" };
+            const float values[] = { ctrl.tune.status.ku, ctrl.tune.status.tu, ctrl.tune.status.kp,
+                                     ctrl.tune.status.ki, ctrl.tune.status.kd };
+
+            printk("Autotune done:");
+            for (int k = 0; k < 5; k++) {
+                printk(" %s=", names[k]);
+                print_mdeg((int32_t)(values[k] * 1000.0f));
+            }
+            printk("\n\r");
+        } else if (tune_state == AUTOTUNE_FAILED) {
+            printk("Autotune failed: no oscillation measured, gains unchanged\n\r");
+        }
+    }
+
+    if (rtdb_get_verbose()) {
+        printk("%s decided heater state: %s (Current: ", ctrl.ops->name, (ctrl.output > 0.0f) ? "ON" : "OFF");
+        print_mdeg(rtdb_get_current_temp_mdeg());
+        printk("°C, Desired: ");
+        print_mdeg(rtdb_get_desired_temp_mdeg());
+        printk("°C)\n\r");
+    }
+}
+
+
+/**
+ * @brief Heater stage: applies the RTDB heater duty to the heater output
+ * and records the sample-to-actuation latency. Does nothing while the
+ * supervisor holds the heater off.
+ */
+static void heater_stage(void) {
+    static bool failsafe_reported = false;
+    bool verboseMode = rtdb_get_verbose();
+
+    if (heater_failsafe) {
+        //  The supervisor holds the heater off until every task checks in again
+        if (!failsafe_reported) {
+            failsafe_reported = true;
+            printk("Supervisor: a task stalled, heater forced off\n\r");
+        }
+        return;
+    }
+    if (failsafe_reported) {
+        failsafe_reported = false;
+        printk("Supervisor: every task checked in again, heater released\n\r");
+    }
+
+    // Only heat if system is on
+    uint16_t duty = control_heater_duty();
+    bool changed = (duty != heater_duty);
+    struct governor_stats stats;
+
+    if (!rtdb_get_system_on() || !rtdb_get_sensor_ok()) {
+        //  Safety transitions are not held back by the governor
+        fet_force_off();
+    }
+    //  Every period, so that a request held back by the governor is retried and the pulses are counted
+    heater_apply(duty);
+
+    k_spinlock_key_t key = k_spin_lock(&fet_lock);
+    stats = fet_gov.stats;
+    k_spin_unlock(&fet_lock, key);
+    rtdb_set_switch_stats(&stats);
+
+    if (changed && verboseMode) {
+        printk("Heater duty: %u.%u%%\n\r", duty / 10, duty % 10);
+    }
+
+    uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - sample_cycles);
+    rtdb_add_latency(latency_us);
+
+    if (verboseMode) {
+        printk("Sample-to-actuation latency: %u us\n\r", latency_us);
+    }
+}
+
+
+#if defined(CONFIG_APP_FUSED_PIPELINE)
+
+/**
+ * @brief Fused control pipeline task.
+ *
+ * This thread periodically runs the sensor, PID and heater stages
+ * back-to-back, without any intermediate hand-off between threads.
+ *
+ * @return int SUCCESS on success, ERR_FATAL on failure
+ */
+int control_pipeline_task(void) {
+    uint32_t period = temp_read_thread_period;
+    uint32_t reads = 0;
+    k_timer_user_data_set(&temp_read_thread_timer, (void *)TASK_SENSOR);
+    k_timer_start(&temp_read_thread_timer, K_MSEC(read_period(period)), K_MSEC(read_period(period)));
+
+    if (sensor_init() != SUCCESS) {
+        return ERR_FATAL;
+    }
+
+    while (1) {
+        /*  Wait for timer event  */
+        uint32_t expiries = k_timer_status_sync(&temp_read_thread_timer);
+        uint32_t start = stamp_now();
+        if (expiries > 1) {
+            health_add_misses(TASK_SENSOR, expiries - 1);
+        }
+        timer_follow_period(&temp_read_thread_timer, TASK_SENSOR, &period);
+
+        sensor_stage();
 
-        if (verboseMode) {
-            printk("Read temperature: %d at time %u.%03u s\n\r", temp, time_s, time_ms_remainder);
+        //  Control once every CONFIG_APP_OVERSAMPLE reads
+        if (++reads >= CONFIG_APP_OVERSAMPLE) {
+            reads = 0;
+            controller_stage();
+            heater_stage();
         }
 
+        task_finished(TASK_SENSOR, start);
+    }
+
+    return SUCCESS;
+}
+K_THREAD_DEFINE(pipeline_task_id, CONFIG_APP_PIPELINE_STACK_SIZE, control_pipeline_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
+
+#else
+
+/**
+ * @brief Temperature reading task
+ *
+ * This thread periodically reads the temperature from the TC74 sensor
+ * and updates the RTDB with the current temperature value.
+ *
+ * @return int SUCCESS on success, ERR_FATAL on failure
+ */
+int read_temperature_task(void) {
+    uint32_t period = temp_read_thread_period;
+    uint32_t reads = 0;
+    k_timer_user_data_set(&temp_read_thread_timer, (void *)TASK_SENSOR);
+    k_timer_start(&temp_read_thread_timer, K_MSEC(read_period(period)), K_MSEC(read_period(period)));
+    
+    if (sensor_init() != SUCCESS) {
+        return ERR_FATAL;
+    }
+
+    while (1) {
+        /*  Wait for timer event  */
+        uint32_t expiries = k_timer_status_sync(&temp_read_thread_timer);
+        uint32_t start = stamp_now();
+        if (expiries > 1) {
+            health_add_misses(TASK_SENSOR, expiries - 1);
+        }
+        timer_follow_period(&temp_read_thread_timer, TASK_SENSOR, &period);
+
+        sensor_stage();
+        task_finished(TASK_SENSOR, start);
+
+        //  Control once every CONFIG_APP_OVERSAMPLE reads
+        if (++reads < CONFIG_APP_OVERSAMPLE) {
+            continue;
+        }
+        reads = 0;
+
         //  Tell the PID controller to start working with this new value
+        task_released(TASK_PID);
         k_sem_give(&sensor_to_controller_sem);
     }
     
     return SUCCESS;
 }
-K_THREAD_DEFINE(temp_read_task_id, 1024, read_temperature_task, NULL, NULL, NULL, 5, 0, 0);
+K_THREAD_DEFINE(temp_read_task_id, CONFIG_APP_SENSOR_STACK_SIZE, read_temperature_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
 
 
 /**
@@ -199,37 +910,20 @@ K_THREAD_DEFINE(temp_read_task_id, 1024, read_temperature_task, NULL, NULL, NULL
  * rtdb.
  */
 void pid_controller_task(void) {
-    // Initialize PID
-    float integral = 0.0f;
-    float last_error = 0.0f;
-    
-    const float dt = 0.25f; // time period is similar to the thread cycle of read_temperature_task BUT NOT EQUAL
-
     while (1) {
         // Wait for new sensor value
         k_sem_take(&sensor_to_controller_sem, K_FOREVER);
+        uint32_t start = stamp_now();
 
-        // Read current and desired temperatures from RTDB
-        float current_temp = (float)rtdb_get_current_temp();
-        float desired_temp = (float)rtdb_get_desired_temp();
-
-        float output = pid_calculate(desired_temp, current_temp, dt, &last_error, &integral);
-
-        // Conversion
-        rtdb_set_heat_on((output > 0.0f) && rtdb_get_system_on());
-
-        bool verboseMode = rtdb_get_verbose();
-
-        if (verboseMode) {
-            printk("PID decided heater state: %s (Current: %d°C, Desired: %d°C)\n\r", 
-                (output > 0.0f) ? "ON" : "OFF", (int)current_temp, (int)desired_temp);
-        }
+        controller_stage();
+        task_finished(TASK_PID, start);
 
         //  Tell the heater control to start working with this new value
+        task_released(TASK_HEATER);
         k_sem_give(&controller_to_heater_sem);
     }
 }
-K_THREAD_DEFINE(pid_task_id, 1024, pid_controller_task, NULL, NULL, NULL, 5, 0, 0);
+K_THREAD_DEFINE(pid_task_id, CONFIG_APP_PID_STACK_SIZE, pid_controller_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
 
 
 
@@ -241,42 +935,18 @@ K_THREAD_DEFINE(pid_task_id, 1024, pid_controller_task, NULL, NULL, NULL, 5, 0,
  * It ensures the heater only operates when the system is on.
  */
 void heat_control_task(void) {
-    // Initialize PID
-    bool last_heat_state = false;
-    bool heater_state = false;
-
     while (1) {
         // Wait for new PID on/off value
         k_sem_take(&controller_to_heater_sem, K_FOREVER);
+        uint32_t start = stamp_now();
 
-        bool verboseMode = rtdb_get_verbose();
-
-        // Only control if system is on
-        if (!rtdb_get_system_on()) {
-            if (last_heat_state) {
-                heater_state = false;
-                gpio_pin_set_dt(&fet, 0);
-
-                if (verboseMode) {
-                    printk("System off, heater off\n\r");
-                }
-            }
-            continue;
-        }
-        // Conversion
-        heater_state = rtdb_get_heat_on();
-
-        if (last_heat_state != heater_state){
-            gpio_pin_set_dt(&fet, heater_state);
-            if (verboseMode) {
-                printk("Heater turned: %d\n\r", heater_state);
-            }
-        }
-
-        last_heat_state = heater_state;
+        heater_stage();
+        task_finished(TASK_HEATER, start);
     }
 }
-K_THREAD_DEFINE(heat_task_id, 1024, heat_control_task, NULL, NULL, NULL, 5, 0, 0);
+K_THREAD_DEFINE(heat_task_id, CONFIG_APP_HEATER_STACK_SIZE, heat_control_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
+
+#endif /* CONFIG_APP_FUSED_PIPELINE */
 
 
 /**
@@ -290,7 +960,7 @@ K_THREAD_DEFINE(heat_task_id, 1024, heat_control_task, NULL, NULL, NULL, 5, 0, 0
  */
 int uart_init(void) {
     int err=0; /* Generic error variable */
-    uint8_t welcome_mesg[] = "\n\rUART COM: Hello user! Here is the list of possible commands:\n -> M (#M+30219!):   Set desired temperature\n -> D (#D068!):      Get desired temperature\n -> C (#C067!):      Get current temperature\n -> S (#Sp1.23135!): Set PID parameters\n -> V (#V086!):      Toggle verbose mode\n\r\n\r"; 
+    static const char welcome_mesg[] = "\n\rUART COM: Hello user! Here is the list of possible commands:\n -> M (#M+30219!):   Set desired temperature\n -> D (#D068!):      Get desired temperature\n -> C (#C067!):      Get current temperature\n -> S (#Sp1.23135!): Set PID parameters\n -> V (#V086!):      Toggle verbose mode\n -> L (#L076!):      Get sample-to-actuation latency\n -> P (#Ps0100132!): Set task period (l: LED, s: sampling)\n -> T (#T1e234!):    Get task timing (task 0-4, j/e/r: jitter/exec/response)\n -> R (#R082!):      Reset task timing\n -> W (#W087!):      Get deadline misses per task\n -> A (#A065!):      Print memory report\n -> I (#I073!):      Get sensor bus status\n -> G (#G071!):      Get heater switching statistics\n -> K (#K02173!):    Select control strategy (zone 0; 0-4: on/off, PI, PID, 2-DOF PID, MPC)\n -> U (#U1134!):     Start (1) or abort (0) the autotune, s for its status\n -> N (#N078!):      Get the identified plant model\n -> B (#Bs0229!):    Set gain schedule (s/t key, points of temp/Kp/Ki/Kd; 0 clears)\n -> F (#F0118!):     Upload setpoint profile (segments of rate/target/hold)\n -> O (#O1128!):     Start (1), stop (0), pause (p), resume (r) profile, s for status\n\r\n\r"; 
 
     /* Check if uart device is open */
     if (!device_is_ready(uart_dev)) {
@@ -298,13 +968,16 @@ int uart_init(void) {
         return ERR_FATAL;
     }
 
-    /* Configure UART */
+    /* Configure UART (-ENOSYS: fixed configuration, e.g. native_sim pty) */
     err = uart_configure(uart_dev, &uart_cfg);
-    if (err == -ENOSYS) { /* If invalid configuration */
+    if (err && err != -ENOSYS) { /* If invalid configuration */
         printk("uart_configure() error. Invalid configuration\n\r");
         return ERR_FATAL; 
     }
 
+    uartrx_init(&uart_rx);
+
+#if defined(CONFIG_UART_ASYNC_API)
     /* Register callback */
     err = uart_callback_set(uart_dev, uart_cb, NULL);
     if (err) {
@@ -313,11 +986,15 @@ int uart_init(void) {
     }
 		
     /* Enable data reception */
-    err =  uart_rx_enable(uart_dev ,rx_buf,sizeof(rx_buf),RX_TIMEOUT);
+    err =  uart_rx_enable(uart_dev, uartrx_buf_next(&uart_rx), UARTRX_DMA_SIZE, RX_TIMEOUT);
     if (err) {
         printk("uart_rx_enable() error. Error code:%d\n\r",err);
         return ERR_FATAL;
     }
+#else
+    /* No async API: poll for received characters */
+    k_timer_start(&uart_poll_timer, K_MSEC(UART_POLL_MS), K_MSEC(UART_POLL_MS));
+#endif
 
     /* Send a welcome message */ 
     printk("%s", welcome_mesg);
@@ -326,13 +1003,45 @@ int uart_init(void) {
 }
 
 
-bool startingMessage = false;
+/**
+ * @brief Feeds one received character to the command assembler.
+ *
+ * Echoes the characters of a frame, from '#' to '!', and wakes up the
+ * command task when the frame is complete.
+ *
+ * @param c Received character.
+ */
+static void uart_rx_char(uint8_t c) {
+    bool echo = (c == SOF_SYM) || uart_rx.in_frame;
+
+    switch (uartrx_char(&uart_rx, c)) {
+        case UARTRX_OVERFLOW:
+            printk("Message too long, discarding\n");
+            break;
+
+        case UARTRX_FRAME:
+            printk("%c\n", c);
+            task_released(TASK_UART);
+            k_sem_give(&uart_full_message_sem);  // Notify processor
+            return;
+
+        default:
+            break;
+    }
+
+    if (echo) {
+        printk("%c", c);
+    }
+}
+
+
+#if defined(CONFIG_UART_ASYNC_API)
 /**
  * @brief UART callback function.
  *
  * This callback handles various UART events, including TX done, RX ready, and buffer requests.
- * It accumulates incoming characters into a message buffer when a message starts with '#'
- * and ends with '!'. It also handles buffer overflow and restarts reception as needed.
+ * Received characters are passed to uart_rx_char(). Buffer requests are answered with
+ * the other receive buffer, and reception is restarted if it ever stops.
  *
  * @param dev Pointer to the UART device structure.
  * @param evt Pointer to the UART event structure.
@@ -344,68 +1053,37 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
     switch (evt->type) {
 	
         case UART_TX_DONE:
+            k_sem_give(&uart_tx_done_sem);
             break;
 
     	case UART_TX_ABORTED:
 	    	printk("UART_TX_ABORTED event \n\r");
+            k_sem_give(&uart_tx_done_sem);
 		    break;
 		
 	    case UART_RX_RDY:
             // Process each received character
             for (int i = 0; i < evt->data.rx.len; i++) {
-                uint8_t c = rx_buf[evt->data.rx.offset + i];
-                
-                // Start of new message
-                if (c == '#') {
-                    startingMessage = true;
-                    uart_rxbuf_nchar = 0;  // Reset buffer index
-                    rx_chars[uart_rxbuf_nchar++] = c;  // Store the start character
-                    rxChar(c);
-                    printk("%c", c);
-                } 
-                // In the middle of another message
-                else if (startingMessage) {
-                    // Only store if we're in a message
-                    if (uart_rxbuf_nchar < (RXBUF_SIZE - 1)) {
-                        rx_chars[uart_rxbuf_nchar++] = c;
-                        rxChar(c);
-                    } 
-                    else {
-                        // Buffer overflow - discard message
-                        printk("Message too long, discarding\n");
-                        startingMessage = false;
-                    }
-                    
-                    printk("%c", c);
-
-                    // Check for end character
-                    if (c == '!') {
-                        printk("\n");
-                        rx_chars[uart_rxbuf_nchar] = '\0';  // Null-terminate
-                        k_sem_give(&uart_full_message_sem);  // Notify processor
-                        startingMessage = false;
-                        uart_rxbuf_nchar = 0;
-                        memset(rx_buf, 0, sizeof(rx_buf));
-                    }
-                }
+                uart_rx_char(evt->data.rx.buf[evt->data.rx.offset + i]);
             }
 
 		    break;
 
 	    case UART_RX_BUF_REQUEST:
-            printk("\n\rERR: Message too long, discarding\n");
-            startingMessage = false;
-            uart_rxbuf_nchar = 0;
-            memset(rx_buf, 0, sizeof(rx_buf));
+            /* Queue the other buffer, so a frame longer than one buffer keeps arriving */
+            err = uart_rx_buf_rsp(uart_dev, uartrx_buf_next(&uart_rx), UARTRX_DMA_SIZE);
+            if (err) {
+                printk("uart_rx_buf_rsp() error. Error code:%d\n\r",err);
+            }
 		    break;
 
 	    case UART_RX_BUF_RELEASED:
 		    break;
 		
 	    case UART_RX_DISABLED: 
-            /* When the RX_BUFF becomes full RX is disabled automaticaly.  */
+            /* Without a queued buffer (e.g. after an error) RX is disabled.  */
             /* It must be re-enabled manually for continuous reception */
-		    err =  uart_rx_enable(uart_dev ,rx_buf,sizeof(rx_buf),RX_TIMEOUT);
+		    err =  uart_rx_enable(uart_dev, uartrx_buf_next(&uart_rx), UARTRX_DMA_SIZE, RX_TIMEOUT);
             if (err) {
                 printk("uart_rx_enable() error. Error code:%d\n\r",err);
                 exit(ERR_FATAL);                
@@ -423,6 +1101,22 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
 
 }
 
+#else
+
+/**
+ * @brief Receive polling timer (used when the UART has no async API).
+ *
+ * @param timer Unused.
+ */
+static void uart_poll_rx(struct k_timer *timer) {
+    unsigned char c;
+
+    while (uart_poll_in(uart_dev, &c) == 0) {
+        uart_rx_char(c);
+    }
+}
+#endif /* CONFIG_UART_ASYNC_API */
+
 
 /**
  * @brief UART command processing task.
@@ -433,31 +1127,193 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
  * @return int SUCCESS on success, ERR_FATAL on failure.
  */
 int uart_command_task(void) {
-    int err;
-    uint8_t rep_mesg[MSG_BUF_SIZE];
+    static uint8_t rep_mesg[MSG_BUF_SIZE];   /* Static: read by the UART DMA after uart_tx() returns */
 	int len;
-	unsigned char ans[64];
+	static unsigned char ans[UART_TX_SIZE + 1];
 
     while (1) {
-		resetRxBuffer();
-		resetTxBuffer();
-        // Wait for new complete message
-        k_sem_take(&uart_full_message_sem, K_FOREVER);
+        // Wait for new complete message, checking in with the supervisor while idle
+        uint32_t idle_ms = rtdb_get_task_period(TASK_UART);
+        if (k_sem_take(&uart_full_message_sem, idle_ms ? K_MSEC(idle_ms) : K_FOREVER) != 0) {
+            health_checkin(TASK_UART, k_uptime_get_32());
+            continue;
+        }
+        uint32_t start = stamp_now();
 
         cmdProcessor();     
+        schedule_apply();
         getTxBuffer(ans, &len);
         ans[len] = 0; /* Terminate the string */
 
-        sprintf(rep_mesg,"Response: %s\n\r",ans);            
+        snprintf((char *)rep_mesg, sizeof(rep_mesg), "Response: %s\n\r", ans);            
         
-        err = uart_tx(uart_dev, rep_mesg, strlen(rep_mesg), SYS_FOREVER_MS);
+#if defined(CONFIG_UART_ASYNC_API)
+        k_sem_reset(&uart_tx_done_sem);
+        int err = uart_tx(uart_dev, rep_mesg, strlen(rep_mesg), SYS_FOREVER_MS);
         if (err) {
             printk("uart_tx() error. Error code:%d\n\r",err);
-            return ERR_FATAL;
+        }
+        // Never block on a stuck transmission
+        else if (k_sem_take(&uart_tx_done_sem, K_MSEC(TX_TIMEOUT_MS)) != 0) {
+            printk("uart_tx() timeout, aborting\n\r");
+            uart_tx_abort(uart_dev);
+        }
+#else
+        for (size_t k = 0; rep_mesg[k] != '\0'; k++) {
+            uart_poll_out(uart_dev, rep_mesg[k]);
+        }
+#endif
+
+		resetRxBuffer();
+		resetTxBuffer();
+
+        task_finished(TASK_UART, start);
+    }
+}
+K_THREAD_DEFINE(uart_command_id, CONFIG_APP_UART_STACK_SIZE, uart_command_task, NULL, NULL, NULL, CONFIG_APP_BASE_PRIORITY, 0, 0);
+
+
+/* ---------- Scheduling ---------- */
+static uint32_t applied_periods[TASK_COUNT];  /**< Task periods the current priorities were derived from */
+
+/**
+ * @brief Applies rate-monotonic priorities to the system threads.
+ *
+ * Builds the task table from the periods stored in the RTDB, derives the
+ * thread priorities from them (shorter period, higher priority) and prints
+ * a schedulability report. Does nothing if no period changed since the
+ * last call.
+ */
+static void schedule_apply(void) {
+    uint32_t sample_period = rtdb_get_task_period(TASK_SENSOR);
+
+    struct sched_task tasks[TASK_COUNT] = {
+        [TASK_LED]    = { "led",      rtdb_get_task_period(TASK_LED),  CONFIG_APP_LED_WCET_US },
+#if defined(CONFIG_APP_FUSED_PIPELINE)
+        [TASK_SENSOR] = { "pipeline", read_period(sample_period),
+                          CONFIG_APP_SENSOR_WCET_US + CONFIG_APP_PID_WCET_US + CONFIG_APP_HEATER_WCET_US },
+        [TASK_PID]    = { "pid",      0, 0 },
+        [TASK_HEATER] = { "heater",   0, 0 },
+#else
+        [TASK_SENSOR] = { "sensor",   read_period(sample_period), CONFIG_APP_SENSOR_WCET_US },
+        [TASK_PID]    = { "pid",      sample_period, CONFIG_APP_PID_WCET_US },
+        [TASK_HEATER] = { "heater",   sample_period, CONFIG_APP_HEATER_WCET_US },
+#endif
+        [TASK_UART]   = { "uart",     rtdb_get_task_period(TASK_UART), CONFIG_APP_UART_WCET_US },
+    };
+
+    const k_tid_t tids[TASK_COUNT] = {
+        [TASK_LED]    = led_task_id,
+#if defined(CONFIG_APP_FUSED_PIPELINE)
+        [TASK_SENSOR] = pipeline_task_id,
+#else
+        [TASK_SENSOR] = temp_read_task_id,
+        [TASK_PID]    = pid_task_id,
+        [TASK_HEATER] = heat_task_id,
+#endif
+        [TASK_UART]   = uart_command_id,
+    };
+
+    bool changed = false;
+    for (int i = 0; i < TASK_COUNT; i++) {
+        if (tasks[i].period_ms != applied_periods[i]) {
+            applied_periods[i] = tasks[i].period_ms;
+            changed = true;
         }
     }
+    if (!changed) {
+        return;
+    }
+
+    sched_assign_rm(tasks, TASK_COUNT, CONFIG_APP_BASE_PRIORITY);
+    for (int i = 0; i < TASK_COUNT; i++) {
+        if (tasks[i].period_ms != 0) {
+            k_thread_priority_set(tids[i], tasks[i].priority);
+        }
+    }
+
+    uint32_t util, bound;
+    int status = sched_analyse(tasks, TASK_COUNT, &util, &bound);
+
+    printk("Schedule (rate monotonic):\n\r");
+    for (int i = 0; i < TASK_COUNT; i++) {
+        if (tasks[i].period_ms == 0) {
+            continue;
+        }
+        printk("  %-8s T=%4u ms  C=%5u us  prio=%2d  R=%6u us\n\r", tasks[i].name,
+               tasks[i].period_ms, tasks[i].wcet_us, tasks[i].priority, tasks[i].response_us);
+    }
+    printk("  U=%u.%u%% (bound %u.%u%%): %s\n\r", util / 10, util % 10, bound / 10, bound % 10,
+           (status == 0) ? "schedulable" :
+           (status == 1) ? "schedulable (response-time analysis)" : "NOT SCHEDULABLE, deadlines will be missed");
 }
-K_THREAD_DEFINE(uart_command_id, 1024, uart_command_task, NULL, NULL, NULL, 5, 0, 0);
+
+
+#if defined(CONFIG_APP_CONTROL_BENCH)
+#define BENCH_CALLS 1000  /**< Calls timed per control law */
+
+static volatile float bench_sink;  /**< Keeps the benchmarked results alive */
+
+/**
+ * @brief Prints the average time of one call out of BENCH_CALLS.
+ */
+static void bench_print(const char *name, uint32_t cycles) {
+    uint64_t ns = k_cyc_to_ns_floor64(cycles) / BENCH_CALLS;
+
+    printk("  %-24s %6u ns\n\r", name, (uint32_t)ns);
+}
+
+/**
+ * @brief Times the control laws on the target, with the cycle counter.
+ *
+ * The MPC runs on the boot model, and again with the longest dead time it
+ * holds, where the dot product is longest; the gain computation is what a
+ * model change costs, once.
+ */
+static void control_bench(void) {
+    const float dt = temp_read_thread_period / 1000.0f;
+    const float out_max = (heater_full_scale > 0) ? heater_full_scale : 1.0f;
+    struct plant_estimate long_dead = ctrl.mpc_model;
+    static struct mpc m;
+    float last_error = 0.0f, integral = 0.0f, acc = 0.0f;
+    uint32_t start;
+
+    printk("Control law timing (%u calls):\n\r", BENCH_CALLS);
+
+    start = k_cycle_get_32();
+    for (int n = 0; n < BENCH_CALLS; n++) {
+        acc += pid_calculate(30.0f, 25.0f + (n & 15) * 0.25f, dt, &last_error, &integral);
+    }
+    bench_print("pid_calculate", k_cycle_get_32() - start);
+
+    mpc_init(&m);
+    mpc_set_model(&m, &ctrl.mpc_model, out_max, CONFIG_APP_MPC_MOVE_WEIGHT);
+    acc += mpc_calculate(&m, 30.0f, 25.0f, dt);
+    start = k_cycle_get_32();
+    for (int n = 0; n < BENCH_CALLS; n++) {
+        acc += mpc_calculate(&m, 30.0f, 25.0f + (n & 15) * 0.25f, dt);
+    }
+    bench_print("mpc_calculate", k_cycle_get_32() - start);
+
+    long_dead.dead_s = (MPC_DELAY_SLOTS - 1) * dt;
+    mpc_set_model(&m, &long_dead, out_max, CONFIG_APP_MPC_MOVE_WEIGHT);
+    acc += mpc_calculate(&m, 30.0f, 25.0f, dt);
+    start = k_cycle_get_32();
+    for (int n = 0; n < BENCH_CALLS; n++) {
+        acc += mpc_calculate(&m, 30.0f, 25.0f + (n & 15) * 0.25f, dt);
+    }
+    bench_print("mpc_calculate, long dead", k_cycle_get_32() - start);
+
+    start = k_cycle_get_32();
+    for (int n = 0; n < BENCH_CALLS; n++) {
+        mpc_set_model(&m, &ctrl.mpc_model, out_max, CONFIG_APP_MPC_MOVE_WEIGHT + (n & 1));
+        acc += mpc_calculate(&m, 30.0f, 25.0f, dt);
+    }
+    bench_print("mpc gains + calculate", k_cycle_get_32() - start);
+
+    bench_sink = acc;
+}
+#endif
 
 
 /**
@@ -475,13 +1331,40 @@ int main(void) {
     gpio_pin_configure_dt(&led2, GPIO_OUTPUT_INACTIVE);
     gpio_pin_configure_dt(&led3, GPIO_OUTPUT_INACTIVE);
     // Setup Heater FET
-    gpio_pin_configure_dt(&fet, GPIO_OUTPUT_INACTIVE);
+    heater_init();
         
 
     uart_init();
     rtdb_init();
+    rtdb_set_controller(boot_controller);
     buttons_init();
 
+#if defined(CONFIG_APP_CONTROL_BENCH)
+    //  Time the control laws before the tasks load the CPU
+    control_bench();
+#endif
+
+#if defined(CONFIG_APP_TASK_STATS)
+    //  Setup task timing statistics
+    timing_init();
+    timing_start();
+    taskstats_init(timing_freq_get_mhz());
+#endif
+
+    //  Setup task periods and derive their priorities
+    rtdb_set_task_period(TASK_LED, led_thread_period);
+    rtdb_set_task_period(TASK_SENSOR, temp_read_thread_period);
+    rtdb_set_task_period(TASK_UART, CONFIG_APP_UART_MIN_INTERARRIVAL_MS);
+    schedule_apply();
+
+    //  Setup deadline supervision and the hardware watchdog
+    supervisor_init();
+
+#if defined(CONFIG_APP_MEM_REPORT)
+    //  Setup the memory report command (#A)
+    setMemReportHandler(memreport_print);
+#endif
+
 	/* Init UART RX and TX buffers */
 	resetTxBuffer();
 	resetRxBuffer();
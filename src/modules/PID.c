@@ -32,8 +32,8 @@ float pid_calculate(float setpoint, float measured, float dt,
     if (*integral < -20.0f) *integral = -20.0f;
     float Iout = Ki * (*integral);
 
-    // Derivative term
-    float derivative = (error - *last_error) / dt;
+    // Derivative term (none when no time has elapsed, e.g. on the first call)
+    float derivative = (dt > 0.0f) ? (error - *last_error) / dt : 0.0f;
     float Dout = Kd * derivative;
 
     *last_error = error;
@@ -0,0 +1,118 @@
+/**
+ * @file autotune.c
+ * @brief Relay-feedback autotuning (Åström-Hägglund).
+ *
+ * A relay with hysteresis replaces the controller: full power below the
+ * band, off above it. The loop settles into a limit cycle at its ultimate
+ * period Tu, with an amplitude a from which the describing function of the
+ * relay gives the ultimate gain, Ku = 4d / (π √(a² - ε²)), for a relay of
+ * amplitude d (half the output swing) and half-band ε. The first period is
+ * the heat-up transient and is discarded. The PID gains follow from Ku and
+ * Tu with the Ziegler-Nichols rule, for the parallel form used by the
+ * controller: Kp = 0.6 Ku, Ki = Kp / (Tu / 2), Kd = Kp · Tu / 8.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "autotune.h"
+
+#define PI_F 3.14159265f   /**< π */
+
+/**
+ * @brief Start a relay test.
+ * @param a Autotune state.
+ * @param cfg Parameters (copied).
+ */
+void autotune_start(struct autotune *a, const struct autotune_config *cfg) {
+    memset(a, 0, sizeof(*a));
+    a->cfg = *cfg;
+    a->status.state = AUTOTUNE_RUNNING;
+}
+
+/**
+ * @brief Computes Ku, Tu and the gains from the measured periods.
+ */
+static void autotune_finish(struct autotune *a) {
+    float amplitude = a->amp_sum / a->status.cycles;
+    float half_band = a->cfg.hysteresis / 2.0f;
+
+    if (amplitude <= half_band) {
+        //  The sensor never left the band: no oscillation to learn from
+        a->status.state = AUTOTUNE_FAILED;
+        return;
+    }
+
+    float ku = 4.0f * (a->cfg.out_max / 2.0f) / (PI_F * sqrtf(amplitude * amplitude - half_band * half_band));
+    float tu = a->period_sum / a->status.cycles;
+
+    a->status.ku = ku;
+    a->status.tu = tu;
+    a->status.kp = 0.6f * ku;
+    a->status.ki = a->status.kp / (tu / 2.0f);
+    a->status.kd = a->status.kp * tu / 8.0f;
+    a->status.state = AUTOTUNE_DONE;
+}
+
+/**
+ * @brief Run one control period of the relay test.
+ * @param a Autotune state.
+ * @param setpoint Desired temperature (°C).
+ * @param measured Current temperature (°C).
+ * @param dt Control period in seconds.
+ * @return Controller output to apply.
+ */
+float autotune_update(struct autotune *a, float setpoint, float measured, float dt) {
+    if (a->status.state != AUTOTUNE_RUNNING) {
+        return 0.0f;
+    }
+
+    a->elapsed_s += dt;
+    if (a->elapsed_s > a->cfg.timeout_s) {
+        a->status.state = AUTOTUNE_FAILED;
+        a->relay_on = false;
+        return 0.0f;
+    }
+
+    a->peak_max = fmaxf(a->peak_max, measured);
+    a->peak_min = fminf(a->peak_min, measured);
+
+    if (a->relay_on && measured >= setpoint + a->cfg.hysteresis / 2.0f) {
+        a->relay_on = false;
+    } else if (!a->relay_on && measured <= setpoint - a->cfg.hysteresis / 2.0f) {
+        //  Off-to-on switch: one oscillation period ends here
+        a->relay_on = true;
+        if (a->edges == 2) {
+            a->amp_sum += (a->peak_max - a->peak_min) / 2.0f;
+            a->period_sum += a->elapsed_s - a->cycle_start_s;
+            a->status.cycles++;
+        } else {
+            a->edges++;
+        }
+        a->cycle_start_s = a->elapsed_s;
+        a->peak_max = measured;
+        a->peak_min = measured;
+
+        if (a->status.cycles >= a->cfg.cycles) {
+            autotune_finish(a);
+            a->relay_on = false;
+            return 0.0f;
+        }
+    }
+
+    return a->relay_on ? a->cfg.out_max : 0.0f;
+}
+
+/**
+ * @brief Stop a running relay test.
+ * @param a Autotune state.
+ */
+void autotune_abort(struct autotune *a) {
+    if (a->status.state == AUTOTUNE_RUNNING) {
+        a->status.state = AUTOTUNE_IDLE;
+    }
+    a->relay_on = false;
+}
@@ -0,0 +1,94 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Autotune progress, in the order of the #U status digit.
+ */
+enum autotune_state {
+    AUTOTUNE_IDLE,          /**< Never started, or aborted */
+    AUTOTUNE_RUNNING,       /**< Relay oscillation under way */
+    AUTOTUNE_DONE,          /**< Gains computed and committed */
+    AUTOTUNE_FAILED,        /**< No usable oscillation before the timeout */
+};
+
+/**
+ * @brief Start and abort requests, passed from the command processor to the controller.
+ */
+enum autotune_request {
+    AUTOTUNE_REQ_NONE,      /**< Nothing to do */
+    AUTOTUNE_REQ_START,     /**< Start (or restart) a relay test */
+    AUTOTUNE_REQ_ABORT,     /**< Stop the relay test, keeping the gains */
+};
+
+/**
+ * @brief Relay test parameters.
+ */
+struct autotune_config {
+    float hysteresis;       /**< Relay band around the setpoint (°C), above the sensor noise */
+    float out_max;          /**< Controller output for full power; the relay swings 0..out_max */
+    uint8_t cycles;         /**< Oscillation periods averaged, after one discarded */
+    float timeout_s;        /**< Give up after this long */
+};
+
+/**
+ * @brief Autotune result, as published in the RTDB.
+ */
+struct autotune_status {
+    uint8_t state;          /**< enum autotune_state */
+    uint8_t cycles;         /**< Oscillation periods measured so far */
+    float ku;               /**< Ultimate gain (output per °C) */
+    float tu;               /**< Ultimate period (s) */
+    float kp;               /**< Computed proportional gain */
+    float ki;               /**< Computed integral gain */
+    float kd;               /**< Computed derivative gain */
+};
+
+/**
+ * @brief Relay test state.
+ */
+struct autotune {
+    struct autotune_config cfg;     /**< Parameters */
+    struct autotune_status status;  /**< Progress and result */
+    bool relay_on;                  /**< Relay output */
+    int8_t edges;                   /**< Off-to-on switches seen, up to 2 */
+    float elapsed_s;                /**< Time since the start */
+    float cycle_start_s;            /**< Time of the last off-to-on switch */
+    float peak_max;                 /**< Highest temperature of the current period */
+    float peak_min;                 /**< Lowest temperature of the current period */
+    float amp_sum;                  /**< Sum of the measured amplitudes (°C) */
+    float period_sum;               /**< Sum of the measured periods (s) */
+};
+
+/**
+ * @brief Start a relay test.
+ * @param a Autotune state.
+ * @param cfg Parameters (copied).
+ */
+void autotune_start(struct autotune *a, const struct autotune_config *cfg);
+
+/**
+ * @brief Run one control period of the relay test.
+ *
+ * Switches the heater fully on below the relay band and off above it,
+ * and measures the amplitude and period of the resulting oscillation.
+ * Once enough periods are measured, computes the ultimate gain and period
+ * and the PID gains (Ziegler-Nichols) and leaves the RUNNING state.
+ *
+ * @param a Autotune state.
+ * @param setpoint Desired temperature (°C).
+ * @param measured Current temperature (°C).
+ * @param dt Control period in seconds.
+ * @return Controller output to apply.
+ */
+float autotune_update(struct autotune *a, float setpoint, float measured, float dt);
+
+/**
+ * @brief Stop a running relay test.
+ * @param a Autotune state.
+ */
+void autotune_abort(struct autotune *a);
+
+#endif
@@ -43,22 +43,28 @@ static void btn1_handler(const struct device *dev, struct gpio_callback *cb, uin
 /**
  * @brief Callback for Button 2 press.
  *
- * Increases the desired temperature by 1 °C, if the system is on.
+ * Increases the desired temperature by 1 °C, if the system is on, and
+ * stops the setpoint profile, which would otherwise overwrite it.
  */
 static void btn2_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
-    if (rtdb_get_system_on())
+    if (rtdb_get_system_on()) {
+        rtdb_request_profile(PROFILE_REQ_STOP);
         rtdb_set_desired_temp(rtdb_get_desired_temp() + 1);
+    }
 }
 
 
 /**
  * @brief Callback for Button 4 press.
  *
- * Decreases the desired temperature by 1 °C, if the system is on.
+ * Decreases the desired temperature by 1 °C, if the system is on, and
+ * stops the setpoint profile, which would otherwise overwrite it.
  */
 static void btn4_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
-    if (rtdb_get_system_on())
+    if (rtdb_get_system_on()) {
+        rtdb_request_profile(PROFILE_REQ_STOP);
         rtdb_set_desired_temp(rtdb_get_desired_temp() - 1);
+    }
 }
 
 
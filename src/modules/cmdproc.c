@@ -18,15 +18,24 @@
 #include <time.h>    
 #include "cmdproc.h"
 #include "rtdb.h"
+#include "sched.h"
+#include "taskstats.h"
+#include "health.h"
+#include "control.h"
 
 /* Internal variables */
 /* Used as part of the UART emulation */
-static unsigned char UARTRxBuffer[UART_RX_SIZE];    /**< UART receive buffer */
+static unsigned char UARTRxBuffer[UART_RX_SIZE + 1];  /**< UART receive buffer, always NUL-terminated */
 static unsigned char rxBufLen = 0;                  /**< Length of received buffer */
 
 static unsigned char UARTTxBuffer[UART_TX_SIZE];    /**< UART transmit buffer */
 static unsigned char txBufLen = 0;                  /**< Length of transmit buffer */
 
+static void (*memReportHandler)(void) = NULL;       /**< Handler printing the memory report (#A) */
+
+static void send_response(const unsigned char *payload, int n);
+static int read_digits(const unsigned char *buf, int n);
+
 
 /* === Function Implementations === */
 
@@ -38,7 +47,21 @@ static unsigned char txBufLen = 0;                  /**< Length of transmit buff
  *  - #D...!: Get desired temperature.
  *  - #M...!: Set desired temperature.
  *  - #S...!: Set PID parameters.
+ *  - #K...!: Select the control strategy of a zone.
+ *  - #U...!: Start, abort or query the relay autotune.
  *  - #V...!: Toggle verbose mode.
+ *  - #L...!: Get sample-to-actuation latency.
+ *  - #P...!: Set a task period.
+ *  - #T...!: Get task timing statistics.
+ *  - #R...!: Reset task timing statistics.
+ *  - #W...!: Get deadline misses per task.
+ *  - #I...!: Get sensor bus status and error counters.
+ *  - #G...!: Get heater switching statistics.
+ *  - #N...!: Get the plant model identified online.
+ *  - #B...!: Upload the gain schedule.
+ *  - #F...!: Upload the setpoint profile.
+ *  - #O...!: Start, pause, resume, stop or query the setpoint profile.
+ *  - #A...!: Print the memory report.
  *
  * @return int Status code:
  *         -  0: Success
@@ -51,10 +74,8 @@ int cmdProcessor(void) {
     int i;
 
     char sensorStr[12];
-    unsigned char checksumBuffer[256];
+    unsigned char checksumBuffer[UART_TX_SIZE];     /* Response payload, framed by send_response() */
     int chksumIdx = 0;
-    int checksum = 0;
-    char checksumStr[5];
 
     
     /* Detect empty cmd string */
@@ -109,21 +130,7 @@ int cmdProcessor(void) {
                     checksumBuffer[chksumIdx++] = sensorStr[k];
                 }
 
-                for (int k = 0; k < chksumIdx; k++) {
-                    checksum += checksumBuffer[k];
-                }
-                checksum = checksum % 256;
-                
-                snprintf(checksumStr, sizeof(checksumStr), "%03d", checksum);
-
-                txChar('#');
-                for (int k = 0; k < chksumIdx; k++) {
-                    txChar(checksumBuffer[k]);
-                }
-                txChar(checksumStr[0]);
-                txChar(checksumStr[1]);
-                txChar(checksumStr[2]);
-                txChar('!');
+                send_response(checksumBuffer, chksumIdx);
 
                 rxBufLen = 0;
                 return 0;
@@ -157,27 +164,14 @@ int cmdProcessor(void) {
                     checksumBuffer[chksumIdx++] = sensorStr[k];
                 }
 
-                for (int k = 0; k < chksumIdx; k++) {
-                    checksum += checksumBuffer[k];
-                }
-                checksum = checksum % 256;
-                
-                snprintf(checksumStr, sizeof(checksumStr), "%03d", checksum);
-
-                txChar('#');
-                for (int k = 0; k < chksumIdx; k++) {
-                    txChar(checksumBuffer[k]);
-                }
-                txChar(checksumStr[0]);
-                txChar(checksumStr[1]);
-                txChar(checksumStr[2]);
-                txChar('!');
+                send_response(checksumBuffer, chksumIdx);
 
                 rxBufLen = 0;
                 return 0;
 
 
-            //  Responds like #Mxxxyyy!
+            //  Responds like #Mxxxyyy!; a manual setpoint stops the setpoint profile,
+            //  which would otherwise overwrite it at the next control period
             case 'M':  
                 if(UARTRxBuffer[i+8] != EOF_SYM) {
                     //  Send bad framing ACK
@@ -203,6 +197,7 @@ int cmdProcessor(void) {
                     intendedTemperature = -intendedTemperature;
                 }
 
+                rtdb_request_profile(PROFILE_REQ_STOP);
                 rtdb_set_desired_temp(intendedTemperature);
 
                 //  Send good ACK
@@ -231,11 +226,8 @@ int cmdProcessor(void) {
                 float Kp, Ki, Kd;
                 rtdb_get_PID_params(&Kp, &Ki, &Kd);
 
-                char setPIDStr[4]; // Buffer for 4 digits
-                setPIDStr[0] = UARTRxBuffer[i+2];
-                setPIDStr[1] = UARTRxBuffer[i+3];
-                setPIDStr[2] = UARTRxBuffer[i+4];
-                setPIDStr[3] = UARTRxBuffer[i+5];
+                char setPIDStr[5] = {0}; // Buffer for 4 characters, after the gain letter
+                memcpy(setPIDStr, &UARTRxBuffer[i+3], 4);
 
                 float newVal = atof(setPIDStr);
 
@@ -243,14 +235,99 @@ int cmdProcessor(void) {
                     // Kp
                     case 'p':
                         rtdb_set_PID_params(newVal, Ki, Kd);
+                        break;
                     // Ki
                     case 'i':
                         rtdb_set_PID_params(Kp, newVal, Kd);
+                        break;
                     // Kd
                     case 'd':
                         rtdb_set_PID_params(Kp, Ki, newVal);
+                        break;
+                }
+
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
+            //  Selects the control strategy of a zone as #Kzsyyy!
+            //  (z = zone '0'; s = '0' on/off, '1' PI, '2' PID, '3' 2-DOF PID, '4' MPC)
+            case 'K':
+                if(UARTRxBuffer[i+7] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
                 }
 
+                {
+                    int zone = UARTRxBuffer[i+2] - '0';
+                    int type = UARTRxBuffer[i+3] - '0';
+
+                    if (zone < 0 || zone >= CONTROL_ZONES || type < 0 || type >= CONTROLLER_COUNT) {
+                        send_ack(3);
+                        return -2;
+                    }
+                    rtdb_set_controller((enum controller_type)type);
+                }
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
+            //  Starts (#U1yyy!) or aborts (#U0yyy!) the relay autotune, or responds
+            //  to #Usyyy! as #uscpppppiiiiidddddyyy! (state, periods measured,
+            //  computed Kp, Ki and Kd in thousandths)
+            case 'U':
+                if(UARTRxBuffer[i+6] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                switch (UARTRxBuffer[i+2]) {
+                    case '1':
+                        rtdb_request_autotune(AUTOTUNE_REQ_START);
+                        break;
+                    case '0':
+                        rtdb_request_autotune(AUTOTUNE_REQ_ABORT);
+                        break;
+                    case 's': {
+                        struct autotune_status tune;
+                        rtdb_get_autotune_status(&tune);
+
+                        checksumBuffer[chksumIdx++] = 'u';
+                        snprintf((char *)&checksumBuffer[chksumIdx], 18, "%1u%1u%05u%05u%05u",
+                                 (unsigned)MIN(tune.state, 9u), (unsigned)MIN(tune.cycles, 9u),
+                                 (unsigned)MIN(fmaxf(tune.kp, 0.0f) * 1000.0f + 0.5f, 99999.0f),
+                                 (unsigned)MIN(fmaxf(tune.ki, 0.0f) * 1000.0f + 0.5f, 99999.0f),
+                                 (unsigned)MIN(fmaxf(tune.kd, 0.0f) * 1000.0f + 0.5f, 99999.0f));
+                        chksumIdx += 17;
+                        send_response(checksumBuffer, chksumIdx);
+
+                        rxBufLen = 0;
+                        return 0;
+                    }
+                    default:
+                        send_ack(3);
+                        return -2;
+                }
 
                 //  Send good ACK
                 send_ack(0);
@@ -281,6 +358,450 @@ int cmdProcessor(void) {
                 rxBufLen = 0;  // clean buffer
                 return 0;
 
+            //  Responds as #laaaaammmmmyyy! (average and maximum latency in us)
+            case 'L':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                uint32_t latLast, latMax, latAvg;
+                rtdb_get_latency(&latLast, &latMax, &latAvg);
+
+                snprintf((char *)checksumBuffer, sizeof(checksumBuffer), "l%05u%05u",
+                         (unsigned)MIN(latAvg, 99999u), (unsigned)MIN(latMax, 99999u));
+                send_response(checksumBuffer, 11);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Sets a task period as #Ptxxxxyyy! (t = 'l' LED, 's' sampling; xxxx in ms)
+            case 'P':
+                if(UARTRxBuffer[i+10] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                int task;
+                switch (UARTRxBuffer[i+2]) {
+                    case 'l':
+                        task = TASK_LED;
+                        break;
+                    case 's':
+                        task = TASK_SENSOR;
+                        break;
+                    default:
+                        send_ack(3);
+                        return -2;
+                }
+
+                char setPeriodStr[5] = {0}; // Buffer for 4 digits
+                memcpy(setPeriodStr, &UARTRxBuffer[i+3], 4);
+                int period = atoi(setPeriodStr);
+
+                if (period < 10) {
+                    send_ack(3);
+                    return -2;
+                }
+
+                rtdb_set_task_period(task, (uint32_t)period);
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
+            //  Responds as #tnnnnnmmmmmqqqqqxxxxxyyy! (min, p50, p99 and max in us)
+            //  to #Tkmyyy! (k = task '0'-'4', m = 'j' jitter, 'e' execution, 'r' response)
+            case 'T':
+                if(UARTRxBuffer[i+7] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                int metric;
+                switch (UARTRxBuffer[i+3]) {
+                    case 'j':
+                        metric = TASKSTATS_JITTER;
+                        break;
+                    case 'e':
+                        metric = TASKSTATS_EXEC;
+                        break;
+                    case 'r':
+                        metric = TASKSTATS_RESPONSE;
+                        break;
+                    default:
+                        metric = -1;
+                        break;
+                }
+
+                struct taskstats_summary stats;
+                if (taskstats_get(UARTRxBuffer[i+2] - '0', metric, &stats) != 0) {
+                    send_ack(3);
+                    return -2;
+                }
+
+                snprintf((char *)checksumBuffer, sizeof(checksumBuffer), "t%05u%05u%05u%05u",
+                         (unsigned)MIN(stats.min, 99999u), (unsigned)MIN(stats.p50, 99999u),
+                         (unsigned)MIN(stats.p99, 99999u), (unsigned)MIN(stats.max, 99999u));
+                send_response(checksumBuffer, 21);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Resets the task timing statistics as #Ryyy!
+            case 'R':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                taskstats_reset();
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
+            //  Responds as #waaaabbbbccccddddeeeeyyy! (deadline misses of each task, in task order)
+            case 'W':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                checksumBuffer[chksumIdx++] = 'w';
+                for (int k = 0; k < TASK_COUNT; k++) {
+                    snprintf((char *)&checksumBuffer[chksumIdx], 5, "%04u",
+                             (unsigned)MIN(health_get_misses(k), 9999u));
+                    chksumIdx += 4;
+                }
+                send_response(checksumBuffer, chksumIdx);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Responds as #iftttttrrrrrfffffyyy! (sensor ok flag, timeouts, retries, failures)
+            case 'I':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                {
+                    struct rtdb_sensor_status status;
+                    rtdb_get_sensor_status(&status);
+
+                    checksumBuffer[chksumIdx++] = 'i';
+                    checksumBuffer[chksumIdx++] = status.ok ? '1' : '0';
+                    snprintf((char *)&checksumBuffer[chksumIdx], 16, "%05u%05u%05u",
+                             (unsigned)MIN(status.timeouts, 99999u),
+                             (unsigned)MIN(status.retries, 99999u),
+                             (unsigned)MIN(status.failures, 99999u));
+                    chksumIdx += 15;
+                }
+                send_response(checksumBuffer, chksumIdx);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Responds as #gsssssuuuuunnnnnfffffrrrrryyy! (switches, suppressed, held by min on/off time, by rate)
+            case 'G':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                {
+                    struct governor_stats stats;
+                    rtdb_get_switch_stats(&stats);
+
+                    checksumBuffer[chksumIdx++] = 'g';
+                    snprintf((char *)&checksumBuffer[chksumIdx], 26, "%05u%05u%05u%05u%05u",
+                             (unsigned)MIN(stats.switches, 99999u),
+                             (unsigned)MIN(stats.suppressed, 99999u),
+                             (unsigned)MIN(stats.held_min_on, 99999u),
+                             (unsigned)MIN(stats.held_min_off, 99999u),
+                             (unsigned)MIN(stats.held_rate, 99999u));
+                    chksumIdx += 25;
+                }
+                send_response(checksumBuffer, chksumIdx);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Responds as #nvgggglllllddddaaaasssssyyy! (valid, gain in 0.1 °C, time
+            //  constant and dead time in 0.1 s, ambient in 0.1 °C, periods learnt from)
+            case 'N':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                {
+                    struct plant_estimate est;
+                    rtdb_get_plant_estimate(&est);
+
+                    checksumBuffer[chksumIdx++] = 'n';
+                    snprintf((char *)&checksumBuffer[chksumIdx], 23, "%1u%04u%05u%03u%04u%05u",
+                             est.valid ? 1u : 0u,
+                             (unsigned)MIN(fmaxf(est.gain_c, 0.0f) * 10.0f + 0.5f, 9999.0f),
+                             (unsigned)MIN(fmaxf(est.tau_s, 0.0f) * 10.0f + 0.5f, 99999.0f),
+                             (unsigned)MIN(fmaxf(est.dead_s, 0.0f) * 10.0f + 0.5f, 999.0f),
+                             (unsigned)MIN(fmaxf(est.ambient_c, 0.0f) * 10.0f + 0.5f, 9999.0f),
+                             (unsigned)MIN(est.samples, 99999u));
+                    chksumIdx += 22;
+                }
+                send_response(checksumBuffer, chksumIdx);
+
+                rxBufLen = 0;
+                return 0;
+
+            //  Uploads the gain schedule as #Bkn{tttpppppiiiiiddddd}yyy! (k = 's' indexed
+            //  by the setpoint, 't' by the temperature; n points, '0' to stop scheduling;
+            //  per point, the temperature in °C and Kp, Ki and Kd in thousandths)
+            case 'B': {
+                int n = UARTRxBuffer[i+3] - '0';
+
+                if(n < 0 || n > GAINSCHED_MAX || rxBufLen - i != 8 + 18 * n || UARTRxBuffer[i+7+18*n] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                struct gain_schedule gs = { .count = (uint8_t)n };
+                switch (UARTRxBuffer[i+2]) {
+                    case 's':
+                        gs.key = GAINSCHED_SETPOINT;
+                        break;
+                    case 't':
+                        gs.key = GAINSCHED_TEMP;
+                        break;
+                    default:
+                        send_ack(3);
+                        return -2;
+                }
+
+                for (int k = 0; k < n; k++) {
+                    const unsigned char *point = &UARTRxBuffer[i+4+18*k];
+                    int temp = read_digits(point, 3);
+                    int kp = read_digits(point + 3, 5);
+                    int ki = read_digits(point + 8, 5);
+                    int kd = read_digits(point + 13, 5);
+
+                    if (temp < 0 || kp < 0 || ki < 0 || kd < 0) {
+                        send_ack(3);
+                        return -2;
+                    }
+                    gs.points[k] = (struct gain_point){ temp, kp / 1000.0f, ki / 1000.0f, kd / 1000.0f };
+                }
+
+                if (gainsched_check(&gs) != 0) {
+                    send_ack(3);
+                    return -2;
+                }
+                rtdb_set_gain_schedule(&gs);
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+            }
+
+            //  Uploads the setpoint profile as #Fn{rrrrtttthhhhh}yyy! (n segments; per
+            //  segment, the ramp rate in 0.1 °C/min, '0000' to step, the target in
+            //  0.1 °C and the hold in s)
+            case 'F': {
+                int n = UARTRxBuffer[i+2] - '0';
+
+                if(n < 0 || n > PROFILE_MAX || rxBufLen - i != 7 + 13 * n || UARTRxBuffer[i+6+13*n] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                struct profile prog = { .count = (uint8_t)n };
+                for (int k = 0; k < n; k++) {
+                    const unsigned char *segment = &UARTRxBuffer[i+3+13*k];
+                    int rate = read_digits(segment, 4);
+                    int target = read_digits(segment + 4, 4);
+                    int hold = read_digits(segment + 8, 5);
+
+                    if (rate < 0 || target < 0 || hold < 0) {
+                        send_ack(3);
+                        return -2;
+                    }
+                    prog.segments[k] = (struct profile_segment){ rate / 10.0f, target / 10.0f, (uint32_t)hold * 1000u };
+                }
+                if (profile_check(&prog) != 0) {
+                    send_ack(3);
+                    return -2;
+                }
+                rtdb_set_profile(&prog);
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+            }
+
+            //  Starts (1), stops (0), pauses (p) or resumes (r) the setpoint profile; status
+            //  (s) responds as #osnhttttrrrrryyy! (state, segment, holding, setpoint in
+            //  0.1 °C, time left in the ramp or hold in s). The profile keeps its clock
+            //  while the system is off; #M and the buttons stop it.
+            case 'O':
+                if(UARTRxBuffer[i+6] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                switch (UARTRxBuffer[i+2]) {
+                    case '1':
+                        rtdb_request_profile(PROFILE_REQ_START);
+                        break;
+                    case '0':
+                        rtdb_request_profile(PROFILE_REQ_STOP);
+                        break;
+                    case 'p':
+                        rtdb_request_profile(PROFILE_REQ_PAUSE);
+                        break;
+                    case 'r':
+                        rtdb_request_profile(PROFILE_REQ_RESUME);
+                        break;
+                    case 's': {
+                        struct profile_status prof;
+                        char digits[16];
+                        rtdb_get_profile_status(&prof);
+
+                        checksumBuffer[chksumIdx++] = 'o';
+                        snprintf(digits, sizeof(digits), "%1u%1u%1u%04u%05u",
+                                 (unsigned)MIN(prof.state, 9u), (unsigned)MIN(prof.segment, 9u),
+                                 prof.holding ? 1u : 0u,
+                                 (unsigned)MIN(fmaxf(prof.setpoint_c, 0.0f) * 10.0f + 0.5f, 9999.0f),
+                                 (unsigned)MIN((prof.remaining_ms + 500u) / 1000u, 99999u));
+                        memcpy(&checksumBuffer[chksumIdx], digits, 12);
+                        chksumIdx += 12;
+                        send_response(checksumBuffer, chksumIdx);
+
+                        rxBufLen = 0;
+                        return 0;
+                    }
+                    default:
+                        send_ack(3);
+                        return -2;
+                }
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
+            //  Prints the memory report on the console as #Ayyy!
+            case 'A':
+                if(UARTRxBuffer[i+5] != EOF_SYM) {
+                    //  Send bad framing ACK
+                    send_ack(1);
+                    return -4;
+                }
+
+                if(calcChecksum(&(UARTRxBuffer[i+1]), rxBufLen - 5) != msgCheckSum) {
+                    //  Send bad checksum ACK
+                    send_ack(2);
+                    return -3;
+                }
+
+                if (memReportHandler == NULL) {
+                    send_ack(3);
+                    return -2;
+                }
+                memReportHandler();
+
+                //  Send good ACK
+                send_ack(0);
+
+                rxBufLen = 0;  // clean buffer
+                return 0;
+
             default:
                 //  Send bad command ACK
                 send_ack(3);
@@ -292,6 +813,36 @@ int cmdProcessor(void) {
 }
 
 
+/**
+ * @brief Reads a field of decimal digits.
+ *
+ * @param buf First digit.
+ * @param n Number of digits.
+ * @return The value, or -1 if a character is not a digit.
+ */
+static int read_digits(const unsigned char *buf, int n) {
+    int value = 0;
+
+    for (int k = 0; k < n; k++) {
+        if (buf[k] < '0' || buf[k] > '9') {
+            return -1;
+        }
+        value = value * 10 + (buf[k] - '0');
+    }
+    return value;
+}
+
+
+/**
+ * @brief Registers the function printing the memory report requested with #A.
+ *
+ * @param handler Report function, or NULL to disable the command.
+ */
+void setMemReportHandler(void (*handler)(void)) {
+    memReportHandler = handler;
+}
+
+
 /**
  * @brief Calculates 8-bit checksum for a given buffer.
  * 
@@ -401,6 +952,28 @@ int getTxBufferSize(void){
 }
 
 
+/**
+ * @brief Frames a response payload as #<payload>yyy! in the transmit buffer.
+ *
+ * @param payload Response bytes (command letter followed by data).
+ * @param n Number of payload bytes.
+ */
+static void send_response(const unsigned char *payload, int n) {
+    char checksumStr[5];
+
+    snprintf(checksumStr, sizeof(checksumStr), "%03d", calcChecksum((unsigned char *)payload, n));
+
+    txChar('#');
+    for (int k = 0; k < n; k++) {
+        txChar(payload[k]);
+    }
+    txChar(checksumStr[0]);
+    txChar(checksumStr[1]);
+    txChar(checksumStr[2]);
+    txChar('!');
+}
+
+
 /**
  * @brief Sends an acknowledgment message with appropriate checksum.
  * 
@@ -30,8 +30,8 @@
 /* Some defines */
 /* Other defines should be return codes of the functions */
 /* E.g. #define CMD_EMPTY_STRING -1                      */
-#define UART_RX_SIZE 20 	/**< Maximum size of the RX buffer */ 
-#define UART_TX_SIZE 20 	/**< Maximum size of the TX buffer */ 
+#define UART_RX_SIZE 160 	/**< Maximum size of the RX buffer (a full #B gain schedule) */ 
+#define UART_TX_SIZE 32 	/**< Maximum size of the TX buffer */ 
 #define SOF_SYM '#'	        /**< Start of Frame Symbol */
 #define EOF_SYM '!'         /**< End of Frame Symbol */
 
@@ -43,7 +43,21 @@
  *  - #D...!: Get desired temperature.
  *  - #M...!: Set desired temperature.
  *  - #S...!: Set PID parameters.
+ *  - #K...!: Select the control strategy of a zone.
+ *  - #U...!: Start, abort or query the relay autotune.
  *  - #V...!: Toggle verbose mode.
+ *  - #L...!: Get sample-to-actuation latency.
+ *  - #P...!: Set a task period.
+ *  - #T...!: Get task timing statistics.
+ *  - #R...!: Reset task timing statistics.
+ *  - #W...!: Get deadline misses per task.
+ *  - #A...!: Print the memory report.
+ *  - #I...!: Get sensor bus status and error counters.
+ *  - #G...!: Get heater switching statistics.
+ *  - #N...!: Get the plant model identified online.
+ *  - #B...!: Upload the gain schedule.
+ *  - #F...!: Upload the setpoint profile.
+ *  - #O...!: Start, pause, resume, stop or query the setpoint profile.
  *
  * @return int Status code:
  *         -  0: Success
@@ -88,6 +102,13 @@ void resetTxBuffer(void);
  */
 void getTxBuffer(unsigned char * buf, int * len);
 
+/**
+ * @brief Registers the function printing the memory report requested with #A.
+ * 
+ * @param handler Report function, or NULL to disable the command.
+ */
+void setMemReportHandler(void (*handler)(void));
+
 /**
  * @brief Calculates 8-bit checksum for a given buffer.
  * 
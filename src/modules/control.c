@@ -0,0 +1,242 @@
+/**
+ * @file control.c
+ * @brief Temperature control law shared by the firmware and the host tools.
+ *
+ * Holds the part of the sensor -> controller -> heater chain that does not
+ * touch hardware: the control strategy selected in the RTDB (controller.c)
+ * runs on the RTDB temperatures, or on the Kalman estimate of the
+ * temperature (kalman.c), with the RTDB gains or those of the RTDB gain
+ * schedule (gainsched.c), and its decision goes back to the RTDB. While
+ * an autotune runs (autotune.c), the relay test drives the heater instead,
+ * and its gains go to the RTDB when it ends. Alongside, the plant model
+ * is identified online (ident.c) from the temperature and the heater power
+ * of every period. The setpoint itself can come from a ramp/soak profile
+ * (profile.c) run on the clock. main.c calls it from the controller and
+ * heater stages; the host simulator calls it on a virtual clock.
+ *
+ * The controller output becomes a heater duty cycle: proportional up to
+ * full_scale for the time-proportional output (tpo.c), or all-or-nothing
+ * for plain on/off control.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "rtdb.h"
+#include "control.h"
+
+/**
+ * @brief Reset the control state.
+ * @param c Control state.
+ * @param full_scale PID output for 100 % duty, or 0 for on/off control.
+ */
+void control_init(struct control *c, float full_scale) {
+    memset(c, 0, sizeof(*c));
+    c->full_scale = full_scale;
+    c->hysteresis = 1.0f;
+    c->beta = 0.5f;
+    c->mpc_model.gain_c = 50.0f;
+    c->mpc_model.tau_s = 40.0f;
+    c->mpc_model.dead_s = 2.0f;
+    c->move_weight = MPC_MOVE_WEIGHT;
+    c->tune_cfg.hysteresis = 1.0f;
+    c->tune_cfg.cycles = 3;
+    c->tune_cfg.timeout_s = 3600.0f;
+    c->ident_period_s = 1.0f;
+    c->ident_memory_s = 10000.0f;
+}
+
+/**
+ * @brief Maps a controller output to a heater duty cycle in ‰.
+ */
+static uint16_t control_duty(const struct control *c, float output) {
+    if (output <= 0.0f) {
+        return 0;
+    }
+    if (c->full_scale <= 0.0f || output >= c->full_scale) {
+        return 1000;
+    }
+    return (uint16_t)(output * 1000.0f / c->full_scale + 0.5f);
+}
+
+/**
+ * @brief Runs the selected strategy with the RTDB gains, or the scheduled ones.
+ */
+static float control_strategy(struct control *c, float out_max, float setpoint, float measured, float dt) {
+    const struct controller_ops *ops = controller_get(rtdb_get_controller());
+    struct controller_params params = {
+        .hysteresis = c->hysteresis,
+        .beta = c->beta,
+        .out_max = out_max,
+        .model = &c->mpc_model,
+        .move_weight = c->move_weight,
+    };
+    struct plant_estimate est;
+
+    if (ops == NULL) {
+        ops = controller_get(CONTROLLER_PID);
+    }
+    if (ops != c->ops) {
+        //  First period, after an autotune, or another strategy was selected
+        if (c->ops == NULL) {
+            ops->init(&c->state);
+        }
+        ops->reset(&c->state, setpoint, measured, c->output);
+        c->ops = ops;
+    }
+
+    if (ops == controller_get(CONTROLLER_MPC)) {
+        //  Only the MPC needs the model
+        rtdb_get_plant_estimate(&est);
+        if (est.valid) {
+            params.model = &est;
+        }
+    }
+
+    rtdb_get_PID_params(&params.kp, &params.ki, &params.kd);
+    if (rtdb_get_gain_schedule(NULL) != c->sched_gen) {
+        c->sched_gen = rtdb_get_gain_schedule(&c->sched);
+    }
+    gainsched_lookup(&c->sched, (c->sched.key == GAINSCHED_TEMP) ? measured : setpoint,
+                     &params.kp, &params.ki, &params.kd);
+
+    //  Bumpless gain change: Ki x integral stays where it was
+    if (params.ki != c->last_ki && params.ki > 0.0f && c->last_ki > 0.0f) {
+        c->state.integral *= c->last_ki / params.ki;
+    }
+    c->last_ki = params.ki;
+
+    return ops->update(&c->state, &params, setpoint, measured, dt);
+}
+
+/**
+ * @brief Runs the relay test; commits the gains when it succeeds.
+ */
+static float control_autotune(struct control *c, float setpoint, float measured, float dt) {
+    float output = 0.0f;
+
+    if (!rtdb_get_system_on()) {
+        //  The relay cannot oscillate with the heater disabled
+        autotune_abort(&c->tune);
+    } else {
+        output = autotune_update(&c->tune, setpoint, measured, dt);
+    }
+
+    if (c->tune.status.state == AUTOTUNE_DONE) {
+        //  All three gains under one lock: the PID never sees a mix of old and new
+        rtdb_set_PID_params(c->tune.status.kp, c->tune.status.ki, c->tune.status.kd);
+    }
+    if (c->tune.status.state != AUTOTUNE_RUNNING) {
+        //  Hand the loop back to the strategy, from a clean state
+        c->ops = NULL;
+    }
+    rtdb_set_autotune_status(&c->tune.status);
+    return output;
+}
+
+/**
+ * @brief Run one control period on the RTDB values.
+ * @param c Control state.
+ * @param dt Control period in seconds.
+ * @return 0 if the controller ran, -1 if the sample was invalid.
+ */
+int control_step(struct control *c, float dt) {
+    if (!rtdb_get_sensor_ok()) {
+        /* No valid sample: fail safe and keep the controller state frozen */
+        rtdb_set_heat_duty(0);
+        rtdb_set_heat_on(false);
+        return -1;
+    }
+
+    float current_temp = rtdb_get_current_temp_mdeg() / 1000.0f;
+    float measured = c->use_estimate ? rtdb_get_estimated_temp_mdeg() / 1000.0f : current_temp;
+    float desired_temp = rtdb_get_desired_temp_mdeg() / 1000.0f;
+    float out_max = (c->full_scale > 0.0f) ? c->full_scale : 1.0f;
+
+    //  Started at the first period, and again when the period changes: the
+    //  averaging, candidate decays and forgetting factor all depend on it
+    if (c->ident.sample_s != dt) {
+        ident_init(&c->ident, dt, c->ident_period_s, c->ident_memory_s);
+    }
+    if (ident_update(&c->ident, current_temp, c->last_duty / 1000.0f)) {
+        struct plant_estimate est;
+        ident_estimate(&c->ident, &est);
+        rtdb_set_plant_estimate(&est);
+    }
+
+    switch (rtdb_take_autotune_request()) {
+        case AUTOTUNE_REQ_START:
+            c->tune_cfg.out_max = out_max;
+            autotune_start(&c->tune, &c->tune_cfg);
+            rtdb_set_autotune_status(&c->tune.status);
+            break;
+        case AUTOTUNE_REQ_ABORT:
+            autotune_abort(&c->tune);
+            rtdb_set_autotune_status(&c->tune.status);
+            c->ops = NULL;
+            break;
+        default:
+            break;
+    }
+
+    if (c->tune.status.state == AUTOTUNE_RUNNING) {
+        c->output = control_autotune(c, desired_temp, measured, dt);
+    } else {
+        c->output = control_strategy(c, out_max, desired_temp, measured, dt);
+    }
+
+    uint16_t duty = rtdb_get_system_on() ? control_duty(c, c->output) : 0;
+    c->last_duty = duty;
+    rtdb_set_heat_duty(duty);
+    rtdb_set_heat_on(duty > 0);
+    return 0;
+}
+
+/**
+ * @brief Run the setpoint profile for one control period.
+ * @param c Control state.
+ * @param now_ms Clock (ms).
+ */
+void control_profile(struct control *c, uint32_t now_ms) {
+    struct profile_run *r = &c->profile;
+
+    switch (rtdb_take_profile_request()) {
+        case PROFILE_REQ_START: {
+            struct profile prog;
+            float current_temp = rtdb_get_current_temp_mdeg() / 1000.0f;
+
+            rtdb_get_profile(&prog);
+            profile_start(r, &prog, c->use_estimate ? rtdb_get_estimated_temp_mdeg() / 1000.0f : current_temp,
+                          now_ms);
+            break;
+        }
+        case PROFILE_REQ_PAUSE:
+            profile_pause(r);
+            break;
+        case PROFILE_REQ_RESUME:
+            profile_resume(r, now_ms);
+            break;
+        case PROFILE_REQ_STOP:
+            profile_stop(r);
+            break;
+        default:
+            break;
+    }
+
+    if (r->status.state == PROFILE_RUNNING) {
+        profile_update(r, now_ms);
+        rtdb_set_desired_temp_mdeg((int32_t)lroundf(r->status.setpoint_c * 1000.0f));
+    }
+    rtdb_set_profile_status(&r->status);
+}
+
+/**
+ * @brief Heater duty cycle to apply to the output.
+ * @return Duty in ‰, 0 while the system is off.
+ */
+uint16_t control_heater_duty(void) {
+    return rtdb_get_system_on() ? rtdb_get_heat_duty() : 0;
+}
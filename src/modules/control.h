@@ -0,0 +1,101 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "controller.h"
+#include "autotune.h"
+#include "ident.h"
+#include "gainsched.h"
+#include "profile.h"
+
+#define CONTROL_ZONES 1   /**< Heater zones: one FET, on the mean of the TC74s */
+
+/**
+ * @brief State of the temperature control law between two control periods.
+ */
+struct control {
+    const struct controller_ops *ops;  /**< Strategy that ran last, NULL before the first period */
+    struct controller_state state;     /**< Strategy state */
+    float output;       /**< Last controller output */
+    float full_scale;   /**< Controller output for 100 % duty; 0 for on/off control */
+    float hysteresis;   /**< On/off strategy band (°C) */
+    float beta;         /**< 2-DOF setpoint weight */
+    bool use_estimate;  /**< Act on the Kalman estimate of the temperature instead of the filtered reads */
+    struct plant_estimate mpc_model;   /**< MPC plant model until the identification is valid */
+    float move_weight;                 /**< MPC weight of the output moves */
+    struct gain_schedule sched;        /**< Copy of the RTDB gain schedule */
+    uint32_t sched_gen;                /**< Generation of the copy */
+    float last_ki;                     /**< Integral gain of the previous period */
+    struct autotune_config tune_cfg;   /**< Relay test parameters; out_max is set at the start */
+    struct autotune tune;              /**< Relay test state */
+    float ident_period_s;              /**< Plant identification period (s) */
+    float ident_memory_s;              /**< Plant identification memory (s) */
+    struct ident ident;                /**< Plant identification state, restarted when the period changes */
+    uint16_t last_duty;                /**< Duty applied since the previous period (‰) */
+    struct profile_run profile;        /**< Setpoint profile executor */
+};
+
+/**
+ * @brief Reset the control state.
+ *
+ * The on/off strategy gets a 1 °C band, the 2-DOF PID a setpoint weight
+ * of 0.5, the MPC the default plant of the simulator (50 °C, 40 s, 2 s)
+ * and a move weight of MPC_MOVE_WEIGHT, the autotune a 1 °C relay band,
+ * 3 periods and a one hour timeout, and the plant identification a 1 s
+ * period and a memory of about three hours; change the fields afterwards
+ * to tune them.
+ *
+ * @param c Control state.
+ * @param full_scale Controller output that maps to 100 % heater duty, or 0 to
+ *                   switch the heater fully on whenever the output is positive.
+ */
+void control_init(struct control *c, float full_scale);
+
+/**
+ * @brief Run one control period on the RTDB values.
+ *
+ * Runs the strategy selected in the RTDB on the current (or, with
+ * use_estimate, the estimated) and desired temperatures and stores the
+ * heater duty, and whether it is non-zero, in the RTDB. A newly selected
+ * strategy takes over with its reset(), keeping the integral, so switching
+ * does not kick the output. While the RTDB holds a gain schedule, the
+ * gains come from it, at the setpoint or the temperature, instead of the
+ * PID parameters; whenever Ki changes, the integral is rescaled so that
+ * the integral term, and the output, do not jump. The MPC plans on the
+ * identified plant model once it is valid, and on mpc_model until then.
+ * An autotune request from the RTDB starts or aborts the relay test, which
+ * then drives the heater until it commits its gains. Every period also
+ * feeds the current temperature and the heater power to the plant
+ * identification, which publishes its estimate in the RTDB. Without a
+ * valid sample the heater is switched off and the state is left untouched.
+ *
+ * @param c Control state.
+ * @param dt Control period in seconds.
+ * @return 0 if the controller ran, -1 if the sample was invalid.
+ */
+int control_step(struct control *c, float dt);
+
+/**
+ * @brief Run the setpoint profile for one control period.
+ *
+ * Takes a start, pause, resume or stop request from the RTDB. A start
+ * copies the RTDB profile and ramps from the temperature the controller
+ * acts on. While the profile runs, it advances to now_ms and its setpoint
+ * replaces the RTDB desired temperature, whether the system is on or off;
+ * #M and the buttons therefore request a stop along with their setpoint.
+ * Once paused, stopped or done, the desired temperature is left where the
+ * profile took it. Call it before control_step() in every period.
+ *
+ * @param c Control state.
+ * @param now_ms Clock (ms): the kernel uptime in the firmware.
+ */
+void control_profile(struct control *c, uint32_t now_ms);
+
+/**
+ * @brief Heater duty cycle to apply to the output.
+ * @return Duty in ‰, 0 while the system is off.
+ */
+uint16_t control_heater_duty(void);
+
+#endif
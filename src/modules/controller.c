@@ -0,0 +1,165 @@
+/**
+ * @file controller.c
+ * @brief Control strategies behind a common interface.
+ *
+ * The cheap strategies need no gains: on/off with hysteresis is a
+ * comparison, PI skips the derivative. The PID takes the derivative of the
+ * measurement instead of the error, so a setpoint step gives no derivative
+ * kick. The 2-DOF PID also weights the setpoint in the proportional term,
+ * which softens the response to setpoint steps without changing the
+ * response to disturbances. It runs in velocity form (the output changes
+ * by the increment of each term), so the weight applies to setpoint
+ * changes and not to the absolute temperature, and clamping the output to
+ * the heater range is its anti-windup. The MPC (mpc.c) needs no gains but
+ * a model of the plant, and plans around its dead time.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#include "controller.h"
+
+#define INTEGRAL_LIMIT 20.0f   /**< Anti-windup clamp of the integral (°C·s), as pid_calculate() */
+
+/**
+ * @brief Clears the whole state.
+ */
+static void state_init(struct controller_state *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * @brief Restarts the derivative from the measurement, keeping the integral.
+ */
+static void state_reset(struct controller_state *s, float setpoint, float measured, float output) {
+    s->last_measured = measured;
+    s->prev_measured = measured;
+    s->last_setpoint = setpoint;
+    s->output = output;
+}
+
+/**
+ * @brief Integrates the error with the anti-windup clamp.
+ */
+static float integrate(struct controller_state *s, float error, float dt) {
+    s->integral += error * dt;
+    if (s->integral > INTEGRAL_LIMIT) s->integral = INTEGRAL_LIMIT;
+    if (s->integral < -INTEGRAL_LIMIT) s->integral = -INTEGRAL_LIMIT;
+    return s->integral;
+}
+
+/**
+ * @brief On/off with hysteresis: switches on below the band and off above it.
+ */
+static float onoff_update(struct controller_state *s, const struct controller_params *p,
+                          float setpoint, float measured, float dt) {
+    ARG_UNUSED(dt);
+    if (measured <= setpoint - p->hysteresis / 2.0f) {
+        s->on = true;
+    } else if (measured >= setpoint + p->hysteresis / 2.0f) {
+        s->on = false;
+    }
+    return s->on ? p->out_max : 0.0f;
+}
+
+/**
+ * @brief Starts the on/off strategy off; the band decides at the next update.
+ */
+static void onoff_reset(struct controller_state *s, float setpoint, float measured, float output) {
+    state_reset(s, setpoint, measured, output);
+    s->on = false;
+}
+
+/**
+ * @brief PI: proportional and integral terms on the error.
+ */
+static float pi_update(struct controller_state *s, const struct controller_params *p,
+                       float setpoint, float measured, float dt) {
+    float error = setpoint - measured;
+
+    s->last_measured = measured;
+    return p->kp * error + p->ki * integrate(s, error, dt);
+}
+
+/**
+ * @brief PID with the derivative on the measurement.
+ */
+static float pid_update(struct controller_state *s, const struct controller_params *p,
+                        float setpoint, float measured, float dt) {
+    float error = setpoint - measured;
+    float derivative = (dt > 0.0f) ? -(measured - s->last_measured) / dt : 0.0f;
+
+    s->last_measured = measured;
+    return p->kp * error + p->ki * integrate(s, error, dt) + p->kd * derivative;
+}
+
+/**
+ * @brief 2-DOF PID in velocity form: setpoint weight beta on the
+ * proportional increment, derivative on the measurement, output clamped
+ * to 0..out_max.
+ */
+static float pid_2dof_update(struct controller_state *s, const struct controller_params *p,
+                             float setpoint, float measured, float dt) {
+    float delta = p->kp * (p->beta * (setpoint - s->last_setpoint) - (measured - s->last_measured)) +
+                  p->ki * (setpoint - measured) * dt;
+
+    if (dt > 0.0f) {
+        delta -= p->kd * (measured - 2.0f * s->last_measured + s->prev_measured) / dt;
+    }
+
+    s->output += delta;
+    if (s->output > p->out_max) s->output = p->out_max;
+    if (s->output < 0.0f) s->output = 0.0f;
+
+    s->prev_measured = s->last_measured;
+    s->last_measured = measured;
+    s->last_setpoint = setpoint;
+    return s->output;
+}
+
+/**
+ * @brief Clears the whole state, with the MPC model at rest.
+ */
+static void mpc_state_init(struct controller_state *s) {
+    memset(s, 0, sizeof(*s));
+    mpc_init(&s->mpc);
+}
+
+/**
+ * @brief MPC on the plant model, output clamped to 0..out_max.
+ */
+static float mpc_update(struct controller_state *s, const struct controller_params *p,
+                        float setpoint, float measured, float dt) {
+    mpc_set_model(&s->mpc, p->model, p->out_max, p->move_weight);
+    s->last_measured = measured;
+    return mpc_calculate(&s->mpc, setpoint, measured, dt);
+}
+
+/**
+ * @brief Starts the MPC from the last output, with its model in steady state.
+ */
+static void mpc_state_reset(struct controller_state *s, float setpoint, float measured, float output) {
+    state_reset(s, setpoint, measured, output);
+    mpc_reset(&s->mpc, output);
+}
+
+static const struct controller_ops strategies[CONTROLLER_COUNT] = {
+    [CONTROLLER_ONOFF] = { "onoff", state_init, onoff_update, onoff_reset },
+    [CONTROLLER_PI] = { "pi", state_init, pi_update, state_reset },
+    [CONTROLLER_PID] = { "pid", state_init, pid_update, state_reset },
+    [CONTROLLER_PID_2DOF] = { "pid2dof", state_init, pid_2dof_update, state_reset },
+    [CONTROLLER_MPC] = { "mpc", mpc_state_init, mpc_update, mpc_state_reset },
+};
+
+/**
+ * @brief Get a control strategy.
+ * @param type Strategy.
+ * @return Its operations, or NULL if type is not a strategy.
+ */
+const struct controller_ops *controller_get(enum controller_type type) {
+    return ((unsigned)type < CONTROLLER_COUNT) ? &strategies[type] : NULL;
+}
@@ -0,0 +1,90 @@
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include <stdbool.h>
+#include "ident.h"
+#include "mpc.h"
+
+/**
+ * @brief Control strategies, in the order of their #K command digit.
+ */
+enum controller_type {
+    CONTROLLER_ONOFF,       /**< On/off with hysteresis, no gains */
+    CONTROLLER_PI,          /**< PI, Kd ignored */
+    CONTROLLER_PID,         /**< PID with the derivative on the measurement */
+    CONTROLLER_PID_2DOF,    /**< PID with a setpoint weight on the proportional term, velocity form */
+    CONTROLLER_MPC,         /**< Model-predictive control on the plant model, no gains */
+    CONTROLLER_COUNT        /**< Number of strategies */
+};
+
+/**
+ * @brief Tuning of a control strategy; each one uses what it needs.
+ */
+struct controller_params {
+    float kp;               /**< Proportional gain */
+    float ki;               /**< Integral gain */
+    float kd;               /**< Derivative gain */
+    float hysteresis;       /**< On/off band around the setpoint, in °C (on below -h/2, off above +h/2) */
+    float beta;             /**< 2-DOF setpoint weight of the proportional term (1 = plain PID) */
+    float out_max;          /**< Output for full power: on/off output, 2-DOF and MPC output limit */
+    const struct plant_estimate *model;  /**< MPC plant model */
+    float move_weight;      /**< MPC weight of the output moves against the errors */
+};
+
+/**
+ * @brief State a strategy keeps between two control periods.
+ */
+struct controller_state {
+    float integral;         /**< Accumulated error (°C·s) */
+    float last_measured;    /**< Measurement of the previous period */
+    float prev_measured;    /**< Measurement two periods ago (velocity form) */
+    float last_setpoint;    /**< Setpoint of the previous period (velocity form) */
+    float output;           /**< Last output (velocity form) */
+    bool on;                /**< On/off strategy output */
+    struct mpc mpc;         /**< MPC model state and gains */
+};
+
+/**
+ * @brief Control strategy interface.
+ */
+struct controller_ops {
+    const char *name;       /**< Short name for logs and tools */
+
+    /**
+     * @brief Clears the whole state, before the first update.
+     * @param s Strategy state.
+     */
+    void (*init)(struct controller_state *s);
+
+    /**
+     * @brief Runs one control period.
+     * @param s Strategy state.
+     * @param p Tuning.
+     * @param setpoint Desired temperature (°C).
+     * @param measured Current temperature (°C).
+     * @param dt Control period in seconds.
+     * @return Controller output, heater power grows with it (0 or less is off).
+     */
+    float (*update)(struct controller_state *s, const struct controller_params *p,
+                    float setpoint, float measured, float dt);
+
+    /**
+     * @brief Prepares the strategy to take over the loop without a kick:
+     * the derivative starts from the current measurement, the integral is
+     * kept and the velocity form carries on from the last output.
+     * @param s Strategy state.
+     * @param setpoint Current setpoint (°C).
+     * @param measured Current temperature (°C).
+     * @param output Last output of the loop.
+     */
+    void (*reset)(struct controller_state *s, float setpoint, float measured, float output);
+};
+
+/**
+ * @brief Get a control strategy.
+ * @param type Strategy.
+ * @return Its operations, or NULL if type is not a strategy.
+ */
+const struct controller_ops *controller_get(enum controller_type type);
+
+#endif
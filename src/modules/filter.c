@@ -0,0 +1,108 @@
+/**
+ * @file filter.c
+ * @brief Integer filters for the temperature samples.
+ *
+ * Moving average, median-of-N and first-order IIR low-pass, all in integer
+ * arithmetic on samples in a fixed-point unit chosen by the caller (the
+ * firmware uses millidegrees). Averaging several whole-degree TC74 reads
+ * yields sub-degree values instead of a staircase.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <string.h>
+
+#include "filter.h"
+
+/**
+ * @brief Integer division rounded to the nearest integer (d > 0).
+ */
+static int32_t div_round(int32_t n, int32_t d) {
+    return (n >= 0) ? (n + d / 2) / d : (n - d / 2) / d;
+}
+
+/**
+ * @brief Initialize a filter.
+ * @param f Filter state.
+ * @param type Algorithm.
+ * @param len Window length, clamped to 1..FILTER_MAX_LEN.
+ * @param shift IIR smoothing shift, clamped to 0..12 (keeps the state within 32 bits for |x| < 2^19).
+ */
+void filter_init(struct filter *f, enum filter_type type, int len, int shift) {
+    f->type = type;
+    f->len = (len < 1) ? 1 : (len > FILTER_MAX_LEN) ? FILTER_MAX_LEN : len;
+    f->shift = (shift < 0) ? 0 : (shift > 12) ? 12 : shift;
+    filter_reset(f);
+}
+
+/**
+ * @brief Forget the past samples, keeping the configuration.
+ * @param f Filter state.
+ */
+void filter_reset(struct filter *f) {
+    f->count = 0;
+    f->head = 0;
+    f->sum = 0;
+    f->acc = 0;
+    memset(f->window, 0, sizeof(f->window));
+}
+
+/**
+ * @brief Feed a sample and get the filtered value.
+ *
+ * Until the window is full, the moving average and the median use the
+ * samples received so far; the IIR starts from the first sample.
+ *
+ * @param f Filter state.
+ * @param x New sample.
+ * @return Filtered value, in the unit of the samples.
+ */
+int32_t filter_update(struct filter *f, int32_t x) {
+    if (f->type == FILTER_IIR) {
+        if (f->count == 0) {
+            f->count = 1;
+            f->acc = x * (1 << f->shift);
+        } else {
+            /* acc = y * 2^shift, so y += (x - y) / 2^shift keeps its fraction */
+            f->acc += x - div_round(f->acc, 1 << f->shift);
+        }
+        return div_round(f->acc, 1 << f->shift);
+    }
+
+    if (f->type == FILTER_NONE) {
+        return x;
+    }
+
+    //  Window shared by the moving average and the median
+    if (f->count == f->len) {
+        f->sum -= f->window[f->head];
+    } else {
+        f->count++;
+    }
+    f->window[f->head] = x;
+    f->sum += x;
+    f->head = (f->head + 1) % f->len;
+
+    if (f->type == FILTER_MOVING_AVG) {
+        return div_round(f->sum, f->count);
+    }
+
+    //  Median: insertion sort of a copy (N <= FILTER_MAX_LEN)
+    int32_t sorted[FILTER_MAX_LEN];
+    for (int i = 0; i < f->count; i++) {
+        int32_t v = f->window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    int mid = f->count / 2;
+    if (f->count % 2) {
+        return sorted[mid];
+    }
+    return div_round(sorted[mid - 1] + sorted[mid], 2);
+}
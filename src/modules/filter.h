@@ -0,0 +1,59 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+
+#define FILTER_MAX_LEN 16  /**< Longest moving average / median window */
+
+/**
+ * @brief Filter algorithms.
+ */
+enum filter_type {
+    FILTER_NONE,        /**< Pass-through */
+    FILTER_MOVING_AVG,  /**< Mean of the last N samples */
+    FILTER_MEDIAN,      /**< Median of the last N samples */
+    FILTER_IIR,         /**< First-order low-pass, y += (x - y) / 2^shift */
+};
+
+/**
+ * @brief Filter state. Samples and outputs are integers (e.g. millidegrees).
+ */
+struct filter {
+    enum filter_type type;            /**< Algorithm */
+    uint8_t len;                      /**< Window length (moving average, median) */
+    uint8_t shift;                    /**< Smoothing shift (IIR) */
+    uint8_t count;                    /**< Samples in the window */
+    uint8_t head;                     /**< Next window slot to overwrite */
+    int32_t window[FILTER_MAX_LEN];   /**< Last samples (moving average, median) */
+    int32_t sum;                      /**< Sum of the window (moving average) */
+    int32_t acc;                      /**< Output scaled by 2^shift (IIR) */
+};
+
+/**
+ * @brief Initialize a filter.
+ * @param f Filter state.
+ * @param type Algorithm.
+ * @param len Window length, clamped to 1..FILTER_MAX_LEN.
+ * @param shift IIR smoothing shift, clamped to 0..12 (keeps the state within 32 bits for |x| < 2^19).
+ */
+void filter_init(struct filter *f, enum filter_type type, int len, int shift);
+
+/**
+ * @brief Forget the past samples, keeping the configuration.
+ * @param f Filter state.
+ */
+void filter_reset(struct filter *f);
+
+/**
+ * @brief Feed a sample and get the filtered value.
+ *
+ * Until the window is full, the moving average and the median use the
+ * samples received so far; the IIR starts from the first sample.
+ *
+ * @param f Filter state.
+ * @param x New sample.
+ * @return Filtered value, in the unit of the samples.
+ */
+int32_t filter_update(struct filter *f, int32_t x);
+
+#endif
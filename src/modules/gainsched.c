@@ -0,0 +1,78 @@
+/**
+ * @file gainsched.c
+ * @brief Gain scheduling: PID gains interpolated from a table against temperature.
+ *
+ * One set of gains rarely suits both the warm-up and the hold, or a low
+ * and a high setpoint, since the heat losses grow with the temperature. The
+ * table holds up to GAINSCHED_MAX points of (temperature, Kp, Ki, Kd),
+ * indexed by the setpoint or by the current temperature. Between two
+ * points the gains are interpolated linearly, so they never jump as the
+ * temperature crosses from one band into the next; control.c also rescales
+ * the integral when Ki changes, so the output does not jump either.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include "gainsched.h"
+
+/**
+ * @brief Check a schedule before it is used.
+ * @param gs Schedule.
+ * @return 0 if valid, -1 otherwise.
+ */
+int gainsched_check(const struct gain_schedule *gs) {
+    if (gs->count > GAINSCHED_MAX || gs->key > GAINSCHED_TEMP) {
+        return -1;
+    }
+    for (int i = 0; i < gs->count; i++) {
+        const struct gain_point *p = &gs->points[i];
+        if (p->kp < 0.0f || p->ki < 0.0f || p->kd < 0.0f) {
+            return -1;
+        }
+        if (i > 0 && !(p->temp_c > gs->points[i - 1].temp_c)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Gains of the schedule at a temperature.
+ * @param gs Valid schedule.
+ * @param temp_c Key temperature (°C).
+ * @param kp Proportional gain.
+ * @param ki Integral gain.
+ * @param kd Derivative gain.
+ */
+void gainsched_lookup(const struct gain_schedule *gs, float temp_c, float *kp, float *ki, float *kd) {
+    if (gs->count == 0) {
+        return;
+    }
+
+    const struct gain_point *first = &gs->points[0], *last = &gs->points[gs->count - 1];
+    if (temp_c <= first->temp_c || temp_c >= last->temp_c) {
+        const struct gain_point *p = (temp_c <= first->temp_c) ? first : last;
+        *kp = p->kp;
+        *ki = p->ki;
+        *kd = p->kd;
+        return;
+    }
+
+    //  points[lo].temp_c <= temp_c < points[hi].temp_c
+    int lo = 0, hi = gs->count - 1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (gs->points[mid].temp_c <= temp_c) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const struct gain_point *a = &gs->points[lo], *b = &gs->points[hi];
+    float w = (temp_c - a->temp_c) / (b->temp_c - a->temp_c);
+    *kp = a->kp + w * (b->kp - a->kp);
+    *ki = a->ki + w * (b->ki - a->ki);
+    *kd = a->kd + w * (b->kd - a->kd);
+}
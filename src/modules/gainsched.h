@@ -0,0 +1,60 @@
+#ifndef GAINSCHED_H
+#define GAINSCHED_H
+
+#include <stdint.h>
+
+#define GAINSCHED_MAX 8   /**< Most points in a gain schedule */
+
+/**
+ * @brief What the schedule is indexed by.
+ */
+enum gainsched_key {
+    GAINSCHED_SETPOINT,   /**< Desired temperature */
+    GAINSCHED_TEMP,       /**< Current temperature */
+};
+
+/**
+ * @brief Gains at one temperature.
+ */
+struct gain_point {
+    float temp_c;         /**< Temperature of the point (°C) */
+    float kp;             /**< Proportional gain */
+    float ki;             /**< Integral gain */
+    float kd;             /**< Derivative gain */
+};
+
+/**
+ * @brief Table of gains against temperature. With no points, the gains
+ * are not scheduled.
+ */
+struct gain_schedule {
+    uint8_t count;        /**< Points in use, 0 to GAINSCHED_MAX */
+    uint8_t key;          /**< Index of the table (enum gainsched_key) */
+    struct gain_point points[GAINSCHED_MAX];  /**< Points, by strictly increasing temperature */
+};
+
+/**
+ * @brief Check a schedule before it is used.
+ * @param gs Schedule.
+ * @return 0 if valid, -1 if it has too many points, points out of order,
+ *         negative gains or an unknown key.
+ */
+int gainsched_check(const struct gain_schedule *gs);
+
+/**
+ * @brief Gains of the schedule at a temperature.
+ *
+ * Interpolates linearly between the two points around the temperature,
+ * so the gains change continuously with it, and holds the first and last
+ * points beyond the ends of the table. Finds the points by bisection.
+ * Leaves the gains untouched if the schedule has no points.
+ *
+ * @param gs Valid schedule.
+ * @param temp_c Setpoint or current temperature, as the key of the schedule (°C).
+ * @param kp Proportional gain.
+ * @param ki Integral gain.
+ * @param kd Derivative gain.
+ */
+void gainsched_lookup(const struct gain_schedule *gs, float temp_c, float *kp, float *ki, float *kd);
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file governor.c
+ * @brief Switching governor for the heater FET.
+ *
+ * Sits between the controller decision and the FET pin and enforces a
+ * minimum on time, a minimum off time and an average switching rate. The
+ * rate limit is a credit that grows with time, up to two switches (one
+ * on/off cycle), and every switch spends 60000 / max_per_min ms of it.
+ * Periodic outputs have their duty quantised instead, so that no pulse or
+ * gap is shorter than the minimum times.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <string.h>
+
+#include "governor.h"
+
+/**
+ * @brief Cost of one switch in credit ms, 0 without a rate limit.
+ */
+static uint32_t switch_cost(const struct governor *g) {
+    return (g->cfg.max_per_min > 0) ? 60000u / g->cfg.max_per_min : 0;
+}
+
+/**
+ * @brief Adds the credit earned since the last update, up to two switches.
+ */
+static void refill(struct governor *g, uint32_t now_ms) {
+    uint32_t cap = 2 * switch_cost(g);
+    uint32_t earned = now_ms - g->credit_at_ms;
+
+    g->credit_ms = (earned >= cap - g->credit_ms) ? cap : g->credit_ms + earned;
+    g->credit_at_ms = now_ms;
+}
+
+/**
+ * @brief Counts the edges of the pulses output since the last update, two per period.
+ */
+static void count_pulses(struct governor *g, uint32_t now_ms) {
+    if (g->duty > 0 && g->duty < 1000 && g->period_ms > 0) {
+        g->pulse_ms += now_ms - g->duty_at_ms;
+        g->stats.switches += 2 * (g->pulse_ms / g->period_ms);
+        g->pulse_ms %= g->period_ms;
+    }
+    g->duty_at_ms = now_ms;
+}
+
+/**
+ * @brief A minimum time as a share of the period (‰), rounded up.
+ */
+static uint32_t min_permille(uint32_t min_ms, uint32_t period_ms) {
+    return (min_ms * 1000u + period_ms - 1) / period_ms;
+}
+
+/**
+ * @brief Initialize the governor with the output off and full switching credit.
+ * @param g Governor state.
+ * @param cfg Limits (copied).
+ * @param now_ms Current time in ms.
+ */
+void governor_init(struct governor *g, const struct governor_config *cfg, uint32_t now_ms) {
+    memset(g, 0, sizeof(*g));
+    g->cfg = *cfg;
+    g->credit_ms = 2 * switch_cost(g);
+    g->credit_at_ms = now_ms;
+    //  The output has been off "forever": switching on is not held back
+    g->changed_ms = now_ms - cfg->min_off_ms;
+}
+
+/**
+ * @brief Request an output state.
+ * @param g Governor state.
+ * @param on Requested state.
+ * @param now_ms Current time in ms.
+ * @return Output state to apply.
+ */
+bool governor_request(struct governor *g, bool on, uint32_t now_ms) {
+    refill(g, now_ms);
+
+    if (on == g->state) {
+        g->pending = false;
+        return g->state;
+    }
+
+    uint32_t min_ms = g->state ? g->cfg.min_on_ms : g->cfg.min_off_ms;
+    uint32_t *held = NULL;
+
+    if (now_ms - g->changed_ms < min_ms) {
+        held = g->state ? &g->stats.held_min_on : &g->stats.held_min_off;
+    } else if (g->credit_ms < switch_cost(g)) {
+        held = &g->stats.held_rate;
+    }
+
+    if (held != NULL) {
+        if (!g->pending) {
+            g->pending = true;
+            g->stats.suppressed++;
+            (*held)++;
+        }
+        return g->state;
+    }
+
+    g->state = on;
+    g->pending = false;
+    g->changed_ms = now_ms;
+    g->credit_ms -= switch_cost(g);
+    g->stats.switches++;
+    return g->state;
+}
+
+/**
+ * @brief Request a duty cycle of a periodic output (PWM or time-proportional window).
+ * @param g Governor state.
+ * @param permille Requested duty (‰, larger values mean fully on).
+ * @param period_ms Period of the output, in ms.
+ * @param now_ms Current time in ms.
+ * @return Duty to apply (‰).
+ */
+uint16_t governor_duty(struct governor *g, uint16_t permille, uint32_t period_ms, uint32_t now_ms) {
+    uint16_t duty = (permille > 1000) ? 1000 : permille;
+
+    count_pulses(g, now_ms);
+
+    uint32_t on_min = (period_ms > 0) ? min_permille(g->cfg.min_on_ms, period_ms) : 1000;
+    uint32_t off_min = (period_ms > 0) ? min_permille(g->cfg.min_off_ms, period_ms) : 1000;
+    uint32_t *held = NULL;
+
+    //  No room for pulses within the limits: plain on/off, at the nearest level
+    if (on_min + off_min > 1000 || (g->cfg.max_per_min > 0 && 2 * 60000u > g->cfg.max_per_min * period_ms)) {
+        g->duty = governor_request(g, duty >= 500, now_ms) ? 1000 : 0;
+        return g->duty;
+    }
+
+    if (duty > 0 && duty < on_min) {
+        held = &g->stats.held_min_on;
+        duty = (2 * duty >= on_min) ? on_min : 0;
+    } else if (duty < 1000 && 1000 - duty < off_min) {
+        held = &g->stats.held_min_off;
+        duty = (2 * (1000 - duty) >= off_min) ? 1000 - off_min : 1000;
+    }
+
+    if (held == NULL) {
+        g->pending = false;
+    } else if (!g->pending) {
+        g->pending = true;
+        g->stats.suppressed++;
+        (*held)++;
+    }
+
+    //  Leaving fully off or fully on is an edge of its own
+    if ((g->duty == 0 && duty > 0) || (g->duty == 1000 && duty < 1000)) {
+        g->stats.switches++;
+        g->pulse_ms = 0;
+    }
+    if (g->state != (duty > 0)) {
+        g->state = (duty > 0);
+        g->changed_ms = now_ms;
+    }
+    g->duty = duty;
+    g->period_ms = period_ms;
+    return duty;
+}
+
+/**
+ * @brief Switch the output off at once, ignoring the limits (fail safe).
+ * @param g Governor state.
+ * @param now_ms Current time in ms.
+ */
+void governor_force_off(struct governor *g, uint32_t now_ms) {
+    refill(g, now_ms);
+    count_pulses(g, now_ms);
+    g->pending = false;
+    g->duty = 0;
+
+    if (g->state) {
+        uint32_t cost = switch_cost(g);
+        g->state = false;
+        g->changed_ms = now_ms;
+        g->credit_ms = (g->credit_ms > cost) ? g->credit_ms - cost : 0;
+        g->stats.switches++;
+    }
+}
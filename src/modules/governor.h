@@ -0,0 +1,94 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Switching limits of the FET. 0 disables a limit.
+ */
+struct governor_config {
+    uint32_t min_on_ms;       /**< Shortest time on before switching off */
+    uint32_t min_off_ms;      /**< Shortest time off before switching on */
+    uint16_t max_per_min;     /**< Most switches per minute, on average */
+};
+
+/**
+ * @brief Switching statistics.
+ *
+ * A requested transition is counted as suppressed once, when it is first
+ * held back, whether it is applied later or dropped.
+ */
+struct governor_stats {
+    uint32_t switches;        /**< Transitions applied */
+    uint32_t suppressed;      /**< Transitions held back */
+    uint32_t held_min_on;     /**< ... by the minimum on time */
+    uint32_t held_min_off;    /**< ... by the minimum off time */
+    uint32_t held_rate;       /**< ... by the switching rate limit */
+};
+
+/**
+ * @brief Switching governor state.
+ */
+struct governor {
+    struct governor_config cfg;    /**< Limits */
+    struct governor_stats stats;   /**< Counters */
+    bool state;                    /**< Output state */
+    bool pending;                  /**< A held back transition is still requested */
+    uint32_t changed_ms;           /**< Time of the last switch */
+    uint32_t credit_ms;            /**< Rate limit credit (a switch costs 60000 / max_per_min) */
+    uint32_t credit_at_ms;         /**< Time the credit was last updated */
+    uint16_t duty;                 /**< Duty applied by governor_duty() (‰) */
+    uint32_t period_ms;            /**< Period of that duty */
+    uint32_t duty_at_ms;           /**< Time its pulses were last counted */
+    uint32_t pulse_ms;             /**< Pulse time not yet counted as a whole period */
+};
+
+/**
+ * @brief Initialize the governor with the output off and full switching credit.
+ * @param g Governor state.
+ * @param cfg Limits (copied).
+ * @param now_ms Current time in ms.
+ */
+void governor_init(struct governor *g, const struct governor_config *cfg, uint32_t now_ms);
+
+/**
+ * @brief Request an output state.
+ *
+ * Switches if the minimum on/off time has elapsed and the rate limit has
+ * credit for one more switch; otherwise keeps the current state. Call it
+ * again later (e.g. every control period) to apply a held back request.
+ *
+ * @param g Governor state.
+ * @param on Requested state.
+ * @param now_ms Current time in ms.
+ * @return Output state to apply.
+ */
+bool governor_request(struct governor *g, bool on, uint32_t now_ms);
+
+/**
+ * @brief Request a duty cycle of a periodic output (PWM or time-proportional window).
+ *
+ * Every period with a duty strictly between 0 and 1000 ‰ has two edges. An
+ * on or off time shorter than its minimum is rounded to 0 or to that
+ * minimum, whichever is nearer. When the period cannot fit both minimums,
+ * or its two edges exceed the rate limit, the output falls back to on/off
+ * through governor_request(): on from 500 ‰. Switches are counted two per
+ * period while pulsing, plus one when pulsing starts from fully off or on.
+ *
+ * @param g Governor state.
+ * @param permille Requested duty (‰, larger values mean fully on).
+ * @param period_ms Period of the output, in ms.
+ * @param now_ms Current time in ms.
+ * @return Duty to apply (‰).
+ */
+uint16_t governor_duty(struct governor *g, uint16_t permille, uint32_t period_ms, uint32_t now_ms);
+
+/**
+ * @brief Switch the output off at once, ignoring the limits (fail safe).
+ * @param g Governor state.
+ * @param now_ms Current time in ms.
+ */
+void governor_force_off(struct governor *g, uint32_t now_ms);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file health.c
+ * @brief Deadline-miss accounting and per-task heartbeat monitoring.
+ *
+ * Every periodic task registers a deadline and checks in at the end of each
+ * job. Jobs finishing after their deadline, and releases lost to timer
+ * overruns, are counted as misses. A supervisor polls health_all_alive()
+ * and only feeds the hardware watchdog while every task keeps checking in.
+ *
+ * Each task only writes its own 32-bit slots, and the supervisor only reads
+ * them, so no locking is needed and the supervisor can run in an ISR.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <string.h>
+
+#include "health.h"
+
+static struct {
+    uint32_t deadline_ms[TASK_COUNT];    /**< Relative deadline, 0 if not monitored */
+    uint32_t last_checkin[TASK_COUNT];   /**< Uptime of the last check-in (ms) */
+    uint32_t misses[TASK_COUNT];         /**< Deadline misses since boot */
+} health;
+
+/**
+ * @brief Initialize the health monitor (no task monitored, counters cleared).
+ */
+void health_init(void) {
+    memset(&health, 0, sizeof(health));
+}
+
+/**
+ * @brief Register (or update) the deadline of a task.
+ * @param task Task identifier (see enum task_id).
+ * @param deadline_ms Relative deadline in ms, 0 to stop monitoring the task.
+ * @param now_ms Current uptime in ms, used as the initial check-in time.
+ */
+void health_set_deadline(int task, uint32_t deadline_ms, uint32_t now_ms) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return;
+    }
+    health.last_checkin[task] = now_ms;
+    health.deadline_ms[task] = deadline_ms;
+}
+
+/**
+ * @brief Signal that a task is alive.
+ * @param task Task identifier (see enum task_id).
+ * @param now_ms Current uptime in ms.
+ */
+void health_checkin(int task, uint32_t now_ms) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return;
+    }
+    health.last_checkin[task] = now_ms;
+}
+
+/**
+ * @brief Report a finished job: checks its response time against the deadline and checks in.
+ * @param task Task identifier (see enum task_id).
+ * @param response_ms Time from the job release to its end, in ms.
+ * @param now_ms Current uptime in ms.
+ */
+void health_job_done(int task, uint32_t response_ms, uint32_t now_ms) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return;
+    }
+    if (health.deadline_ms[task] != 0 && response_ms > health.deadline_ms[task]) {
+        health.misses[task]++;
+    }
+    health.last_checkin[task] = now_ms;
+}
+
+/**
+ * @brief Count deadline misses detected elsewhere (e.g. timer overruns).
+ * @param task Task identifier (see enum task_id).
+ * @param n Number of missed deadlines.
+ */
+void health_add_misses(int task, uint32_t n) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return;
+    }
+    health.misses[task] += n;
+}
+
+/**
+ * @brief Get the number of deadline misses of a task.
+ * @param task Task identifier (see enum task_id).
+ * @return Number of misses since boot, 0 for an invalid task.
+ */
+uint32_t health_get_misses(int task) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return 0;
+    }
+    return health.misses[task];
+}
+
+/**
+ * @brief Check whether every monitored task checked in recently.
+ * @param now_ms Current uptime in ms.
+ * @return true if no monitored task went HEALTH_HEARTBEAT_FACTOR deadlines without checking in.
+ */
+bool health_all_alive(uint32_t now_ms) {
+    for (int i = 0; i < TASK_COUNT; i++) {
+        uint32_t deadline = health.deadline_ms[i];
+
+        if (deadline != 0 && (now_ms - health.last_checkin[i]) > HEALTH_HEARTBEAT_FACTOR * deadline) {
+            return false;
+        }
+    }
+    return true;
+}
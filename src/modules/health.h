@@ -0,0 +1,63 @@
+#ifndef HEALTH_H
+#define HEALTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sched.h"
+
+#define HEALTH_HEARTBEAT_FACTOR 2  /**< A task is stalled after this many deadlines without checking in */
+
+/**
+ * @brief Initialize the health monitor (no task monitored, counters cleared).
+ */
+void health_init(void);
+
+/**
+ * @brief Register (or update) the deadline of a task.
+ * @param task Task identifier (see enum task_id).
+ * @param deadline_ms Relative deadline in ms, 0 to stop monitoring the task.
+ * @param now_ms Current uptime in ms, used as the initial check-in time.
+ */
+void health_set_deadline(int task, uint32_t deadline_ms, uint32_t now_ms);
+
+/**
+ * @brief Signal that a task is alive.
+ * @param task Task identifier (see enum task_id).
+ * @param now_ms Current uptime in ms.
+ */
+void health_checkin(int task, uint32_t now_ms);
+
+/**
+ * @brief Report a finished job: checks its response time against the deadline and checks in.
+ * @param task Task identifier (see enum task_id).
+ * @param response_ms Time from the job release to its end, in ms.
+ * @param now_ms Current uptime in ms.
+ */
+void health_job_done(int task, uint32_t response_ms, uint32_t now_ms);
+
+/**
+ * @brief Count deadline misses detected elsewhere (e.g. timer overruns).
+ * @param task Task identifier (see enum task_id).
+ * @param n Number of missed deadlines.
+ */
+void health_add_misses(int task, uint32_t n);
+
+/**
+ * @brief Get the number of deadline misses of a task.
+ * @param task Task identifier (see enum task_id).
+ * @return Number of misses since boot, 0 for an invalid task.
+ */
+uint32_t health_get_misses(int task);
+
+/**
+ * @brief Check whether every monitored task checked in recently.
+ *
+ * Safe to call from an ISR.
+ *
+ * @param now_ms Current uptime in ms.
+ * @return true if no monitored task went HEALTH_HEARTBEAT_FACTOR deadlines without checking in.
+ */
+bool health_all_alive(uint32_t now_ms);
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ * @file ident.c
+ * @brief Online identification of the thermal plant by recursive least squares.
+ *
+ * The plant is modelled as first order plus dead time: the temperature is
+ * ambient + gain · x, with x the heater power (0 to 1) delayed by the dead
+ * time and passed through a first-order lag of the time constant. For a
+ * given time constant and dead time, x follows from the power alone and
+ * the model is linear in the gain and the ambient, so a two-parameter
+ * recursive least squares estimates them. One such estimator runs for each
+ * candidate pair, on a geometric grid of time constants and every dead
+ * time up to IDENT_DELAYS periods, and the one with the lowest prediction
+ * error wins; the time constant is refined between grid points by a
+ * parabola through the errors of its neighbours.
+ *
+ * Regressing on the power rather than on past temperatures keeps the
+ * whole-degree steps of the TC74 out of the regressors, where they would
+ * bias the time constant short. In closed loop at the setpoint, though,
+ * the best predictor of the sensor is the setpoint itself, so the
+ * estimators learn only while the temperature spread over the last
+ * IDENT_WINDOW periods exceeds a couple of sensor steps: heat-up, setpoint
+ * changes, disturbances and autotune relay tests.
+ *
+ * Temperature and power are averaged over the identification period. Each
+ * estimator keeps two parameters, a 2x2 covariance and its lagged power,
+ * and does one division per update; the exponentials are computed once at
+ * start. All values stay bounded: temperatures in °C, power in 0..1, and
+ * the covariance is not inflated by the forgetting factor above its
+ * initial size.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "ident.h"
+
+#define P_INIT 1000.0f        /**< Initial covariance diagonal: no knowledge of the plant */
+#define P_TRACE_MAX 1000.0f   /**< Covariance trace above which forgetting stops */
+#define EXCITATION_C 2.0f     /**< Temperature spread over the window needed to learn (°C) */
+
+/**
+ * @brief Start the identification with no knowledge of the plant.
+ * @param id Identification state.
+ * @param sample_s Interval between two ident_update() calls (s).
+ * @param period_s Identification period (s), a multiple of sample_s; samples are averaged over it.
+ * @param memory_s Time over which old data fades out (s), at least IDENT_WINDOW periods.
+ */
+void ident_init(struct ident *id, float sample_s, float period_s, float memory_s) {
+    memset(id, 0, sizeof(*id));
+    id->sample_s = sample_s;
+    id->decim = (sample_s > 0.0f && period_s > sample_s) ? (uint16_t)(period_s / sample_s + 0.5f) : 1;
+    id->period_s = id->decim * sample_s;
+    if (memory_s < IDENT_WINDOW * id->period_s) {
+        memory_s = IDENT_WINDOW * id->period_s;
+    }
+    id->lambda = 1.0f - id->period_s / memory_s;
+
+    float tau = IDENT_TAU_MIN_S;
+    for (int i = 0; i < IDENT_TAUS; i++, tau *= IDENT_TAU_RATIO) {
+        id->alpha[i] = expf(-id->period_s / tau);
+        for (int d = 0; d < IDENT_DELAYS; d++) {
+            id->rls[i][d].p[0] = P_INIT;
+            id->rls[i][d].p[2] = P_INIT;
+        }
+    }
+}
+
+/**
+ * @brief One recursive least squares step on T = gain x + ambient. The
+ * prediction error is averaged over the same memory as the estimate, so
+ * that the heat-up still counts when the candidates are compared hours
+ * later, at a limit cycle that a wrong time constant fits as well.
+ */
+static void rls_update(struct ident_rls *r, float temp, float lambda) {
+    float lam = (r->p[0] + r->p[2] < P_TRACE_MAX) ? lambda : 1.0f;
+    float pphi0 = r->p[0] * r->x + r->p[1];
+    float pphi1 = r->p[1] * r->x + r->p[2];
+    float err = temp - r->theta[0] * r->x - r->theta[1];
+    float inv = 1.0f / (lam + r->x * pphi0 + pphi1);
+
+    r->theta[0] += pphi0 * inv * err;
+    r->theta[1] += pphi1 * inv * err;
+
+    //  P = (P - P phi phi' P / den) / lambda
+    r->p[0] = (r->p[0] - pphi0 * pphi0 * inv) / lam;
+    r->p[1] = (r->p[1] - pphi0 * pphi1 * inv) / lam;
+    r->p[2] = (r->p[2] - pphi1 * pphi1 * inv) / lam;
+
+    r->err2 += (1.0f - lambda) * (err * err - r->err2);
+}
+
+/**
+ * @brief Feed one sample of the plant.
+ * @param id Identification state.
+ * @param temp_c Measured temperature (°C).
+ * @param power Heater power applied since the previous sample, 0 to 1.
+ * @return true if an identification period ended and the estimate changed.
+ */
+bool ident_update(struct ident *id, float temp_c, float power) {
+    id->temp_sum += temp_c;
+    id->power_sum += power;
+    if (++id->count < id->decim) {
+        return false;
+    }
+
+    float temp = id->temp_sum / id->count;
+    id->power_hist[id->samples % IDENT_DELAYS] = id->power_sum / id->count;
+    id->temp_hist[id->samples % IDENT_WINDOW] = temp;
+    id->temp_sum = 0.0f;
+    id->power_sum = 0.0f;
+    id->count = 0;
+
+    //  Learn only while the temperature moves by more than the sensor steps
+    float lo = temp, hi = temp;
+    uint32_t n = (id->samples < IDENT_WINDOW) ? id->samples + 1 : IDENT_WINDOW;
+    for (uint32_t k = 0; k < n; k++) {
+        lo = fminf(lo, id->temp_hist[k]);
+        hi = fmaxf(hi, id->temp_hist[k]);
+    }
+    bool excited = (hi - lo > EXCITATION_C);
+
+    for (int i = 0; i < IDENT_TAUS; i++) {
+        float alpha = id->alpha[i];
+        for (int d = 0; d < IDENT_DELAYS; d++) {
+            struct ident_rls *r = &id->rls[i][d];
+            //  Before d periods have passed, the delayed power is the initial 0
+            float u = (id->samples >= (uint32_t)d) ? id->power_hist[(id->samples - d) % IDENT_DELAYS] : 0.0f;
+
+            r->x = alpha * r->x + (1.0f - alpha) * u;
+            if (excited) {
+                rls_update(r, temp, id->lambda);
+            }
+        }
+    }
+
+    id->samples++;
+    id->learnt += excited;
+    return excited;
+}
+
+/**
+ * @brief Current plant model: the candidate that predicts best.
+ * @param id Identification state.
+ * @param est Estimated plant.
+ */
+void ident_estimate(const struct ident *id, struct plant_estimate *est) {
+    int bi = 0, bd = 0;
+
+    for (int i = 0; i < IDENT_TAUS; i++) {
+        for (int d = 0; d < IDENT_DELAYS; d++) {
+            if (id->rls[i][d].err2 < id->rls[bi][bd].err2) {
+                bi = i;
+                bd = d;
+            }
+        }
+    }
+
+    const struct ident_rls *r = &id->rls[bi][bd];
+    float tau = IDENT_TAU_MIN_S * powf(IDENT_TAU_RATIO, (float)bi);
+
+    //  Vertex of the parabola through the errors of the neighbouring time constants
+    if (bi > 0 && bi < IDENT_TAUS - 1) {
+        float lo = id->rls[bi - 1][bd].err2, mid = r->err2, hi = id->rls[bi + 1][bd].err2;
+        float curv = lo - 2.0f * mid + hi;
+        if (curv > 0.0f) {
+            tau *= powf(IDENT_TAU_RATIO, 0.5f * (lo - hi) / curv);
+        }
+    }
+
+    memset(est, 0, sizeof(*est));
+    est->samples = id->learnt;
+    est->rms_c = sqrtf(r->err2);
+    est->valid = (id->learnt >= IDENT_WINDOW) && r->theta[0] > 0.0f;
+    if (est->valid) {
+        est->gain_c = r->theta[0];
+        est->tau_s = tau;
+        est->dead_s = bd * id->period_s;
+        est->ambient_c = r->theta[1];
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef IDENT_H
+#define IDENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define IDENT_DELAYS 8        /**< Dead time candidates, 0 to 7 identification periods */
+#define IDENT_TAUS 12         /**< Time constant candidates, geometric from IDENT_TAU_MIN_S */
+#define IDENT_TAU_MIN_S 5.0f  /**< Shortest time constant candidate (s) */
+#define IDENT_TAU_RATIO 1.5f  /**< Ratio between two time constant candidates */
+#define IDENT_WINDOW 32       /**< Identification periods over which excitation is judged */
+
+/**
+ * @brief Plant model identified online.
+ */
+struct plant_estimate {
+    bool valid;           /**< Enough excitation seen, and the model heats with power */
+    float gain_c;         /**< Temperature rise at full power, in steady state (°C) */
+    float tau_s;          /**< Time constant (s) */
+    float dead_s;         /**< Dead time, in whole identification periods (s) */
+    float ambient_c;      /**< Temperature with the heater off (°C) */
+    float rms_c;          /**< Prediction error of the model (°C rms) */
+    uint32_t samples;     /**< Identification periods learnt from */
+};
+
+/**
+ * @brief Recursive least squares estimate for one time constant and dead time.
+ */
+struct ident_rls {
+    float x;              /**< Heater power through the candidate lag and delay, 0 to 1 */
+    float theta[2];       /**< Gain and ambient of T = gain x + ambient (°C) */
+    float p[3];           /**< Covariance, upper triangle: p00 p01 p11 */
+    float err2;           /**< Mean squared a priori prediction error (°C²) */
+};
+
+/**
+ * @brief Online identification state.
+ */
+struct ident {
+    float sample_s;       /**< Interval between two ident_update() calls the state was built for (s) */
+    float period_s;       /**< Identification period (s) */
+    float lambda;         /**< Forgetting factor */
+    uint16_t decim;       /**< Control periods per identification period */
+    uint16_t count;       /**< Control periods accumulated */
+    float temp_sum;       /**< Temperature accumulated over the identification period */
+    float power_sum;      /**< Heater power accumulated over the identification period */
+    float power_hist[IDENT_DELAYS];  /**< Mean heater power of the last periods (ring) */
+    float temp_hist[IDENT_WINDOW];   /**< Mean temperature of the last periods (ring) */
+    uint32_t samples;     /**< Identification periods processed */
+    uint32_t learnt;      /**< Identification periods with enough excitation */
+    float alpha[IDENT_TAUS];         /**< Per-period decay of each time constant candidate */
+    struct ident_rls rls[IDENT_TAUS][IDENT_DELAYS];  /**< One estimator per candidate */
+};
+
+/**
+ * @brief Start the identification with no knowledge of the plant.
+ * @param id Identification state.
+ * @param sample_s Interval between two ident_update() calls (s).
+ * @param period_s Identification period (s), a multiple of sample_s; samples are averaged over it.
+ * @param memory_s Time over which old data fades out (s), at least IDENT_WINDOW periods.
+ */
+void ident_init(struct ident *id, float sample_s, float period_s, float memory_s);
+
+/**
+ * @brief Feed one sample of the plant.
+ *
+ * Every period_s, passes the mean heater power of the period through the
+ * lag and delay of every candidate and, if the temperature moved enough
+ * over the last IDENT_WINDOW periods, updates their gain and ambient with
+ * the mean temperature. Constant time and memory.
+ *
+ * @param id Identification state.
+ * @param temp_c Measured temperature (°C).
+ * @param power Heater power applied since the previous sample, 0 to 1.
+ * @return true if an identification period ended and the estimate changed.
+ */
+bool ident_update(struct ident *id, float temp_c, float power);
+
+/**
+ * @brief Current plant model: the candidate that predicts best.
+ * @param id Identification state.
+ * @param est Estimated plant.
+ */
+void ident_estimate(const struct ident *id, struct plant_estimate *est);
+
+#endif
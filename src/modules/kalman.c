@@ -0,0 +1,118 @@
+/**
+ * @file kalman.c
+ * @brief Kalman estimator of the plant temperature from the TC74 reads and the heater power.
+ *
+ * The TC74 reports whole degrees, so on its own it tells the controller
+ * nothing about the temperature between two steps, and smoothing the steps
+ * with a filter delays them. The estimator predicts the temperature with
+ * the first order plus dead time model of the plant, driven by the heater
+ * power actually applied, and corrects the prediction with every read by
+ * how much the read is trusted against the model: a heater change shows in
+ * the estimate as soon as the model says it reaches the plant, not when the
+ * sensor has stepped and the filter caught up.
+ *
+ * The second state, the offset, is the temperature the plant would settle
+ * at with the heater off. It starts at the first read, assuming the heater
+ * was off until then, and absorbs the ambient and the errors of the gain,
+ * so a rough model biases nothing in steady state. Two states keep the
+ * filter to a few multiplications and one division per step; the dead time
+ * is a ring of the powers of the last steps.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "kalman.h"
+
+/**
+ * @brief Start the estimator with no measurement yet.
+ * @param k Estimator state.
+ * @param r Measurement noise variance (°C²).
+ * @param q_temp Temperature process noise (°C²/s).
+ * @param q_offset Offset process noise (°C²/s).
+ */
+void kalman_init(struct kalman *k, float r, float q_temp, float q_offset) {
+    memset(k, 0, sizeof(*k));
+    k->r = r;
+    k->q_temp = q_temp;
+    k->q_offset = q_offset;
+}
+
+/**
+ * @brief Set the plant model used by the prediction.
+ * @param k Estimator state.
+ * @param model Plant model.
+ */
+void kalman_set_model(struct kalman *k, const struct plant_estimate *model) {
+    k->gain_c = model->gain_c;
+    k->tau_s = model->tau_s;
+    k->dead_s = model->dead_s;
+}
+
+/**
+ * @brief Advance the estimate by one step of the heater input.
+ * @param k Estimator state.
+ * @param power Heater power applied during the step, 0 to 1.
+ * @param dt Step length (s).
+ */
+void kalman_predict(struct kalman *k, float power, float dt) {
+    uint32_t delay = (dt > 0.0f) ? (uint32_t)(k->dead_s / dt + 0.5f) : 0;
+
+    if (delay >= KALMAN_DELAY_SLOTS) {
+        delay = KALMAN_DELAY_SLOTS - 1;
+    }
+    k->power_hist[k->steps % KALMAN_DELAY_SLOTS] = power;
+    //  Before the dead time has passed, the heater was off
+    float u = (k->steps >= delay) ? k->power_hist[(k->steps - delay) % KALMAN_DELAY_SLOTS] : 0.0f;
+    k->steps++;
+
+    if (!k->started || k->tau_s <= 0.0f) {
+        return;
+    }
+
+    //  x = F x with F = [phi, 1 - phi; 0, 1], plus the heater
+    float phi = expf(-dt / k->tau_s);
+    float psi = 1.0f - phi;
+    k->temp = phi * k->temp + psi * (k->offset + k->gain_c * u);
+
+    //  P = F P F' + Q dt
+    float p00 = phi * phi * k->p[0] + 2.0f * phi * psi * k->p[1] + psi * psi * k->p[2];
+    float p01 = phi * k->p[1] + psi * k->p[2];
+    k->p[0] = p00 + k->q_temp * dt;
+    k->p[1] = p01;
+    k->p[2] += k->q_offset * dt;
+}
+
+/**
+ * @brief Correct the estimate with a measurement.
+ * @param k Estimator state.
+ * @param measured_c Measured temperature (°C).
+ */
+void kalman_correct(struct kalman *k, float measured_c) {
+    if (!k->started) {
+        k->temp = measured_c;
+        k->offset = measured_c;
+        k->p[0] = k->r;
+        k->p[1] = k->r;
+        k->p[2] = k->r;
+        k->started = true;
+        return;
+    }
+
+    //  H = [1, 0]: the sensor reads the temperature
+    float inv = 1.0f / (k->p[0] + k->r);
+    float g0 = k->p[0] * inv;
+    float g1 = k->p[1] * inv;
+    float innov = measured_c - k->temp;
+
+    k->temp += g0 * innov;
+    k->offset += g1 * innov;
+
+    //  P = (I - G H) P
+    k->p[2] -= g1 * k->p[1];
+    k->p[1] -= g0 * k->p[1];
+    k->p[0] -= g0 * k->p[0];
+}
@@ -0,0 +1,81 @@
+#ifndef KALMAN_H
+#define KALMAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ident.h"
+
+#define KALMAN_DELAY_SLOTS 64  /**< Longest dead time, in prediction steps */
+#define KALMAN_R_WHOLE_DEGREE (1.0f / 12.0f)  /**< Variance of rounding to whole degrees (°C²) */
+#define KALMAN_Q_TEMP 0.001f     /**< Default temperature process noise (°C²/s) */
+#define KALMAN_Q_OFFSET 0.0001f  /**< Default offset process noise (°C²/s) */
+
+/**
+ * @brief Kalman estimator of the plant temperature.
+ *
+ * The state is the plant temperature and an offset, the temperature the
+ * plant would settle at with the heater off; the offset takes up the
+ * ambient and the model errors. Covariances are kept as the upper
+ * triangle p00 p01 p11.
+ */
+struct kalman {
+    float gain_c;         /**< Model: temperature rise at full power (°C) */
+    float tau_s;          /**< Model: time constant (s) */
+    float dead_s;         /**< Model: dead time (s) */
+    float r;              /**< Measurement noise variance (°C²) */
+    float q_temp;         /**< Temperature process noise (°C²/s) */
+    float q_offset;       /**< Offset process noise (°C²/s) */
+    float temp;           /**< Estimated temperature (°C) */
+    float offset;         /**< Estimated temperature with the heater off (°C) */
+    float p[3];           /**< Estimate covariance (°C²) */
+    float power_hist[KALMAN_DELAY_SLOTS];  /**< Heater power of the last steps (ring) */
+    uint32_t steps;       /**< Prediction steps taken */
+    bool started;         /**< A measurement has set the estimate */
+};
+
+/**
+ * @brief Start the estimator with no measurement yet.
+ *
+ * The model is set with kalman_set_model(); until then the heater has no
+ * effect on the prediction.
+ *
+ * @param k Estimator state.
+ * @param r Measurement noise variance (°C²); 1/12 for whole-degree reads.
+ * @param q_temp Temperature process noise (°C²/s): how far the plant strays from the model.
+ * @param q_offset Offset process noise (°C²/s): how fast the ambient and the model error drift.
+ */
+void kalman_init(struct kalman *k, float r, float q_temp, float q_offset);
+
+/**
+ * @brief Set the plant model used by the prediction.
+ *
+ * Can be called at any time, e.g. whenever the online identification
+ * publishes a new estimate; the state carries over.
+ *
+ * @param k Estimator state.
+ * @param model Plant model; its gain, time constant and dead time are used.
+ */
+void kalman_set_model(struct kalman *k, const struct plant_estimate *model);
+
+/**
+ * @brief Advance the estimate by one step of the heater input.
+ *
+ * Call at a fixed rate, whether or not a measurement follows.
+ *
+ * @param k Estimator state.
+ * @param power Heater power applied during the step, 0 to 1.
+ * @param dt Step length (s); the dead time is rounded to whole steps, up to KALMAN_DELAY_SLOTS - 1.
+ */
+void kalman_predict(struct kalman *k, float power, float dt);
+
+/**
+ * @brief Correct the estimate with a measurement.
+ *
+ * The first measurement sets the temperature and the offset.
+ *
+ * @param k Estimator state.
+ * @param measured_c Measured temperature (°C).
+ */
+void kalman_correct(struct kalman *k, float measured_c);
+
+#endif
@@ -0,0 +1,61 @@
+#include <zephyr/kernel.h>
+#include <zephyr/linker/linker-defs.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include "memreport.h"
+
+/**
+ * @file memreport.c
+ * @brief Memory usage report (thread stack watermarks and static RAM).
+ *
+ * Stack watermarks come from the thread analyzer stack painting
+ * (CONFIG_INIT_STACKS), so they reflect the deepest use since boot. The
+ * suggested size adds MEMREPORT_MARGIN_PCT percent on top of the watermark.
+ * The per-module static RAM breakdown is produced at build time, in
+ * ram_modules.txt next to zephyr.elf.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#define MEMREPORT_MARGIN_PCT 25  /**< Safety margin added to the stack watermark, in percent */
+
+
+/**
+ * @brief Prints the stack usage of one thread.
+ */
+static void thread_stack_report(const struct k_thread *thread, void *user_data) {
+    size_t unused = 0;
+    size_t size = thread->stack_info.size;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+
+    ARG_UNUSED(user_data);
+
+    if (k_thread_stack_space_get(thread, &unused) != 0) {
+        return;
+    }
+
+    size_t used = size - unused;
+    size_t suggested = ROUND_UP(used + used * MEMREPORT_MARGIN_PCT / 100, 8);
+
+    printk("  %-20s %5u %5u %3u%% %5u\n\r", (name != NULL && name[0] != '\0') ? name : "?",
+           (unsigned)size, (unsigned)used, (unsigned)(size ? used * 100 / size : 0), (unsigned)suggested);
+}
+
+
+/**
+ * @brief Print the memory report on the console.
+ */
+void memreport_print(void) {
+    printk("Thread stacks (bytes):\n\r");
+    printk("  %-20s %5s %5s %4s %5s\n\r", "thread", "size", "used", "", "sugg");
+    k_thread_foreach(thread_stack_report, NULL);
+
+    size_t data = (size_t)(__data_region_end - __data_region_start);
+    size_t bss = (size_t)(__bss_end - __bss_start);
+    size_t noinit = (size_t)(_image_ram_end - _image_ram_start) - data - bss;
+
+    printk("Static RAM (bytes): data %u, bss %u, noinit/kernel objects %u, total %u\n\r",
+           (unsigned)data, (unsigned)bss, (unsigned)noinit, (unsigned)(_image_ram_end - _image_ram_start));
+    printk("Per-module breakdown: ram_modules.txt in the build directory\n\r");
+}
@@ -0,0 +1,13 @@
+#ifndef MEMREPORT_H
+#define MEMREPORT_H
+
+/**
+ * @brief Print the memory report on the console.
+ *
+ * Lists, for every thread, its stack size, the high watermark measured by
+ * the thread analyzer and a suggested size with a safety margin, followed by
+ * the static RAM totals of the image.
+ */
+void memreport_print(void);
+
+#endif
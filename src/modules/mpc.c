@@ -0,0 +1,205 @@
+/**
+ * @file mpc.c
+ * @brief Model-predictive control on a first order plus dead time model.
+ *
+ * A PID only sees the error of now; with a long dead time it keeps
+ * pushing until the heat already on its way shows up, and overshoots. The
+ * MPC predicts the temperature past the dead time from the model, the
+ * outputs already applied and the gap between the measurement and the
+ * model (which takes up the ambient and the model errors, so there is no
+ * offset in steady state), and picks the next MPC_MOVES output moves that
+ * bring MPC_HORIZON points of the prediction closest to the setpoint, with
+ * a penalty on the size of the moves. Only the first move is applied; the
+ * plan is made again every period.
+ *
+ * Without constraints, the least-squares plan is linear in the state, so
+ * its first move is one row of gains: computing them takes a small
+ * MPC_MOVES x MPC_MOVES solve, done only when the model or the period
+ * changes, and every period is then a dot product and a clamp. Clamping
+ * the output, and feeding the clamped output to the model, keeps the
+ * prediction right when the heater saturates, so there is no windup.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "mpc.h"
+
+#define MPC_HORIZON_TAUS 2.0f  /**< Length of the horizon past the dead time, in time constants */
+
+/**
+ * @brief Model pole over a number of periods: a^periods.
+ */
+static float mpc_decay(const struct mpc *m, float periods, float dt) {
+    if (m->tau_s <= 0.0f) {
+        return (periods > 0.0f) ? 0.0f : 1.0f;
+    }
+    return expf(-periods * dt / m->tau_s);
+}
+
+/**
+ * @brief Computes the row of gains of the first move for a period.
+ */
+static void mpc_compute_gains(struct mpc *m, float dt) {
+    const float k = (m->out_max > 0.0f) ? m->gain_c / m->out_max : 0.0f;
+    const int n = MPC_HORIZON;
+    float g[MPC_HORIZON][MPC_MOVES];
+    float h[MPC_MOVES][MPC_MOVES + 1];
+    float row[MPC_HORIZON];
+
+    uint32_t delay = (uint32_t)(m->dead_s / dt + 0.5f);
+    m->delay = (uint16_t)((delay < MPC_DELAY_SLOTS) ? delay : MPC_DELAY_SLOTS - 1);
+    long spacing = lroundf(MPC_HORIZON_TAUS * m->tau_s / (MPC_HORIZON * dt));
+    m->spacing = (uint16_t)((spacing < 1) ? 1 : (spacing > 1000) ? 1000 : spacing);
+    m->a = mpc_decay(m, 1.0f, dt);
+    m->dt = dt;
+    memset(m->gains, 0, sizeof(m->gains));
+
+    if (!(k > 0.0f)) {
+        //  No model: hold the output
+        m->gains[3] = 1.0f;
+        return;
+    }
+
+    //  Step response of each move at each horizon point, past the dead time
+    for (int j = 0; j < n; j++) {
+        for (int l = 0; l < MPC_MOVES; l++) {
+            g[j][l] = (j >= l) ? k * (1.0f - mpc_decay(m, (float)((j + 1 - l) * m->spacing), dt)) : 0.0f;
+        }
+    }
+
+    //  (G'G + w k^2 I) x = e0: x is the first row of its inverse
+    for (int r = 0; r < MPC_MOVES; r++) {
+        for (int c = 0; c < MPC_MOVES; c++) {
+            float sum = (r == c) ? m->move_weight * k * k : 0.0f;
+            for (int j = 0; j < n; j++) {
+                sum += g[j][r] * g[j][c];
+            }
+            h[r][c] = sum;
+        }
+        h[r][MPC_MOVES] = (r == 0) ? 1.0f : 0.0f;
+    }
+    for (int p = 0; p < MPC_MOVES; p++) {
+        //  Symmetric positive definite: no pivoting needed
+        for (int r = p + 1; r < MPC_MOVES; r++) {
+            float f = h[r][p] / h[p][p];
+            for (int c = p; c <= MPC_MOVES; c++) {
+                h[r][c] -= f * h[p][c];
+            }
+        }
+    }
+    float x[MPC_MOVES];
+    for (int r = MPC_MOVES - 1; r >= 0; r--) {
+        float sum = h[r][MPC_MOVES];
+        for (int c = r + 1; c < MPC_MOVES; c++) {
+            sum -= h[r][c] * x[c];
+        }
+        x[r] = sum / h[r][r];
+    }
+
+    //  First move = row . (setpoint - free prediction)
+    for (int j = 0; j < n; j++) {
+        row[j] = 0.0f;
+        for (int l = 0; l < MPC_MOVES; l++) {
+            row[j] += x[l] * g[j][l];
+        }
+    }
+
+    //  Free prediction at point j, (j + 1) x spacing periods past the dead time:
+    //  measured + (a^h - 1) model + outputs in the dead time + last output held
+    for (int j = 0; j < n; j++) {
+        float past = (float)((j + 1) * m->spacing);
+
+        m->gains[0] += row[j];
+        m->gains[1] -= row[j];
+        m->gains[2] -= row[j] * (mpc_decay(m, past + m->delay, dt) - 1.0f);
+        for (int i = 1; i <= m->delay; i++) {
+            m->gains[2 + i] -= row[j] * k * (1.0f - m->a) * mpc_decay(m, past - 1.0f + i, dt);
+        }
+        m->gains[3] -= row[j] * k * (1.0f - mpc_decay(m, past, dt));
+    }
+    //  The move adds to the last output
+    m->gains[3] += 1.0f;
+}
+
+/**
+ * @brief Start the controller with the heater off and no model.
+ * @param m Controller state.
+ */
+void mpc_init(struct mpc *m) {
+    memset(m, 0, sizeof(*m));
+    m->settle = true;
+}
+
+/**
+ * @brief Set the plant model and the tuning.
+ * @param m Controller state.
+ * @param model Plant model.
+ * @param out_max Output for full power.
+ * @param move_weight Weight of the output moves.
+ */
+void mpc_set_model(struct mpc *m, const struct plant_estimate *model, float out_max, float move_weight) {
+    if (model->gain_c != m->gain_c || model->tau_s != m->tau_s || model->dead_s != m->dead_s ||
+        out_max != m->out_max || move_weight != m->move_weight) {
+        m->gain_c = model->gain_c;
+        m->tau_s = model->tau_s;
+        m->dead_s = model->dead_s;
+        m->out_max = out_max;
+        m->move_weight = move_weight;
+        m->dt = 0.0f;
+    }
+}
+
+/**
+ * @brief Take over the loop from another controller without a kick.
+ * @param m Controller state.
+ * @param output Last output of the loop.
+ */
+void mpc_reset(struct mpc *m, float output) {
+    for (int i = 0; i < MPC_DELAY_SLOTS; i++) {
+        m->hist[i] = output;
+    }
+    m->settle = true;
+}
+
+/**
+ * @brief Calculates the MPC output.
+ * @param m Controller state.
+ * @param setpoint The desired value (°C).
+ * @param measured The current measured value (°C).
+ * @param dt Control period in seconds.
+ * @return The output, 0 to out_max.
+ */
+float mpc_calculate(struct mpc *m, float setpoint, float measured, float dt) {
+    const uint32_t mask = MPC_DELAY_SLOTS - 1;
+    const uint32_t k = m->steps;
+
+    if (dt <= 0.0f) {
+        return m->hist[(k - 1) & mask];
+    }
+    if (m->dt != dt) {
+        mpc_compute_gains(m, dt);
+    }
+    const float gain = (m->out_max > 0.0f) ? m->gain_c / m->out_max : 0.0f;
+    if (m->settle) {
+        m->model = gain * m->hist[(k - 1) & mask];
+        m->settle = false;
+    }
+
+    //  One row of gains times (setpoint, measured, model, outputs of the dead time)
+    float u = m->gains[0] * setpoint + m->gains[1] * measured + m->gains[2] * m->model;
+    for (uint32_t i = 1; i <= ((m->delay > 0) ? m->delay : 1u); i++) {
+        u += m->gains[2 + i] * m->hist[(k - i) & mask];
+    }
+    if (u > m->out_max) u = m->out_max;
+    if (u < 0.0f) u = 0.0f;
+
+    //  The model follows the clamped output, delayed by the dead time
+    m->hist[k & mask] = u;
+    m->model = m->a * m->model + (1.0f - m->a) * gain * m->hist[(k - m->delay) & mask];
+    m->steps++;
+    return u;
+}
@@ -0,0 +1,86 @@
+#ifndef MPC_H
+#define MPC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ident.h"
+
+#define MPC_HORIZON 8         /**< Points of the predicted temperature compared with the setpoint */
+#define MPC_MOVES 3           /**< Output moves planned over the horizon */
+#define MPC_DELAY_SLOTS 64    /**< Longest dead time, in control periods; a power of two */
+#define MPC_STATE (3 + MPC_DELAY_SLOTS)  /**< Setpoint, measurement, model temperature and past outputs */
+#define MPC_MOVE_WEIGHT 10.0f /**< Default weight of the output moves */
+
+/**
+ * @brief Model-predictive controller on a first order plus dead time model.
+ *
+ * Without constraints, the first optimal move is a fixed linear function
+ * of the setpoint, the measurement, the model temperature and the outputs
+ * still in the dead time, so the whole optimisation reduces to one row of
+ * gains, computed again only when the model or the period changes.
+ */
+struct mpc {
+    float gain_c;         /**< Model: temperature rise at full power (°C) */
+    float tau_s;          /**< Model: time constant (s) */
+    float dead_s;         /**< Model: dead time (s) */
+    float out_max;        /**< Output for full power */
+    float move_weight;    /**< Weight of the output moves against the errors */
+    float dt;             /**< Period the gains are computed for, 0 to compute them again */
+    float a;              /**< Model pole over one period */
+    uint16_t delay;       /**< Dead time, in whole periods */
+    uint16_t spacing;     /**< Periods between two horizon points, and between two moves */
+    float gains[MPC_STATE];  /**< Next output = gains x (setpoint, measured, model, past outputs) */
+    float model;          /**< Model temperature rise over the heater-off temperature (°C) */
+    float hist[MPC_DELAY_SLOTS];  /**< Outputs of the last periods (ring) */
+    uint32_t steps;       /**< Periods run */
+    bool settle;          /**< Start the model in steady state at the next period */
+};
+
+/**
+ * @brief Start the controller with the heater off and no model.
+ * @param m Controller state.
+ */
+void mpc_init(struct mpc *m);
+
+/**
+ * @brief Set the plant model and the tuning.
+ *
+ * The gains are computed again at the next mpc_calculate() only if
+ * something changed, so this can be called every period.
+ *
+ * @param m Controller state.
+ * @param model Plant model; its gain, time constant and dead time are used.
+ * @param out_max Output for full power; the output is clamped to 0..out_max.
+ * @param move_weight Weight of the output moves: higher is gentler, lower is faster.
+ */
+void mpc_set_model(struct mpc *m, const struct plant_estimate *model, float out_max, float move_weight);
+
+/**
+ * @brief Take over the loop from another controller without a kick.
+ *
+ * The output carries on from the last one, and the model starts in
+ * steady state with it at the next period.
+ *
+ * @param m Controller state.
+ * @param output Last output of the loop.
+ */
+void mpc_reset(struct mpc *m, float output);
+
+/**
+ * @brief Calculates the MPC output.
+ *
+ * Predicts the temperature over the horizon from the model, corrected by
+ * the gap between the measurement and the model, plans the output moves
+ * that best bring it to the setpoint and applies the first one, clamped
+ * to 0..out_max. With the gains computed, a period is one row of gains
+ * times the state and a clamp.
+ *
+ * @param m Controller state, with a model set.
+ * @param setpoint The desired value (°C).
+ * @param measured The current measured value (°C).
+ * @param dt Control period in seconds; the gains follow it if it changes.
+ * @return The output, 0 to out_max.
+ */
+float mpc_calculate(struct mpc *m, float setpoint, float measured, float dt);
+
+#endif
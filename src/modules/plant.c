@@ -0,0 +1,122 @@
+/**
+ * @file plant.c
+ * @brief First-order-plus-dead-time thermal model of the heated plant.
+ *
+ * dT/dt = (ambient + gain * u(t - dead) - T) / tau, with u the heater
+ * power in ‰. Used by the TC74 emulator on native_sim and by the host
+ * simulations, so both see the same plant.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "plant.h"
+
+/**
+ * @brief Applies the exact first-order response to the acting input for dt_ms.
+ */
+static void plant_advance(struct plant *p, uint64_t dt_ms) {
+    if (dt_ms == 0) {
+        return;
+    }
+
+    float target = p->params.ambient_mdeg + (float)p->params.gain_mdeg * p->applied / 1000.0f;
+    if (p->params.tau_ms == 0) {
+        p->temp_mdeg = target;
+    } else {
+        p->temp_mdeg = target + (p->temp_mdeg - target) * expf(-(float)dt_ms / p->params.tau_ms);
+    }
+    p->now_ms += dt_ms;
+}
+
+/**
+ * @brief Makes the oldest pending input change act on the plant.
+ */
+static void plant_pop_event(struct plant *p) {
+    p->applied = p->events[p->head].input;
+    p->head = (p->head + 1) % PLANT_MAX_EVENTS;
+    p->count--;
+}
+
+/**
+ * @brief Initialize the model at ambient temperature with the heater off.
+ * @param p Model state.
+ * @param params Model parameters (copied).
+ */
+void plant_init(struct plant *p, const struct plant_params *params) {
+    memset(p, 0, sizeof(*p));
+    p->params = *params;
+    p->temp_mdeg = params->ambient_mdeg;
+}
+
+/**
+ * @brief Set the heater power from the current model time on.
+ * @param p Model state.
+ * @param permille Heater power in ‰ of full power (0 = off, 1000 = on).
+ */
+void plant_set_input(struct plant *p, uint16_t permille) {
+    if (permille > 1000) {
+        permille = 1000;
+    }
+    if (permille == p->input) {
+        return;
+    }
+    p->input = permille;
+
+    //  Out of slots: let the oldest change act early rather than lose it
+    if (p->count == PLANT_MAX_EVENTS) {
+        plant_pop_event(p);
+    }
+
+    int tail = (p->head + p->count) % PLANT_MAX_EVENTS;
+    p->events[tail].at_ms = p->now_ms;
+    p->events[tail].input = permille;
+    p->count++;
+}
+
+/**
+ * @brief Advance the model.
+ *
+ * The exact first-order response is applied between input changes, so
+ * the result does not depend on how dt_ms is split.
+ *
+ * @param p Model state.
+ * @param dt_ms Time to advance (ms).
+ */
+void plant_step(struct plant *p, uint32_t dt_ms) {
+    uint64_t end = p->now_ms + dt_ms;
+
+    while (p->now_ms < end) {
+        uint64_t next = end;
+
+        if (p->count > 0) {
+            uint64_t effective = p->events[p->head].at_ms + p->params.dead_ms;
+            if (effective <= p->now_ms) {
+                plant_pop_event(p);
+                continue;
+            }
+            if (effective < next) {
+                next = effective;
+            }
+        }
+
+        plant_advance(p, next - p->now_ms);
+    }
+
+    //  Changes due exactly at the end act from now on
+    while (p->count > 0 && p->events[p->head].at_ms + p->params.dead_ms <= p->now_ms) {
+        plant_pop_event(p);
+    }
+}
+
+/**
+ * @brief Get the current temperature.
+ * @param p Model state.
+ * @return Temperature in m°C.
+ */
+int32_t plant_temp_mdeg(const struct plant *p) {
+    return (int32_t)lroundf(p->temp_mdeg);
+}
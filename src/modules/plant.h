@@ -0,0 +1,67 @@
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <stdint.h>
+
+#define PLANT_MAX_EVENTS 64  /**< Input changes that can be waiting out the dead time */
+
+/**
+ * @brief First-order-plus-dead-time (FOPDT) thermal model parameters.
+ */
+struct plant_params {
+    int32_t ambient_mdeg;  /**< Temperature with the heater off (m°C) */
+    int32_t gain_mdeg;     /**< Steady-state rise above ambient at full power (m°C) */
+    uint32_t tau_ms;       /**< Time constant (ms) */
+    uint32_t dead_ms;      /**< Dead time between an input change and its first effect (ms) */
+};
+
+/**
+ * @brief FOPDT thermal model state.
+ */
+struct plant {
+    struct plant_params params;       /**< Model parameters */
+    float temp_mdeg;                  /**< Current temperature (m°C) */
+    uint64_t now_ms;                  /**< Model time (ms) */
+    uint16_t input;                   /**< Last input set (‰ of full power) */
+    uint16_t applied;                 /**< Input currently acting, after the dead time (‰) */
+    uint8_t head;                     /**< Oldest pending input change */
+    uint8_t count;                    /**< Pending input changes */
+    struct {
+        uint64_t at_ms;               /**< Model time of the change */
+        uint16_t input;               /**< New input (‰) */
+    } events[PLANT_MAX_EVENTS];       /**< Input changes still within the dead time */
+};
+
+/**
+ * @brief Initialize the model at ambient temperature with the heater off.
+ * @param p Model state.
+ * @param params Model parameters (copied).
+ */
+void plant_init(struct plant *p, const struct plant_params *params);
+
+/**
+ * @brief Set the heater power from the current model time on.
+ * @param p Model state.
+ * @param permille Heater power in ‰ of full power (0 = off, 1000 = on).
+ */
+void plant_set_input(struct plant *p, uint16_t permille);
+
+/**
+ * @brief Advance the model.
+ *
+ * The exact first-order response is applied between input changes, so
+ * the result does not depend on how dt_ms is split.
+ *
+ * @param p Model state.
+ * @param dt_ms Time to advance (ms).
+ */
+void plant_step(struct plant *p, uint32_t dt_ms);
+
+/**
+ * @brief Get the current temperature.
+ * @param p Model state.
+ * @return Temperature in m°C.
+ */
+int32_t plant_temp_mdeg(const struct plant *p);
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file profile.c
+ * @brief Setpoint profile executor: ramps and holds run on the clock.
+ *
+ * A profile is a list of segments, each a ramp to a target temperature at
+ * a given rate followed by a hold at that target, as in the ramp/soak
+ * programs of process controllers. The executor turns it into a setpoint
+ * that changes smoothly every control period, so the host no longer has to
+ * stream #M commands through every ramp. The ramp position is computed
+ * from the start of the segment rather than accumulated step by step, so
+ * the setpoint lands on the targets exactly however long the profile runs.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "profile.h"
+
+#define PROFILE_RAMP_MAX_MS 4.0e9f  /**< Longest ramp, within a uint32_t of ms */
+
+/**
+ * @brief Check a profile before it is used.
+ * @param prog Profile.
+ * @return 0 if valid, -1 otherwise.
+ */
+int profile_check(const struct profile *prog) {
+    if (prog->count > PROFILE_MAX) {
+        return -1;
+    }
+    for (int i = 0; i < prog->count; i++) {
+        if (!(prog->segments[i].rate >= 0.0f)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Start a profile from its first segment.
+ * @param r Executor state.
+ * @param prog Valid profile.
+ * @param start_c Setpoint at the start (°C).
+ * @param now_ms Clock (ms).
+ */
+void profile_start(struct profile_run *r, const struct profile *prog, float start_c, uint32_t now_ms) {
+    memset(r, 0, sizeof(*r));
+    r->prog = *prog;
+    r->from_c = start_c;
+    r->last_ms = now_ms;
+    r->status.state = PROFILE_RUNNING;
+    r->status.setpoint_c = start_c;
+}
+
+/**
+ * @brief Freeze the setpoint and the clock of a running profile.
+ * @param r Executor state.
+ */
+void profile_pause(struct profile_run *r) {
+    if (r->status.state == PROFILE_RUNNING) {
+        r->status.state = PROFILE_PAUSED;
+    }
+}
+
+/**
+ * @brief Go on with a paused profile.
+ * @param r Executor state.
+ * @param now_ms Clock (ms).
+ */
+void profile_resume(struct profile_run *r, uint32_t now_ms) {
+    if (r->status.state == PROFILE_PAUSED) {
+        r->status.state = PROFILE_RUNNING;
+        r->last_ms = now_ms;
+    }
+}
+
+/**
+ * @brief Stop the profile, leaving the setpoint where it is.
+ * @param r Executor state.
+ */
+void profile_stop(struct profile_run *r) {
+    r->status.state = PROFILE_IDLE;
+    r->status.remaining_ms = 0;
+}
+
+/**
+ * @brief Advance a running profile to the clock.
+ * @param r Executor state.
+ * @param now_ms Clock (ms).
+ * @return Setpoint (°C).
+ */
+float profile_update(struct profile_run *r, uint32_t now_ms) {
+    struct profile_status *s = &r->status;
+
+    if (s->state != PROFILE_RUNNING) {
+        return s->setpoint_c;
+    }
+    uint32_t left = now_ms - r->last_ms;
+    r->last_ms = now_ms;
+
+    while (s->segment < r->prog.count) {
+        const struct profile_segment *seg = &r->prog.segments[s->segment];
+
+        if (!s->holding) {
+            float gap = seg->target_c - r->from_c;
+            uint32_t ramp_ms = (seg->rate > 0.0f) ?
+                               (uint32_t)fminf(fabsf(gap) / seg->rate * 60000.0f + 0.5f, PROFILE_RAMP_MAX_MS) : 0;
+
+            if (left < ramp_ms - r->phase_ms) {
+                r->phase_ms += left;
+                s->setpoint_c = r->from_c + copysignf(seg->rate * r->phase_ms / 60000.0f, gap);
+                s->remaining_ms = ramp_ms - r->phase_ms;
+                return s->setpoint_c;
+            }
+            //  Target reached: the rest of the time goes to the hold
+            left -= ramp_ms - r->phase_ms;
+            s->setpoint_c = seg->target_c;
+            s->holding = true;
+            r->phase_ms = 0;
+        }
+
+        if (left < seg->hold_ms - r->phase_ms) {
+            r->phase_ms += left;
+            s->remaining_ms = seg->hold_ms - r->phase_ms;
+            return s->setpoint_c;
+        }
+        left -= seg->hold_ms - r->phase_ms;
+        r->from_c = seg->target_c;
+        r->phase_ms = 0;
+        s->holding = false;
+        s->segment++;
+    }
+
+    s->state = PROFILE_DONE;
+    s->remaining_ms = 0;
+    return s->setpoint_c;
+}
@@ -0,0 +1,122 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROFILE_MAX 8     /**< Most segments in a setpoint profile */
+
+/**
+ * @brief Profile progress, in the order of the #O status digit.
+ */
+enum profile_state {
+    PROFILE_IDLE,           /**< Never started, or stopped */
+    PROFILE_RUNNING,        /**< Ramping or holding */
+    PROFILE_PAUSED,         /**< Setpoint and time frozen until resumed */
+    PROFILE_DONE,           /**< Last hold over; the setpoint stays at the last target */
+};
+
+/**
+ * @brief Start, pause, resume and stop requests, passed from the command processor to the controller.
+ */
+enum profile_request {
+    PROFILE_REQ_NONE,       /**< Nothing to do */
+    PROFILE_REQ_START,      /**< Start (or restart) the uploaded profile from its first segment */
+    PROFILE_REQ_PAUSE,      /**< Freeze the setpoint and the clock of the profile */
+    PROFILE_REQ_RESUME,     /**< Go on from where it was paused */
+    PROFILE_REQ_STOP,       /**< Stop, leaving the setpoint where it is */
+};
+
+/**
+ * @brief Ramp to a target, then hold it.
+ */
+struct profile_segment {
+    float rate;             /**< Ramp rate (°C/min), 0 to step to the target */
+    float target_c;         /**< Temperature at the end of the ramp (°C) */
+    uint32_t hold_ms;       /**< Time held at the target */
+};
+
+/**
+ * @brief Setpoint profile: segments run in order.
+ */
+struct profile {
+    uint8_t count;          /**< Segments in use, 0 to PROFILE_MAX */
+    struct profile_segment segments[PROFILE_MAX];  /**< Segments */
+};
+
+/**
+ * @brief Profile progress, as published in the RTDB.
+ */
+struct profile_status {
+    uint8_t state;          /**< enum profile_state */
+    uint8_t segment;        /**< Segment running */
+    bool holding;           /**< The segment has reached its target and is holding it */
+    float setpoint_c;       /**< Setpoint (°C) */
+    uint32_t remaining_ms;  /**< Time left to the end of the ramp or of the hold */
+};
+
+/**
+ * @brief Profile executor state.
+ */
+struct profile_run {
+    struct profile prog;           /**< Copy of the profile taken at the start */
+    struct profile_status status;  /**< Progress */
+    float from_c;                  /**< Setpoint at the start of the segment (°C) */
+    uint32_t phase_ms;             /**< Time into the ramp or the hold of the segment */
+    uint32_t last_ms;              /**< Clock at the last update */
+};
+
+/**
+ * @brief Check a profile before it is used.
+ * @param prog Profile.
+ * @return 0 if valid, -1 if it has too many segments or a negative rate.
+ */
+int profile_check(const struct profile *prog);
+
+/**
+ * @brief Start a profile from its first segment.
+ *
+ * The first ramp starts from start_c, normally the current temperature,
+ * so the setpoint does not step at the start.
+ *
+ * @param r Executor state.
+ * @param prog Valid profile; copied, so it can be replaced while it runs.
+ * @param start_c Setpoint at the start (°C).
+ * @param now_ms Clock (ms).
+ */
+void profile_start(struct profile_run *r, const struct profile *prog, float start_c, uint32_t now_ms);
+
+/**
+ * @brief Freeze the setpoint and the clock of a running profile.
+ * @param r Executor state.
+ */
+void profile_pause(struct profile_run *r);
+
+/**
+ * @brief Go on with a paused profile; the time it was paused is not counted.
+ * @param r Executor state.
+ * @param now_ms Clock (ms).
+ */
+void profile_resume(struct profile_run *r, uint32_t now_ms);
+
+/**
+ * @brief Stop the profile, leaving the setpoint where it is.
+ * @param r Executor state.
+ */
+void profile_stop(struct profile_run *r);
+
+/**
+ * @brief Advance a running profile to the clock.
+ *
+ * Moves the setpoint towards the target of the segment at its ramp rate,
+ * then holds the target, then goes on to the next segment; time left over
+ * at the end of a ramp or hold carries into the next one, so the profile
+ * does not drift however often it is updated. Does nothing unless running.
+ *
+ * @param r Executor state.
+ * @param now_ms Clock (ms); wraps around.
+ * @return Setpoint (°C).
+ */
+float profile_update(struct profile_run *r, uint32_t now_ms);
+
+#endif
@@ -1,4 +1,10 @@
+#include <string.h>
 #include "rtdb.h"
+#include "sched.h"
+#if defined(CONFIG_APP_RTDB_SEQLOCK) || defined(CONFIG_APP_RTDB_ATOMIC)
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#endif
 
 /**
  * @file rtdb.c
@@ -9,7 +15,11 @@
  * - Temperatura desejada
  * - Temperatura atual (medida)
  *
- * Todos os acessos são protegidos por `k_mutex`, garantindo integridade em ambiente multitarefa.
+ * Cada grupo de variáveis tem o seu lock. Por omissão é um `k_mutex`; com
+ * CONFIG_APP_RTDB_SEQLOCK é um seqlock (os leitores nunca bloqueiam e repetem
+ * a leitura se um escritor a interrompeu) e com CONFIG_APP_RTDB_ATOMIC as
+ * variáveis de uma só palavra passam a operações atómicas, ficando os grupos
+ * (parâmetros PID, latência, estado do sensor) em seqlock.
  * Fornece funções `get` e `set` para abstrair o acesso concorrente aos dados.
  * \author Pedro Ramos, n.º 107348
  * \author Rafael Morgado, n.º 104277
@@ -17,21 +27,118 @@
  */
 
 
-static struct {
-    bool system_on;
-    int desired_temp;
+#if defined(CONFIG_APP_RTDB_SEQLOCK) || defined(CONFIG_APP_RTDB_ATOMIC)
+/**
+ * @brief Sequence lock: writers are serialised by a spinlock and make the
+ * sequence odd while they update the group; readers copy the group and
+ * retry if the sequence was odd or changed meanwhile.
+ *
+ * The spinlock also masks interrupts on a single CPU, so a reader can never
+ * preempt a half-finished write and spin on it.
+ */
+struct rtdb_lock {
+    atomic_t seq;
+    struct k_spinlock wlock;
+};
+
+#define RTDB_LOCK_INIT(l) atomic_set(&(l).seq, 0)
+
+#define RTDB_WRITE(l, ...)                                      \
+    do {                                                        \
+        k_spinlock_key_t key_ = k_spin_lock(&(l).wlock);        \
+        atomic_inc(&(l).seq);                                   \
+        __VA_ARGS__;                                            \
+        atomic_inc(&(l).seq);                                   \
+        k_spin_unlock(&(l).wlock, key_);                        \
+    } while (0)
+
+#define RTDB_READ(l, ...)                                       \
+    do {                                                        \
+        atomic_val_t seq_;                                      \
+        do {                                                    \
+            while ((seq_ = atomic_get(&(l).seq)) & 1) {         \
+            }                                                   \
+            __VA_ARGS__;                                        \
+            barrier_dmem_fence_full();                          \
+        } while (atomic_get(&(l).seq) != seq_);                 \
+    } while (0)
+#else
+/** @brief Mutex per group of variables. */
+struct rtdb_lock {
+    struct k_mutex mutex;
+};
+
+#define RTDB_LOCK_INIT(l) k_mutex_init(&(l).mutex)
+
+#define RTDB_WRITE(l, ...)                                      \
+    do {                                                        \
+        k_mutex_lock(&(l).mutex, K_FOREVER);                    \
+        __VA_ARGS__;                                            \
+        k_mutex_unlock(&(l).mutex);                             \
+    } while (0)
+
+#define RTDB_READ(l, ...) RTDB_WRITE(l, __VA_ARGS__)
+#endif
+
+#if defined(CONFIG_APP_RTDB_ATOMIC)
+/* Single-word variables need no lock at all */
+#define RTDB_SCALAR(type) atomic_t
+#define RTDB_STORE(l, field, val) atomic_set(&(field), (atomic_val_t)(val))
+#define RTDB_LOAD(l, field, out) ((out) = atomic_get(&(field)))
+#else
+#define RTDB_SCALAR(type) type
+#define RTDB_STORE(l, field, val) RTDB_WRITE(l, (field) = (val))
+#define RTDB_LOAD(l, field, out) RTDB_READ(l, (out) = (field))
+#endif
+
+
+/* Host tools running several simulations in parallel give each thread its own RTDB */
+#ifndef RTDB_STORAGE
+#define RTDB_STORAGE static
+#endif
+
+RTDB_STORAGE struct {
+    RTDB_SCALAR(bool) system_on;
+    RTDB_SCALAR(int32_t) desired_temp_mdeg;
     int current_temp;
-    bool heat_on;
+    int32_t current_temp_mdeg;
+    int32_t estimated_temp_mdeg;
+    RTDB_SCALAR(bool) heat_on;
+    RTDB_SCALAR(uint16_t) heat_duty;
     float kp;
     float ki;
     float kd;
-    bool verbose;
-    struct k_mutex lockSysOn;
-    struct k_mutex lockDesTemp;
-    struct k_mutex lockCurrTemp;
-    struct k_mutex lockHeatOn;
-    struct k_mutex lockPIDparams;
-    struct k_mutex lockVerbose;
+    struct gain_schedule schedule;
+    uint32_t schedule_gen;
+    RTDB_SCALAR(uint8_t) controller;
+    RTDB_SCALAR(bool) verbose;
+    uint32_t latency_last;
+    uint32_t latency_max;
+    uint64_t latency_sum;
+    uint32_t latency_count;
+    RTDB_SCALAR(uint32_t) task_period[TASK_COUNT];
+    struct rtdb_sensor_status sensor;
+    struct governor_stats switching;
+    uint8_t autotune_req;
+    struct autotune_status autotune;
+    struct plant_estimate plant;
+    struct profile profile;
+    uint8_t profile_req;
+    struct profile_status profile_status;
+    struct rtdb_lock lockSysOn;
+    struct rtdb_lock lockDesTemp;
+    struct rtdb_lock lockCurrTemp;
+    struct rtdb_lock lockHeatOn;
+    struct rtdb_lock lockPIDparams;
+    struct rtdb_lock lockSchedule;
+    struct rtdb_lock lockVerbose;
+    struct rtdb_lock lockLatency;
+    struct rtdb_lock lockPeriods;
+    struct rtdb_lock lockSensor;
+    struct rtdb_lock lockSwitching;
+    struct rtdb_lock lockAutotune;
+    struct rtdb_lock lockPlant;
+    struct rtdb_lock lockProfile;
     //  TODO: talk advantages of having one lock for each (multiple acesses to rtdb)
 } db;
 
@@ -40,17 +147,40 @@ static struct {
  */
 void rtdb_init(void) {
     db.system_on = false;
-    db.desired_temp = 28;
+    db.desired_temp_mdeg = 28000;
     db.current_temp = 28;
+    db.current_temp_mdeg = 28000;
+    db.estimated_temp_mdeg = 28000;
     db.heat_on = false;
+    db.heat_duty = 0;
+    db.sensor.ok = false;
+    memset(&db.switching, 0, sizeof(db.switching));
+    db.autotune_req = AUTOTUNE_REQ_NONE;
+    memset(&db.autotune, 0, sizeof(db.autotune));
+    memset(&db.plant, 0, sizeof(db.plant));
+    memset(&db.profile, 0, sizeof(db.profile));
+    db.profile_req = PROFILE_REQ_NONE;
+    memset(&db.profile_status, 0, sizeof(db.profile_status));
     db.kp = 2.0f;
     db.ki = 0.1f;
     db.kd = 0.05f;
-    k_mutex_init(&db.lockSysOn);
-    k_mutex_init(&db.lockDesTemp);
-    k_mutex_init(&db.lockCurrTemp);
-    k_mutex_init(&db.lockHeatOn);
-    k_mutex_init(&db.lockPIDparams);
+    memset(&db.schedule, 0, sizeof(db.schedule));
+    db.schedule_gen = 0;
+    db.controller = CONTROLLER_PID;
+    RTDB_LOCK_INIT(db.lockSysOn);
+    RTDB_LOCK_INIT(db.lockDesTemp);
+    RTDB_LOCK_INIT(db.lockCurrTemp);
+    RTDB_LOCK_INIT(db.lockHeatOn);
+    RTDB_LOCK_INIT(db.lockPIDparams);
+    RTDB_LOCK_INIT(db.lockSchedule);
+    RTDB_LOCK_INIT(db.lockVerbose);
+    RTDB_LOCK_INIT(db.lockLatency);
+    RTDB_LOCK_INIT(db.lockPeriods);
+    RTDB_LOCK_INIT(db.lockSensor);
+    RTDB_LOCK_INIT(db.lockSwitching);
+    RTDB_LOCK_INIT(db.lockAutotune);
+    RTDB_LOCK_INIT(db.lockPlant);
+    RTDB_LOCK_INIT(db.lockProfile);
 }
 
 /**
@@ -58,9 +188,7 @@ void rtdb_init(void) {
  * @param on true to turn system on, false to turn it off.
  */
 void rtdb_set_system_on(bool on) {
-    k_mutex_lock(&db.lockSysOn, K_FOREVER);
-    db.system_on = on;
-    k_mutex_unlock(&db.lockSysOn);
+    RTDB_STORE(db.lockSysOn, db.system_on, on);
 }
 
 
@@ -69,9 +197,8 @@ void rtdb_set_system_on(bool on) {
  * @return true if system is on, false otherwise.
  */
 bool rtdb_get_system_on(void) {
-    k_mutex_lock(&db.lockSysOn, K_FOREVER);
-    bool on = db.system_on;
-    k_mutex_unlock(&db.lockSysOn);
+    bool on;
+    RTDB_LOAD(db.lockSysOn, db.system_on, on);
     return on;
 }
 
@@ -80,20 +207,35 @@ bool rtdb_get_system_on(void) {
  * @param temp Desired temperature in °C.
  */
 void rtdb_set_desired_temp(int temp) {
-    k_mutex_lock(&db.lockDesTemp, K_FOREVER);
-    db.desired_temp = temp;
-    k_mutex_unlock(&db.lockDesTemp);
+    RTDB_STORE(db.lockDesTemp, db.desired_temp_mdeg, (int32_t)temp * 1000);
 }
 
 /**
  * @brief Get desired temperature.
- * @return Desired temperature in °C.
+ * @return Desired temperature in °C, rounded to the nearest degree.
  */
 int rtdb_get_desired_temp(void) {
-    k_mutex_lock(&db.lockDesTemp, K_FOREVER);
-    int temp = db.desired_temp;
-    k_mutex_unlock(&db.lockDesTemp);
-    return temp;
+    int32_t mdeg;
+    RTDB_LOAD(db.lockDesTemp, db.desired_temp_mdeg, mdeg);
+    return (mdeg >= 0) ? (mdeg + 500) / 1000 : (mdeg - 500) / 1000;
+}
+
+/**
+ * @brief Set desired temperature with sub-degree precision.
+ * @param mdeg Desired temperature in m°C.
+ */
+void rtdb_set_desired_temp_mdeg(int32_t mdeg) {
+    RTDB_STORE(db.lockDesTemp, db.desired_temp_mdeg, mdeg);
+}
+
+/**
+ * @brief Get desired temperature with sub-degree precision.
+ * @return Desired temperature in m°C.
+ */
+int32_t rtdb_get_desired_temp_mdeg(void) {
+    int32_t mdeg;
+    RTDB_LOAD(db.lockDesTemp, db.desired_temp_mdeg, mdeg);
+    return mdeg;
 }
 
 /**
@@ -101,9 +243,33 @@ int rtdb_get_desired_temp(void) {
  * @param temp Current temperature in °C.
  */
 void rtdb_set_current_temp(int temp) {
-    k_mutex_lock(&db.lockCurrTemp, K_FOREVER);
-    db.current_temp = temp;
-    k_mutex_unlock(&db.lockCurrTemp);
+    RTDB_WRITE(db.lockCurrTemp,
+        db.current_temp = temp;
+        db.current_temp_mdeg = temp * 1000);
+}
+
+/**
+ * @brief Set current temperature with sub-degree precision.
+ *
+ * Also updates the whole-degree value, rounded to the nearest degree.
+ * @param mdeg Current temperature in m°C.
+ */
+void rtdb_set_current_temp_mdeg(int32_t mdeg) {
+    int temp = (mdeg >= 0) ? (mdeg + 500) / 1000 : (mdeg - 500) / 1000;
+
+    RTDB_WRITE(db.lockCurrTemp,
+        db.current_temp_mdeg = mdeg;
+        db.current_temp = temp);
+}
+
+/**
+ * @brief Get current temperature with sub-degree precision.
+ * @return Current temperature in m°C.
+ */
+int32_t rtdb_get_current_temp_mdeg(void) {
+    int32_t mdeg;
+    RTDB_READ(db.lockCurrTemp, mdeg = db.current_temp_mdeg);
+    return mdeg;
 }
 
 /**
@@ -111,20 +277,35 @@ void rtdb_set_current_temp(int temp) {
  * @return Current temperature in °C.
  */
 int rtdb_get_current_temp(void) {
-    k_mutex_lock(&db.lockCurrTemp, K_FOREVER);
-    int temp = db.current_temp;
-    k_mutex_unlock(&db.lockCurrTemp);
+    int temp;
+    RTDB_READ(db.lockCurrTemp, temp = db.current_temp);
     return temp;
 }
 
+/**
+ * @brief Set the Kalman estimate of the plant temperature.
+ * @param mdeg Estimated temperature in m°C.
+ */
+void rtdb_set_estimated_temp_mdeg(int32_t mdeg) {
+    RTDB_WRITE(db.lockCurrTemp, db.estimated_temp_mdeg = mdeg);
+}
+
+/**
+ * @brief Get the Kalman estimate of the plant temperature.
+ * @return Estimated temperature in m°C.
+ */
+int32_t rtdb_get_estimated_temp_mdeg(void) {
+    int32_t mdeg;
+    RTDB_READ(db.lockCurrTemp, mdeg = db.estimated_temp_mdeg);
+    return mdeg;
+}
+
 /**
  * @brief Set heat on/off state.
  * @param on true to turn heater on, false to turn it off.
  */
 void rtdb_set_heat_on(bool on) {
-    k_mutex_lock(&db.lockHeatOn, K_FOREVER);
-    db.heat_on = on;
-    k_mutex_unlock(&db.lockHeatOn);
+    RTDB_STORE(db.lockHeatOn, db.heat_on, on);
 }
 
 /**
@@ -132,12 +313,29 @@ void rtdb_set_heat_on(bool on) {
  * @return true if heater is on, false otherwise.
  */
 bool rtdb_get_heat_on(void) {
-    k_mutex_lock(&db.lockHeatOn, K_FOREVER);
-    bool on = db.heat_on;
-    k_mutex_unlock(&db.lockHeatOn);
+    bool on;
+    RTDB_LOAD(db.lockHeatOn, db.heat_on, on);
     return on;
 }
 
+/**
+ * @brief Set the heater duty cycle.
+ * @param permille Heater power in ‰ (0 = off, 1000 = always on).
+ */
+void rtdb_set_heat_duty(uint16_t permille) {
+    RTDB_STORE(db.lockHeatOn, db.heat_duty, permille);
+}
+
+/**
+ * @brief Get the heater duty cycle.
+ * @return Heater power in ‰.
+ */
+uint16_t rtdb_get_heat_duty(void) {
+    uint16_t permille;
+    RTDB_LOAD(db.lockHeatOn, db.heat_duty, permille);
+    return permille;
+}
+
 /**
  * @brief Set PID parameters.
  * @param p Proportional gain.
@@ -145,11 +343,10 @@ bool rtdb_get_heat_on(void) {
  * @param d Derivative gain.
  */
 void rtdb_set_PID_params(float p, float i, float d) {
-    k_mutex_lock(&db.lockPIDparams, K_FOREVER);
-    db.kp = p;
-    db.ki = i;
-    db.kd = d;
-    k_mutex_unlock(&db.lockPIDparams);
+    RTDB_WRITE(db.lockPIDparams,
+        db.kp = p;
+        db.ki = i;
+        db.kd = d);
 }
 
 /**
@@ -159,11 +356,64 @@ void rtdb_set_PID_params(float p, float i, float d) {
  * @param d Pointer to receive derivative gain.
  */
 void rtdb_get_PID_params(float *p, float *i, float *d) {
-    k_mutex_lock(&db.lockPIDparams, K_FOREVER);
-    *p = db.kp;
-    *i = db.ki;
-    *d = db.kd;
-    k_mutex_unlock(&db.lockPIDparams);
+    float kp, ki, kd;
+
+    RTDB_READ(db.lockPIDparams,
+        kp = db.kp;
+        ki = db.ki;
+        kd = db.kd);
+    *p = kp;
+    *i = ki;
+    *d = kd;
+}
+
+/**
+ * @brief Replace the gain schedule.
+ * @param gs Schedule, checked with gainsched_check(); no points to stop scheduling.
+ */
+void rtdb_set_gain_schedule(const struct gain_schedule *gs) {
+    RTDB_WRITE(db.lockSchedule,
+        db.schedule = *gs;
+        db.schedule_gen++);
+}
+
+/**
+ * @brief Get the gain schedule.
+ * @param gs Pointer to receive the schedule, or NULL to read only its generation.
+ * @return Generation of the schedule, incremented by every rtdb_set_gain_schedule().
+ */
+uint32_t rtdb_get_gain_schedule(struct gain_schedule *gs) {
+    uint32_t gen;
+
+    if (gs == NULL) {
+        RTDB_READ(db.lockSchedule, gen = db.schedule_gen);
+        return gen;
+    }
+
+    struct gain_schedule copy;
+    RTDB_READ(db.lockSchedule,
+        copy = db.schedule;
+        gen = db.schedule_gen);
+    *gs = copy;
+    return gen;
+}
+
+/**
+ * @brief Select the control strategy.
+ * @param type Strategy run by control_step() from the next period on.
+ */
+void rtdb_set_controller(enum controller_type type) {
+    RTDB_STORE(db.lockPIDparams, db.controller, type);
+}
+
+/**
+ * @brief Get the selected control strategy.
+ * @return Strategy.
+ */
+enum controller_type rtdb_get_controller(void) {
+    uint8_t type;
+    RTDB_LOAD(db.lockPIDparams, db.controller, type);
+    return (enum controller_type)type;
 }
 
 /**
@@ -171,9 +421,7 @@ void rtdb_get_PID_params(float *p, float *i, float *d) {
  * @param on true to enable verbose mode, false to disable.
  */
 void rtdb_set_verbose(bool on) {
-    k_mutex_lock(&db.lockVerbose, K_FOREVER);
-    db.verbose = on;
-    k_mutex_unlock(&db.lockVerbose);
+    RTDB_STORE(db.lockVerbose, db.verbose, on);
 }
 
 /**
@@ -181,8 +429,232 @@ void rtdb_set_verbose(bool on) {
  * @return true if verbose mode is on, false otherwise.
  */
 bool rtdb_get_verbose(void) {
-    k_mutex_lock(&db.lockVerbose, K_FOREVER);
-    bool on = db.verbose;
-    k_mutex_unlock(&db.lockVerbose);
+    bool on;
+    RTDB_LOAD(db.lockVerbose, db.verbose, on);
     return on;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Record a sample-to-actuation latency measurement.
+ * @param us Time elapsed between the sensor read and the heater update, in microseconds.
+ */
+void rtdb_add_latency(uint32_t us) {
+    RTDB_WRITE(db.lockLatency,
+        db.latency_last = us;
+        db.latency_max = MAX(db.latency_max, us);
+        db.latency_sum += us;
+        db.latency_count++);
+}
+
+/**
+ * @brief Get sample-to-actuation latency statistics.
+ * @param last Pointer to receive the last measured latency (us).
+ * @param max Pointer to receive the maximum measured latency (us).
+ * @param avg Pointer to receive the average latency (us).
+ */
+void rtdb_get_latency(uint32_t *last, uint32_t *max, uint32_t *avg) {
+    uint32_t lat_last, lat_max, count;
+    uint64_t sum;
+
+    RTDB_READ(db.lockLatency,
+        lat_last = db.latency_last;
+        lat_max = db.latency_max;
+        sum = db.latency_sum;
+        count = db.latency_count);
+    *last = lat_last;
+    *max = lat_max;
+    *avg = (count > 0) ? (uint32_t)(sum / count) : 0;
+}
+
+/**
+ * @brief Set the period of a task.
+ * @param task Task identifier (see enum task_id).
+ * @param period_ms Period in milliseconds.
+ */
+void rtdb_set_task_period(int task, uint32_t period_ms) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return;
+    }
+    RTDB_STORE(db.lockPeriods, db.task_period[task], period_ms);
+}
+
+/**
+ * @brief Get the period of a task.
+ * @param task Task identifier (see enum task_id).
+ * @return Period in milliseconds, 0 if unset or invalid task.
+ */
+uint32_t rtdb_get_task_period(int task) {
+    if (task < 0 || task >= TASK_COUNT) {
+        return 0;
+    }
+    uint32_t period;
+    RTDB_LOAD(db.lockPeriods, db.task_period[task], period);
+    return period;
+}
+
+/**
+ * @brief Publish the sensor bus status.
+ * @param status Status and counters of the sensor task.
+ */
+void rtdb_set_sensor_status(const struct rtdb_sensor_status *status) {
+    RTDB_WRITE(db.lockSensor, db.sensor = *status);
+}
+
+/**
+ * @brief Get the sensor bus status.
+ * @param status Pointer to receive the status and counters.
+ */
+void rtdb_get_sensor_status(struct rtdb_sensor_status *status) {
+    struct rtdb_sensor_status copy;
+
+    RTDB_READ(db.lockSensor, copy = db.sensor);
+    *status = copy;
+}
+
+/**
+ * @brief Check whether the last temperature sample is valid.
+ * @return true if the last read succeeded, false otherwise.
+ */
+bool rtdb_get_sensor_ok(void) {
+    bool ok;
+    RTDB_READ(db.lockSensor, ok = db.sensor.ok);
+    return ok;
+}
+
+/**
+ * @brief Publish the heater switching statistics.
+ * @param stats Counters of the switching governor.
+ */
+void rtdb_set_switch_stats(const struct governor_stats *stats) {
+    RTDB_WRITE(db.lockSwitching, db.switching = *stats);
+}
+
+/**
+ * @brief Get the heater switching statistics.
+ * @param stats Pointer to receive the counters.
+ */
+void rtdb_get_switch_stats(struct governor_stats *stats) {
+    struct governor_stats copy;
+
+    RTDB_READ(db.lockSwitching, copy = db.switching);
+    *stats = copy;
+}
+
+/**
+ * @brief Ask the controller to start or abort an autotune.
+ * @param req Request, replacing any not yet taken.
+ */
+void rtdb_request_autotune(enum autotune_request req) {
+    RTDB_WRITE(db.lockAutotune, db.autotune_req = (uint8_t)req);
+}
+
+/**
+ * @brief Take the pending autotune request.
+ * @return The request, AUTOTUNE_REQ_NONE if there was none; it is cleared.
+ */
+enum autotune_request rtdb_take_autotune_request(void) {
+    uint8_t req;
+
+    //  Read and clear under the writer lock, so a request is never lost
+    RTDB_WRITE(db.lockAutotune,
+        req = db.autotune_req;
+        db.autotune_req = AUTOTUNE_REQ_NONE);
+    return (enum autotune_request)req;
+}
+
+/**
+ * @brief Publish the autotune progress and result.
+ * @param status Autotune status.
+ */
+void rtdb_set_autotune_status(const struct autotune_status *status) {
+    RTDB_WRITE(db.lockAutotune, db.autotune = *status);
+}
+
+/**
+ * @brief Get the autotune progress and result.
+ * @param status Pointer to receive the status.
+ */
+void rtdb_get_autotune_status(struct autotune_status *status) {
+    struct autotune_status copy;
+
+    RTDB_READ(db.lockAutotune, copy = db.autotune);
+    *status = copy;
+}
+
+/**
+ * @brief Publish the identified plant model.
+ * @param est Plant estimate.
+ */
+void rtdb_set_plant_estimate(const struct plant_estimate *est) {
+    RTDB_WRITE(db.lockPlant, db.plant = *est);
+}
+
+/**
+ * @brief Get the identified plant model.
+ * @param est Pointer to receive the estimate.
+ */
+void rtdb_get_plant_estimate(struct plant_estimate *est) {
+    struct plant_estimate copy;
+
+    RTDB_READ(db.lockPlant, copy = db.plant);
+    *est = copy;
+}
+
+/**
+ * @brief Replace the setpoint profile, run by the next start request.
+ * @param prog Profile, checked with profile_check().
+ */
+void rtdb_set_profile(const struct profile *prog) {
+    RTDB_WRITE(db.lockProfile, db.profile = *prog);
+}
+
+/**
+ * @brief Get the setpoint profile.
+ * @param prog Pointer to receive the profile.
+ */
+void rtdb_get_profile(struct profile *prog) {
+    struct profile copy;
+
+    RTDB_READ(db.lockProfile, copy = db.profile);
+    *prog = copy;
+}
+
+/**
+ * @brief Ask the controller to start, pause, resume or stop the profile.
+ * @param req Request, replacing any not yet taken.
+ */
+void rtdb_request_profile(enum profile_request req) {
+    RTDB_WRITE(db.lockProfile, db.profile_req = (uint8_t)req);
+}
+
+/**
+ * @brief Take the pending profile request.
+ * @return The request, PROFILE_REQ_NONE if there was none; it is cleared.
+ */
+enum profile_request rtdb_take_profile_request(void) {
+    uint8_t req;
+
+    RTDB_WRITE(db.lockProfile,
+        req = db.profile_req;
+        db.profile_req = PROFILE_REQ_NONE);
+    return (enum profile_request)req;
+}
+
+/**
+ * @brief Publish the profile progress.
+ * @param status Profile status.
+ */
+void rtdb_set_profile_status(const struct profile_status *status) {
+    RTDB_WRITE(db.lockProfile, db.profile_status = *status);
+}
+
+/**
+ * @brief Get the profile progress.
+ * @param status Pointer to receive the status.
+ */
+void rtdb_get_profile_status(struct profile_status *status) {
+    struct profile_status copy;
+
+    RTDB_READ(db.lockProfile, copy = db.profile_status);
+    *status = copy;
+}
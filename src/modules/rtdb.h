@@ -2,6 +2,22 @@
 #define RTDB_H
 
 #include <zephyr/kernel.h>
+#include "governor.h"
+#include "controller.h"
+#include "autotune.h"
+#include "ident.h"
+#include "gainsched.h"
+#include "profile.h"
+
+/**
+ * @brief Health of the temperature sensor bus accesses.
+ */
+struct rtdb_sensor_status {
+    bool ok;            /**< Last sample was read successfully */
+    uint32_t timeouts;  /**< Transfers that did not complete in time */
+    uint32_t retries;   /**< Transfers repeated after a failure */
+    uint32_t failures;  /**< Samples lost after exhausting the retries */
+};
 
 /**
  * @brief Initialize the RTDB.
@@ -26,10 +42,23 @@ bool rtdb_get_system_on(void);
 void rtdb_set_desired_temp(int temp);
 /**
  * @brief Get desired temperature.
- * @return Desired temperature in °C.
+ * @return Desired temperature in °C, rounded to the nearest degree.
  */
 int  rtdb_get_desired_temp(void);
 
+/**
+ * @brief Set desired temperature with sub-degree precision.
+ *
+ * Used by the setpoint profile, so its ramps are smooth.
+ * @param mdeg Desired temperature in m°C.
+ */
+void rtdb_set_desired_temp_mdeg(int32_t mdeg);
+/**
+ * @brief Get desired temperature with sub-degree precision.
+ * @return Desired temperature in m°C.
+ */
+int32_t rtdb_get_desired_temp_mdeg(void);
+
 /**
  * @brief Set current temperature.
  * @param temp Current temperature in °C.
@@ -41,6 +70,30 @@ void rtdb_set_current_temp(int temp);
  */
 int  rtdb_get_current_temp(void);
 
+/**
+ * @brief Set current temperature with sub-degree precision.
+ *
+ * Also updates the whole-degree value, rounded to the nearest degree.
+ * @param mdeg Current temperature in m°C.
+ */
+void rtdb_set_current_temp_mdeg(int32_t mdeg);
+/**
+ * @brief Get current temperature with sub-degree precision.
+ * @return Current temperature in m°C.
+ */
+int32_t rtdb_get_current_temp_mdeg(void);
+
+/**
+ * @brief Set the Kalman estimate of the plant temperature.
+ * @param mdeg Estimated temperature in m°C.
+ */
+void rtdb_set_estimated_temp_mdeg(int32_t mdeg);
+/**
+ * @brief Get the Kalman estimate of the plant temperature.
+ * @return Estimated temperature in m°C.
+ */
+int32_t rtdb_get_estimated_temp_mdeg(void);
+
 /**
  * @brief Set heat on/off state.
  * @param on true to turn heater on, false to turn it off.
@@ -52,6 +105,17 @@ void rtdb_set_heat_on(bool on);
  */
 bool rtdb_get_heat_on(void);
 
+/**
+ * @brief Set the heater duty cycle.
+ * @param permille Heater power in ‰ (0 = off, 1000 = always on).
+ */
+void rtdb_set_heat_duty(uint16_t permille);
+/**
+ * @brief Get the heater duty cycle.
+ * @return Heater power in ‰.
+ */
+uint16_t rtdb_get_heat_duty(void);
+
 /**
  * @brief Set PID parameters.
  * @param p Proportional gain.
@@ -67,6 +131,32 @@ void rtdb_set_PID_params(float kp, float ki, float kd);
  */
 void rtdb_get_PID_params(float *p, float *i, float *d);
 
+/**
+ * @brief Replace the gain schedule.
+ *
+ * While the schedule has points, the controller takes its gains from it
+ * instead of the PID parameters.
+ * @param gs Schedule, checked with gainsched_check(); no points to stop scheduling.
+ */
+void rtdb_set_gain_schedule(const struct gain_schedule *gs);
+/**
+ * @brief Get the gain schedule.
+ * @param gs Pointer to receive the schedule, or NULL to read only its generation.
+ * @return Generation of the schedule, incremented by every rtdb_set_gain_schedule().
+ */
+uint32_t rtdb_get_gain_schedule(struct gain_schedule *gs);
+
+/**
+ * @brief Select the control strategy.
+ * @param type Strategy run by control_step() from the next period on.
+ */
+void rtdb_set_controller(enum controller_type type);
+/**
+ * @brief Get the selected control strategy.
+ * @return Strategy.
+ */
+enum controller_type rtdb_get_controller(void);
+
 /**
  * @brief Set verbose mode on/off.
  * @param on true to enable verbose mode, false to disable.
@@ -78,4 +168,125 @@ void rtdb_set_verbose(bool on);
  */
 bool rtdb_get_verbose(void);
 
+/**
+ * @brief Record a sample-to-actuation latency measurement.
+ * @param us Time elapsed between the sensor read and the heater update, in microseconds.
+ */
+void rtdb_add_latency(uint32_t us);
+/**
+ * @brief Get sample-to-actuation latency statistics.
+ * @param last Pointer to receive the last measured latency (us).
+ * @param max Pointer to receive the maximum measured latency (us).
+ * @param avg Pointer to receive the average latency (us).
+ */
+void rtdb_get_latency(uint32_t *last, uint32_t *max, uint32_t *avg);
+
+/**
+ * @brief Set the period of a task.
+ * @param task Task identifier (see enum task_id).
+ * @param period_ms Period in milliseconds.
+ */
+void rtdb_set_task_period(int task, uint32_t period_ms);
+/**
+ * @brief Get the period of a task.
+ * @param task Task identifier (see enum task_id).
+ * @return Period in milliseconds, 0 if unset or invalid task.
+ */
+uint32_t rtdb_get_task_period(int task);
+
+/**
+ * @brief Publish the sensor bus status.
+ * @param status Status and counters of the sensor task.
+ */
+void rtdb_set_sensor_status(const struct rtdb_sensor_status *status);
+/**
+ * @brief Get the sensor bus status.
+ * @param status Pointer to receive the status and counters.
+ */
+void rtdb_get_sensor_status(struct rtdb_sensor_status *status);
+/**
+ * @brief Check whether the last temperature sample is valid.
+ * @return true if the last read succeeded, false otherwise.
+ */
+bool rtdb_get_sensor_ok(void);
+
+/**
+ * @brief Publish the heater switching statistics.
+ * @param stats Counters of the switching governor.
+ */
+void rtdb_set_switch_stats(const struct governor_stats *stats);
+/**
+ * @brief Get the heater switching statistics.
+ * @param stats Pointer to receive the counters.
+ */
+void rtdb_get_switch_stats(struct governor_stats *stats);
+
+/**
+ * @brief Ask the controller to start or abort an autotune.
+ * @param req Request, replacing any not yet taken.
+ */
+void rtdb_request_autotune(enum autotune_request req);
+/**
+ * @brief Take the pending autotune request.
+ * @return The request, AUTOTUNE_REQ_NONE if there was none; it is cleared.
+ */
+enum autotune_request rtdb_take_autotune_request(void);
+
+/**
+ * @brief Publish the autotune progress and result.
+ * @param status Autotune status.
+ */
+void rtdb_set_autotune_status(const struct autotune_status *status);
+/**
+ * @brief Get the autotune progress and result.
+ * @param status Pointer to receive the status.
+ */
+void rtdb_get_autotune_status(struct autotune_status *status);
+
+/**
+ * @brief Publish the identified plant model.
+ * @param est Plant estimate.
+ */
+void rtdb_set_plant_estimate(const struct plant_estimate *est);
+/**
+ * @brief Get the identified plant model.
+ * @param est Pointer to receive the estimate.
+ */
+void rtdb_get_plant_estimate(struct plant_estimate *est);
+
+/**
+ * @brief Replace the setpoint profile.
+ *
+ * A running profile keeps its own copy; the new one runs from the next start.
+ * @param prog Profile, checked with profile_check().
+ */
+void rtdb_set_profile(const struct profile *prog);
+/**
+ * @brief Get the setpoint profile.
+ * @param prog Pointer to receive the profile.
+ */
+void rtdb_get_profile(struct profile *prog);
+
+/**
+ * @brief Ask the controller to start, pause, resume or stop the profile.
+ * @param req Request, replacing any not yet taken.
+ */
+void rtdb_request_profile(enum profile_request req);
+/**
+ * @brief Take the pending profile request.
+ * @return The request, PROFILE_REQ_NONE if there was none; it is cleared.
+ */
+enum profile_request rtdb_take_profile_request(void);
+
+/**
+ * @brief Publish the profile progress.
+ * @param status Profile status.
+ */
+void rtdb_set_profile_status(const struct profile_status *status);
+/**
+ * @brief Get the profile progress.
+ * @param status Pointer to receive the status.
+ */
+void rtdb_get_profile_status(struct profile_status *status);
+
 #endif
\ No newline at end of file
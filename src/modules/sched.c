@@ -0,0 +1,124 @@
+/**
+ * @file sched.c
+ * @brief Rate-monotonic priority assignment and schedulability analysis.
+ *
+ * Derives thread priorities from the task periods (shorter period, higher
+ * priority) and checks whether the resulting task set meets its deadlines,
+ * both with the Liu & Layland utilization bound and with an exact
+ * response-time analysis.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <stdbool.h>
+
+#include "sched.h"
+
+/** Liu & Layland bound n(2^(1/n) - 1), in per mille, for n = 1..8 */
+static const uint16_t ll_bound_permille[] = { 1000, 828, 779, 756, 743, 734, 728, 724 };
+
+#define LL_BOUND_LIMIT 693  /**< Limit of the bound for large n (ln 2), in per mille */
+
+/**
+ * @brief Assigns rate-monotonic priorities.
+ *
+ * @param tasks Task table.
+ * @param n Number of tasks in the table.
+ * @param base_prio Priority given to the task with the shortest period.
+ */
+void sched_assign_rm(struct sched_task *tasks, int n, int base_prio) {
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].period_ms == 0) {
+            continue;
+        }
+
+        //  Priority level = number of distinct shorter periods
+        int level = 0;
+        for (int j = 0; j < n; j++) {
+            if (tasks[j].period_ms == 0 || tasks[j].period_ms >= tasks[i].period_ms) {
+                continue;
+            }
+
+            //  Count each distinct period only once
+            bool seen = false;
+            for (int k = 0; k < j; k++) {
+                if (tasks[k].period_ms == tasks[j].period_ms) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen) {
+                level++;
+            }
+        }
+
+        tasks[i].priority = base_prio + level;
+    }
+}
+
+/**
+ * @brief Checks the schedulability of a task set under fixed priorities.
+ *
+ * @param tasks Task table, with priorities already assigned.
+ * @param n Number of tasks in the table.
+ * @param util_permille Pointer to receive the total utilization (per mille).
+ * @param bound_permille Pointer to receive the Liu & Layland bound (per mille).
+ *
+ * @return int 0 if below the bound, 1 if schedulable by response-time analysis only, -1 otherwise.
+ */
+int sched_analyse(struct sched_task *tasks, int n, uint32_t *util_permille, uint32_t *bound_permille) {
+    uint64_t util = 0;
+    int active = 0;
+    bool feasible = true;
+
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].period_ms == 0) {
+            continue;
+        }
+        util += (uint64_t)tasks[i].wcet_us * 1000u / tasks[i].period_ms;  // us / ms = per mille
+        active++;
+    }
+
+    *util_permille = (uint32_t)(util / 1000u);
+    if (active == 0) {
+        *bound_permille = 1000;
+        return 0;
+    }
+    *bound_permille = (active <= (int)(sizeof(ll_bound_permille) / sizeof(ll_bound_permille[0])))
+                      ? ll_bound_permille[active - 1] : LL_BOUND_LIMIT;
+
+    //  Response-time analysis: R = C + sum over higher/equal priority tasks of ceil(R / Tj) * Cj
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].period_ms == 0) {
+            continue;
+        }
+
+        uint64_t deadline = (uint64_t)tasks[i].period_ms * 1000u;
+        uint64_t response = tasks[i].wcet_us;
+        uint64_t previous = 0;
+
+        while (response != previous && response <= deadline) {
+            previous = response;
+            response = tasks[i].wcet_us;
+
+            for (int j = 0; j < n; j++) {
+                if (j == i || tasks[j].period_ms == 0 || tasks[j].priority > tasks[i].priority) {
+                    continue;
+                }
+                uint64_t period_us = (uint64_t)tasks[j].period_ms * 1000u;
+                response += ((previous + period_us - 1) / period_us) * tasks[j].wcet_us;
+            }
+        }
+
+        tasks[i].response_us = (response > UINT32_MAX) ? UINT32_MAX : (uint32_t)response;
+        if (response > deadline) {
+            feasible = false;
+        }
+    }
+
+    if (!feasible) {
+        return -1;
+    }
+    return (*util_permille <= *bound_permille) ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+/**
+ * @brief Identifiers of the periodic/sporadic tasks of the system.
+ */
+enum task_id {
+    TASK_LED = 0,   /**< LED update task */
+    TASK_SENSOR,    /**< Temperature reading task (or fused pipeline) */
+    TASK_PID,       /**< PID controller task */
+    TASK_HEATER,    /**< Heater control task */
+    TASK_UART,      /**< UART command task (sporadic, minimum inter-arrival time) */
+    TASK_COUNT      /**< Number of tasks */
+};
+
+/**
+ * @brief Scheduling parameters of one task.
+ */
+struct sched_task {
+    const char *name;     /**< Task name, used in reports */
+    uint32_t period_ms;   /**< Period (or minimum inter-arrival time) in ms, 0 if unused */
+    uint32_t wcet_us;     /**< Worst-case execution time estimate in us */
+    int priority;         /**< Assigned priority (lower value is more urgent) */
+    uint32_t response_us; /**< Worst-case response time from the last analysis, in us */
+};
+
+/**
+ * @brief Assigns rate-monotonic priorities.
+ *
+ * Tasks with shorter periods get numerically lower (more urgent) priorities,
+ * starting at base_prio. Tasks with equal periods share the same priority.
+ * Tasks with a period of 0 are ignored.
+ *
+ * @param tasks Task table.
+ * @param n Number of tasks in the table.
+ * @param base_prio Priority given to the task with the shortest period.
+ */
+void sched_assign_rm(struct sched_task *tasks, int n, int base_prio);
+
+/**
+ * @brief Checks the schedulability of a task set under fixed priorities.
+ *
+ * Computes the total utilization, compares it against the Liu & Layland
+ * bound and runs an exact response-time analysis (deadline = period),
+ * storing each task's worst-case response time in the table.
+ *
+ * @param tasks Task table, with priorities already assigned.
+ * @param n Number of tasks in the table.
+ * @param util_permille Pointer to receive the total utilization (per mille).
+ * @param bound_permille Pointer to receive the Liu & Layland bound (per mille).
+ *
+ * @return int Status code:
+ *         -  0: Schedulable (utilization below the Liu & Layland bound)
+ *         -  1: Schedulable (response-time analysis only)
+ *         - -1: Not schedulable
+ */
+int sched_analyse(struct sched_task *tasks, int n, uint32_t *util_permille, uint32_t *bound_permille);
+
+#endif
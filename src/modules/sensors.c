@@ -0,0 +1,268 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/sys/printk.h>
+#include "tc74.h"
+#include "sensors.h"
+
+/**
+ * @file sensors.c
+ * @brief Batched reads of every TC74 sensor.
+ *
+ * The "microchip,tc74" devicetree nodes are grouped by I2C controller.
+ * Each sampling cycle starts one asynchronous read per bus; when it
+ * completes, the sampling thread immediately starts the next read on the
+ * same bus. Different buses work in parallel and extra sensors need no
+ * extra threads.
+ *
+ * Every transfer has a timeout (CONFIG_APP_SENSOR_TIMEOUT_MS) and up to
+ * CONFIG_APP_SENSOR_RETRIES retries.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+BUILD_ASSERT(DT_HAS_COMPAT_STATUS_OKAY(microchip_tc74), "No microchip,tc74 sensor in the devicetree");
+
+/** One TC74 and the state of its read in the current cycle */
+struct sensor_slot {
+    const struct device *dev;       /**< TC74 device */
+    const struct device *bus;       /**< I2C controller it is attached to */
+    volatile int result;            /**< Result reported by the completion callback */
+    volatile bool done;             /**< Set by the completion callback */
+    bool valid;                     /**< Read successfully in the last cycle */
+    int temp;                       /**< Temperature of the last successful read, in °C */
+};
+
+/** The sensors of one I2C controller, read back-to-back */
+struct sensor_bus {
+    const struct device *bus;       /**< I2C controller */
+    uint8_t first;                  /**< First entry of this bus in bus_order[] */
+    uint8_t count;                  /**< Number of sensors on this bus */
+    uint8_t next;                   /**< Sensor of this bus being read */
+    uint8_t attempt;                /**< Retries spent on the current sensor */
+    bool busy;                      /**< A transfer is in flight */
+    int64_t deadline;               /**< Uptime (ms) at which the transfer times out */
+};
+
+#define TC74_SLOT(node) { .dev = DEVICE_DT_GET(node), .bus = DEVICE_DT_GET(DT_BUS(node)) },
+
+static struct sensor_slot slots[] = { DT_FOREACH_STATUS_OKAY(microchip_tc74, TC74_SLOT) };
+
+#define SENSORS_COUNT ARRAY_SIZE(slots)
+
+static uint8_t bus_order[SENSORS_COUNT];        /**< Slot indices grouped by bus */
+static struct sensor_bus buses[SENSORS_COUNT];  /**< One entry per distinct bus */
+static int bus_count = 0;
+
+K_SEM_DEFINE(sensors_done_sem, 0, SENSORS_COUNT);  /**< Given on every transfer completion */
+
+
+/**
+ * @brief Completion callback of a TC74 fetch (may run in interrupt context).
+ */
+static void sensors_done(const struct device *dev, int result, void *user_data) {
+    struct sensor_slot *slot = user_data;
+
+    ARG_UNUSED(dev);
+
+    slot->result = result;
+    slot->done = true;
+    k_sem_give(&sensors_done_sem);
+}
+
+
+/**
+ * @brief Returns the slot currently being read on a bus.
+ */
+static struct sensor_slot *bus_slot(const struct sensor_bus *b) {
+    return &slots[bus_order[b->first + b->next]];
+}
+
+
+/**
+ * @brief Accounts the result of the current read of a bus.
+ *
+ * On success or when the retries are exhausted the bus moves on to its
+ * next sensor; otherwise the same sensor is read again.
+ */
+static void bus_complete(struct sensor_bus *b, int result, struct rtdb_sensor_status *status) {
+    struct sensor_slot *slot = bus_slot(b);
+
+    if (result == 0) {
+        struct sensor_value val;
+        sensor_channel_get(slot->dev, SENSOR_CHAN_AMBIENT_TEMP, &val);
+        slot->temp = val.val1;
+        slot->valid = true;
+    } else if (b->attempt < CONFIG_APP_SENSOR_RETRIES) {
+        b->attempt++;
+        status->retries++;
+        return;
+    } else {
+        status->failures++;
+    }
+
+    b->next++;
+    b->attempt = 0;
+}
+
+
+/**
+ * @brief Starts the next pending read of a bus, if any.
+ */
+static void bus_start(struct sensor_bus *b, struct rtdb_sensor_status *status) {
+    while (b->next < b->count) {
+        struct sensor_slot *slot = bus_slot(b);
+
+        slot->done = false;
+        int ret = tc74_fetch_async(slot->dev, sensors_done, slot);
+        if (ret == 0) {
+            b->busy = true;
+            b->deadline = k_uptime_get() + CONFIG_APP_SENSOR_TIMEOUT_MS;
+            return;
+        }
+        bus_complete(b, ret, status);
+    }
+}
+
+
+/**
+ * @brief Check that every TC74 in the devicetree is ready.
+ * @return Number of sensors, or a negative errno if one is not ready.
+ */
+int sensors_init(void) {
+    bus_count = 0;
+
+    /* Group the slots by bus, keeping devicetree order within each bus */
+    int n = 0;
+    for (int i = 0; i < SENSORS_COUNT; i++) {
+        if (!device_is_ready(slots[i].dev)) {
+            printk("Sensor %s is not ready!\n\r", slots[i].dev->name);
+            return -ENODEV;
+        }
+
+        bool seen = false;
+        for (int b = 0; b < bus_count; b++) {
+            seen = seen || (buses[b].bus == slots[i].bus);
+        }
+        if (seen) {
+            continue;
+        }
+
+        struct sensor_bus *b = &buses[bus_count++];
+        b->bus = slots[i].bus;
+        b->first = n;
+        b->count = 0;
+        for (int j = i; j < SENSORS_COUNT; j++) {
+            if (slots[j].bus == b->bus) {
+                bus_order[n++] = j;
+                b->count++;
+            }
+        }
+    }
+
+    return SENSORS_COUNT;
+}
+
+
+/**
+ * @brief Get the number of TC74 sensors.
+ * @return Number of sensors.
+ */
+int sensors_count(void) {
+    return SENSORS_COUNT;
+}
+
+
+/**
+ * @brief Read every sensor once.
+ *
+ * Reads on different buses run in parallel; the sensors of one bus are
+ * read back-to-back. Failed reads are retried; a bus whose transfer times
+ * out is abandoned for the rest of the cycle.
+ *
+ * @param status Timeout, retry and failure counters to update.
+ * @return Number of sensors read successfully.
+ */
+int sensors_sample(struct rtdb_sensor_status *status) {
+    k_sem_reset(&sensors_done_sem);
+
+    for (int i = 0; i < SENSORS_COUNT; i++) {
+        slots[i].valid = false;
+    }
+
+    for (int i = 0; i < bus_count; i++) {
+        buses[i].next = 0;
+        buses[i].attempt = 0;
+        buses[i].busy = false;
+        bus_start(&buses[i], status);
+    }
+
+    for (;;) {
+        int64_t now = k_uptime_get();
+        int64_t wake = INT64_MAX;
+
+        for (int i = 0; i < bus_count; i++) {
+            struct sensor_bus *b = &buses[i];
+
+            if (!b->busy) {
+                continue;
+            }
+
+            if (bus_slot(b)->done) {
+                b->busy = false;
+                bus_complete(b, bus_slot(b)->result, status);
+                bus_start(b, status);
+            } else if (now >= b->deadline) {
+                /* The controller is stuck: give up on the rest of this bus */
+                b->busy = false;
+                status->timeouts++;
+                status->failures += b->count - b->next;
+                b->next = b->count;
+            }
+
+            if (b->busy) {
+                wake = MIN(wake, b->deadline);
+            }
+        }
+
+        if (wake == INT64_MAX) {
+            break;
+        }
+
+        k_sem_take(&sensors_done_sem, K_MSEC(MAX(wake - now, 1)));
+    }
+
+    int valid = 0;
+    for (int i = 0; i < SENSORS_COUNT; i++) {
+        valid += slots[i].valid ? 1 : 0;
+    }
+    return valid;
+}
+
+
+/**
+ * @brief Get the temperature read by a sensor in the last cycle.
+ * @param idx Sensor index, 0 to sensors_count() - 1, in devicetree order.
+ * @param temp Pointer to receive the temperature in °C.
+ * @return true if the sensor was read successfully, false otherwise.
+ */
+bool sensors_get_temp(int idx, int *temp) {
+    if (idx < 0 || idx >= SENSORS_COUNT || !slots[idx].valid) {
+        return false;
+    }
+    *temp = slots[idx].temp;
+    return true;
+}
+
+
+/**
+ * @brief Get the device name of a sensor.
+ * @param idx Sensor index.
+ * @return Device name.
+ */
+const char *sensors_name(int idx) {
+    return (idx >= 0 && idx < SENSORS_COUNT) ? slots[idx].dev->name : "";
+}
@@ -0,0 +1,46 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <stdbool.h>
+#include "rtdb.h"
+
+/**
+ * @brief Check that every TC74 in the devicetree is ready.
+ * @return Number of sensors, or a negative errno if one is not ready.
+ */
+int sensors_init(void);
+
+/**
+ * @brief Get the number of TC74 sensors.
+ * @return Number of sensors.
+ */
+int sensors_count(void);
+
+/**
+ * @brief Read every sensor once.
+ *
+ * Reads on different buses run in parallel; the sensors of one bus are
+ * read back-to-back. Failed reads are retried; a bus whose transfer times
+ * out is abandoned for the rest of the cycle.
+ *
+ * @param status Timeout, retry and failure counters to update.
+ * @return Number of sensors read successfully.
+ */
+int sensors_sample(struct rtdb_sensor_status *status);
+
+/**
+ * @brief Get the temperature read by a sensor in the last cycle.
+ * @param idx Sensor index, 0 to sensors_count() - 1, in devicetree order.
+ * @param temp Pointer to receive the temperature in °C.
+ * @return true if the sensor was read successfully, false otherwise.
+ */
+bool sensors_get_temp(int idx, int *temp);
+
+/**
+ * @brief Get the device name of a sensor.
+ * @param idx Sensor index.
+ * @return Device name.
+ */
+const char *sensors_name(int idx);
+
+#endif
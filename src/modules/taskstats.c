@@ -0,0 +1,166 @@
+/**
+ * @file taskstats.c
+ * @brief Per-task timing statistics (release jitter, execution and response time).
+ *
+ * Each task/metric pair keeps a fixed-size log-linear histogram of cycle
+ * counts (4 buckets per power of two, so percentiles are within 25%) plus
+ * the exact minimum and maximum. Recording a sample costs a count-leading-zeros,
+ * a couple of shifts and a few compares, so it can run on every job.
+ *
+ * Each histogram has a single writer (its own task); readers may see a sample
+ * that is only partially accounted for, which is acceptable for statistics.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <string.h>
+
+#include "taskstats.h"
+
+/**
+ * @brief One timing histogram.
+ */
+struct taskstats_hist {
+    uint32_t count;                        /**< Number of samples */
+    uint32_t min;                          /**< Minimum value (cycles) */
+    uint32_t max;                          /**< Maximum value (cycles) */
+    uint16_t bucket[TASKSTATS_BUCKETS];    /**< Sample count per bucket */
+};
+
+static struct taskstats_hist hist[TASK_COUNT][TASKSTATS_METRICS];
+static uint32_t cyc_per_us = 1;
+
+/**
+ * @brief Maps a value to its histogram bucket.
+ */
+static inline unsigned int bucket_of(uint32_t v) {
+    if (v < (1u << TASKSTATS_SUB_BITS)) {
+        return v;
+    }
+    if (v >= (1u << TASKSTATS_MAX_BITS)) {
+        return TASKSTATS_BUCKETS - 1;
+    }
+
+    unsigned int e = 31 - __builtin_clz(v);
+    return ((e - TASKSTATS_SUB_BITS + 1) << TASKSTATS_SUB_BITS)
+           | ((v >> (e - TASKSTATS_SUB_BITS)) & ((1u << TASKSTATS_SUB_BITS) - 1));
+}
+
+/**
+ * @brief Returns the smallest value that maps to a bucket.
+ */
+static uint32_t bucket_floor(unsigned int idx) {
+    if (idx < (1u << TASKSTATS_SUB_BITS)) {
+        return idx;
+    }
+
+    unsigned int e = (idx >> TASKSTATS_SUB_BITS) + TASKSTATS_SUB_BITS - 1;
+    uint32_t mantissa = (1u << TASKSTATS_SUB_BITS) | (idx & ((1u << TASKSTATS_SUB_BITS) - 1));
+    return mantissa << (e - TASKSTATS_SUB_BITS);
+}
+
+/**
+ * @brief Returns the value below which pct percent of the samples fall.
+ */
+static uint32_t percentile(const struct taskstats_hist *h, uint32_t pct) {
+    uint32_t total = 0;
+    for (unsigned int i = 0; i < TASKSTATS_BUCKETS; i++) {
+        total += h->bucket[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t rank = (total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (unsigned int i = 0; i < TASKSTATS_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen >= rank) {
+            //  Upper edge of the bucket, bounded by the exact extremes
+            uint32_t v = (i + 1 < TASKSTATS_BUCKETS) ? bucket_floor(i + 1) - 1 : h->max;
+            if (v > h->max) v = h->max;
+            if (v < h->min) v = h->min;
+            return v;
+        }
+    }
+    return h->max;
+}
+
+/**
+ * @brief Initialize (and clear) the timing statistics.
+ * @param cycles_per_us Frequency of the cycle counter, in cycles per microsecond.
+ */
+void taskstats_init(uint32_t cycles_per_us) {
+    cyc_per_us = (cycles_per_us > 0) ? cycles_per_us : 1;
+    taskstats_reset();
+}
+
+/**
+ * @brief Clear all the timing statistics.
+ */
+void taskstats_reset(void) {
+    memset(hist, 0, sizeof(hist));
+}
+
+/**
+ * @brief Record one timing sample.
+ * @param task Task identifier (see enum task_id).
+ * @param metric Metric being recorded (see enum taskstats_metric).
+ * @param cycles Measured value, in counter cycles.
+ */
+void taskstats_record(int task, int metric, uint32_t cycles) {
+    if (task < 0 || task >= TASK_COUNT || metric < 0 || metric >= TASKSTATS_METRICS) {
+        return;
+    }
+
+    struct taskstats_hist *h = &hist[task][metric];
+    unsigned int idx = bucket_of(cycles);
+
+    if (h->count == 0 || cycles < h->min) h->min = cycles;
+    if (cycles > h->max) h->max = cycles;
+    h->count++;
+
+    //  Halve all buckets on saturation, keeping the shape of the distribution
+    if (h->bucket[idx] == UINT16_MAX) {
+        for (unsigned int i = 0; i < TASKSTATS_BUCKETS; i++) {
+            h->bucket[i] >>= 1;
+        }
+    }
+    h->bucket[idx]++;
+}
+
+/**
+ * @brief Record one job of a task from its release, start and end timestamps.
+ * @param task Task identifier (see enum task_id).
+ * @param release Counter value when the job was released.
+ * @param start Counter value when the job started executing.
+ * @param end Counter value when the job finished.
+ */
+void taskstats_record_job(int task, uint32_t release, uint32_t start, uint32_t end) {
+    taskstats_record(task, TASKSTATS_JITTER, start - release);
+    taskstats_record(task, TASKSTATS_EXEC, end - start);
+    taskstats_record(task, TASKSTATS_RESPONSE, end - release);
+}
+
+/**
+ * @brief Get the summary of one timing histogram.
+ * @param task Task identifier (see enum task_id).
+ * @param metric Metric (see enum taskstats_metric).
+ * @param out Pointer to receive the summary, in microseconds.
+ * @return int 0 on success, -1 if task or metric is invalid.
+ */
+int taskstats_get(int task, int metric, struct taskstats_summary *out) {
+    if (task < 0 || task >= TASK_COUNT || metric < 0 || metric >= TASKSTATS_METRICS) {
+        return -1;
+    }
+
+    const struct taskstats_hist *h = &hist[task][metric];
+
+    out->count = h->count;
+    out->min = h->min / cyc_per_us;
+    out->p50 = percentile(h, 50) / cyc_per_us;
+    out->p99 = percentile(h, 99) / cyc_per_us;
+    out->max = h->max / cyc_per_us;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef TASKSTATS_H
+#define TASKSTATS_H
+
+#include <stdint.h>
+
+#include "sched.h"
+
+#define TASKSTATS_SUB_BITS 2        /**< log2 of the number of histogram buckets per power of two */
+#define TASKSTATS_MAX_BITS 28       /**< Values at or above 2^TASKSTATS_MAX_BITS cycles go to the last bucket */
+#define TASKSTATS_BUCKETS (((TASKSTATS_MAX_BITS - TASKSTATS_SUB_BITS + 1) << TASKSTATS_SUB_BITS)) /**< Buckets per histogram */
+
+/**
+ * @brief Timing metrics recorded for each task.
+ */
+enum taskstats_metric {
+    TASKSTATS_JITTER = 0,   /**< Release jitter: from release to start of execution */
+    TASKSTATS_EXEC,         /**< Execution time: from start to end of the job */
+    TASKSTATS_RESPONSE,     /**< Response time: from release to end of the job */
+    TASKSTATS_METRICS       /**< Number of metrics */
+};
+
+/**
+ * @brief Summary of one timing histogram, in microseconds.
+ */
+struct taskstats_summary {
+    uint32_t count;   /**< Number of samples */
+    uint32_t min;     /**< Minimum value */
+    uint32_t p50;     /**< Median */
+    uint32_t p99;     /**< 99th percentile */
+    uint32_t max;     /**< Maximum value */
+};
+
+/**
+ * @brief Initialize (and clear) the timing statistics.
+ * @param cycles_per_us Frequency of the cycle counter feeding the statistics, in cycles per microsecond.
+ */
+void taskstats_init(uint32_t cycles_per_us);
+
+/**
+ * @brief Clear all the timing statistics.
+ */
+void taskstats_reset(void);
+
+/**
+ * @brief Record one timing sample.
+ *
+ * Constant time: one bucket lookup and a min/max update.
+ *
+ * @param task Task identifier (see enum task_id).
+ * @param metric Metric being recorded (see enum taskstats_metric).
+ * @param cycles Measured value, in counter cycles.
+ */
+void taskstats_record(int task, int metric, uint32_t cycles);
+
+/**
+ * @brief Record one job of a task from its release, start and end timestamps.
+ * @param task Task identifier (see enum task_id).
+ * @param release Counter value when the job was released.
+ * @param start Counter value when the job started executing.
+ * @param end Counter value when the job finished.
+ */
+void taskstats_record_job(int task, uint32_t release, uint32_t start, uint32_t end);
+
+/**
+ * @brief Get the summary of one timing histogram.
+ * @param task Task identifier (see enum task_id).
+ * @param metric Metric (see enum taskstats_metric).
+ * @param out Pointer to receive the summary, in microseconds.
+ * @return int 0 on success, -1 if task or metric is invalid.
+ */
+int taskstats_get(int task, int metric, struct taskstats_summary *out);
+
+#endif
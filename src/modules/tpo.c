@@ -0,0 +1,51 @@
+/**
+ * @file tpo.c
+ * @brief Time-proportional (slow software PWM) output for the heater.
+ *
+ * Turns the PID duty cycle into on/off slots of a fixed window. The caller
+ * runs tpo_tick() once per slot (a k_timer in the firmware, the virtual
+ * clock in the host simulation) and drives the pin with the result.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include "tpo.h"
+
+/**
+ * @brief Initialize the output off.
+ * @param t Output state.
+ * @param slots Slots per window (at least 1).
+ */
+void tpo_init(struct tpo *t, uint16_t slots) {
+    t->slots = (slots > 0) ? slots : 1;
+    t->slot = 0;
+    t->on_slots = 0;
+    t->out = false;
+}
+
+/**
+ * @brief Set the duty cycle.
+ * @param t Output state.
+ * @param permille Duty in ‰ (clamped to 1000).
+ */
+void tpo_set_duty(struct tpo *t, uint16_t permille) {
+    if (permille > 1000) {
+        permille = 1000;
+    }
+
+    t->on_slots = (uint16_t)(((uint32_t)permille * t->slots + 500) / 1000);
+}
+
+/**
+ * @brief Start the next slot.
+ * @param t Output state.
+ * @return Output state for the slot that starts.
+ */
+bool tpo_tick(struct tpo *t) {
+    t->out = t->slot < t->on_slots;
+    if (++t->slot >= t->slots) {
+        t->slot = 0;
+    }
+    return t->out;
+}
@@ -0,0 +1,46 @@
+#ifndef TPO_H
+#define TPO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Time-proportional output state.
+ *
+ * The output window is divided into equal slots. The output is on for the
+ * first on_slots slots of every window and off for the rest, so a duty in
+ * ‰ becomes at most two switches per window.
+ */
+struct tpo {
+    uint16_t slots;              /**< Slots per window */
+    uint16_t slot;               /**< Slot about to start */
+    volatile uint16_t on_slots;  /**< Slots on per window, set from the duty */
+    bool out;                    /**< Current output */
+};
+
+/**
+ * @brief Initialize the output off.
+ * @param t Output state.
+ * @param slots Slots per window (at least 1).
+ */
+void tpo_init(struct tpo *t, uint16_t slots);
+
+/**
+ * @brief Set the duty cycle.
+ *
+ * Takes effect from the next slot, rounded to whole slots. 1000 ‰ keeps
+ * the output always on.
+ *
+ * @param t Output state.
+ * @param permille Duty in ‰ (clamped to 1000).
+ */
+void tpo_set_duty(struct tpo *t, uint16_t permille);
+
+/**
+ * @brief Start the next slot.
+ * @param t Output state.
+ * @return Output state for the slot that starts.
+ */
+bool tpo_tick(struct tpo *t);
+
+#endif
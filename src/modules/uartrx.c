@@ -0,0 +1,72 @@
+/**
+ * @file uartrx.c
+ * @brief UART receive path: double-buffered async reception and frame assembly.
+ *
+ * Gain schedules and profiles are longer than one receive buffer, so the
+ * driver must always have a second buffer queued instead of stopping (and
+ * losing the frame) when the first one fills. The frame assembler is the
+ * same for the async and the polled UART.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+#include <string.h>
+
+#include "cmdproc.h"
+#include "uartrx.h"
+
+/**
+ * @brief Initialize the receive state (no frame in progress).
+ * @param rx Receive state.
+ */
+void uartrx_init(struct uartrx *rx) {
+    memset(rx, 0, sizeof(*rx));
+}
+
+/**
+ * @brief Get the next free receive buffer.
+ * @param rx Receive state.
+ * @return Buffer of UARTRX_DMA_SIZE bytes.
+ */
+uint8_t *uartrx_buf_next(struct uartrx *rx) {
+    uint8_t *buf = rx->buf[rx->next];
+
+    rx->next ^= 1;
+    return buf;
+}
+
+/**
+ * @brief Feed one received character to the frame assembler.
+ * @param rx Receive state.
+ * @param c Received character.
+ * @return enum uartrx_status Whether a frame was completed or discarded.
+ */
+enum uartrx_status uartrx_char(struct uartrx *rx, uint8_t c) {
+    //  Start of a new frame
+    if (c == SOF_SYM) {
+        rx->in_frame = true;
+        rx->nchar = 1;
+        rxChar(c);
+        return UARTRX_NONE;
+    }
+
+    if (!rx->in_frame) {
+        return UARTRX_NONE;
+    }
+
+    //  Too long: drop what the command processor has of it, or it would fill up for good
+    if (rx->nchar >= UART_RX_SIZE) {
+        rx->in_frame = false;
+        resetRxBuffer();
+        return UARTRX_OVERFLOW;
+    }
+    rx->nchar++;
+    rxChar(c);
+
+    if (c == EOF_SYM) {
+        rx->in_frame = false;
+        return UARTRX_FRAME;
+    }
+    return UARTRX_NONE;
+}
@@ -0,0 +1,62 @@
+#ifndef UARTRX_H
+#define UARTRX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UARTRX_DMA_SIZE 60  /**< Size of each async receive buffer */
+
+/**
+ * @brief Result of feeding one received character.
+ */
+enum uartrx_status {
+    UARTRX_NONE = 0,   /**< Nothing to do (character stored or ignored) */
+    UARTRX_FRAME,      /**< A complete '#'...'!' frame is in the command buffer */
+    UARTRX_OVERFLOW,   /**< The frame outgrew UART_RX_SIZE and was discarded */
+};
+
+/**
+ * @brief UART receive state.
+ *
+ * The async driver fills one buffer while the other is queued, so a frame
+ * longer than a buffer keeps arriving when the driver switches buffers.
+ */
+struct uartrx {
+    uint8_t buf[2][UARTRX_DMA_SIZE];  /**< Receive buffers, handed to the driver in turn */
+    uint8_t next;                     /**< Buffer to hand out on the next request */
+    bool in_frame;                    /**< Between a '#' and its '!' */
+    uint16_t nchar;                   /**< Characters of the current frame so far */
+};
+
+/**
+ * @brief Initialize the receive state (no frame in progress).
+ * @param rx Receive state.
+ */
+void uartrx_init(struct uartrx *rx);
+
+/**
+ * @brief Get the next free receive buffer.
+ *
+ * Called when enabling reception and on every buffer request. The driver
+ * releases buffers in the order it got them, so alternating between the
+ * two never hands out a buffer that is still being filled.
+ *
+ * @param rx Receive state.
+ * @return Buffer of UARTRX_DMA_SIZE bytes.
+ */
+uint8_t *uartrx_buf_next(struct uartrx *rx);
+
+/**
+ * @brief Feed one received character to the frame assembler.
+ *
+ * Characters from a '#' to the next '!' are appended to the command
+ * processor's receive buffer (rxChar()); anything outside a frame is ignored.
+ * A frame longer than UART_RX_SIZE is dropped, along with the receive buffer.
+ *
+ * @param rx Receive state.
+ * @param c Received character.
+ * @return enum uartrx_status Whether a frame was completed or discarded.
+ */
+enum uartrx_status uartrx_char(struct uartrx *rx, uint8_t c);
+
+#endif
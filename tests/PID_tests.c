@@ -1,7 +1,14 @@
+#include <math.h>
 #include "build/Unity/src/unity.h"
 #include "modules/cmdproc.h"
 #include "modules/rtdb.h"
 #include "modules/PID.h"
+#include "modules/controller.h"
+#include "modules/autotune.h"
+#include "modules/ident.h"
+#include "modules/control.h"
+#include "modules/plant.h"
+#include "sim.h"
 
 
 /** \file PID_tests.c
@@ -245,6 +252,210 @@ void test_PID_ZeroParameters(void) {
     printf("   ─> Test passed: No output, as all PID parameters are zero\n\n");
 }
 
+/**
+ * @brief Test the on/off strategy holds its state inside the hysteresis band
+ */
+void test_Controller_OnOffHysteresis(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │  - == ===   Test On/Off Hysteresis  === == -│\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct controller_ops *ops = controller_get(CONTROLLER_ONOFF);
+    const struct controller_params p = { .hysteresis = 1.0f, .out_max = 5.0f };
+    const float measured[] = { 38.0f, 39.6f, 40.4f, 40.6f, 40.0f, 39.6f, 39.4f };
+    const float expected[] = { 5.0f, 5.0f, 5.0f, 0.0f, 0.0f, 0.0f, 5.0f };
+    struct controller_state s;
+
+    ops->init(&s);
+    ops->reset(&s, 40.0f, measured[0], 0.0f);
+    for (int k = 0; k < 7; k++) {
+        float output = ops->update(&s, &p, 40.0f, measured[k], 0.25f);
+        printf("   ─> Measured: %.1f, Output: %.1f\n", measured[k], output);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, expected[k], output);
+    }
+    printf("   ─> Test passed: Switches only outside 40 ± 0.5\n\n");
+}
+
+/**
+ * @brief Test the PID derivative acts on the measurement, not on setpoint steps
+ */
+void test_Controller_DerivativeOnMeasurement(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │  - == === Test Derivative on Meas. === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct controller_ops *ops = controller_get(CONTROLLER_PID);
+    const struct controller_params p = { .kp = 1.0f, .ki = 0.0f, .kd = 0.5f };
+    struct controller_state s;
+
+    ops->init(&s);
+    ops->reset(&s, 30.0f, 30.0f, 0.0f);
+
+    // Setpoint step from 30 to 40 with a steady measurement: P only
+    float output = ops->update(&s, &p, 40.0f, 30.0f, 0.5f);
+    printf("   ─> Setpoint step output: %.2f\n", output);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, output);
+
+    // Measurement rising 1 °C in 0.5 s: derivative -0.5 * 2
+    output = ops->update(&s, &p, 40.0f, 31.0f, 0.5f);
+    printf("   ─> Rising measurement output: %.2f\n", output);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 8.0f, output);
+
+    printf("   ─> Test passed: No derivative kick on the setpoint step\n\n");
+}
+
+/**
+ * @brief Test the 2-DOF setpoint weight and the PI strategy ignoring Kd
+ */
+void test_Controller_SetpointWeightAndPI(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │  - == ===   Test 2-DOF PID and PI  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct controller_params p = { .kp = 2.0f, .ki = 0.1f, .kd = 1.0f, .beta = 0.5f, .out_max = 100.0f };
+    struct controller_state s;
+
+    // 2-DOF: half of the 10 °C setpoint step in P, kp * 5 + ki * 10 * 1 (a PID gives 21)
+    const struct controller_ops *ops = controller_get(CONTROLLER_PID_2DOF);
+    ops->init(&s);
+    ops->reset(&s, 30.0f, 30.0f, 0.0f);
+    float output = ops->update(&s, &p, 40.0f, 30.0f, 1.0f);
+    printf("   ─> 2-DOF output: %.2f\n", output);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 11.0f, output);
+
+    // Steady measurement: only the integral increment is added
+    output = ops->update(&s, &p, 40.0f, 30.0f, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 12.0f, output);
+
+    // PI: kp * 10 + ki * 10, the 2 °C jump is not differentiated
+    ops = controller_get(CONTROLLER_PI);
+    ops->init(&s);
+    ops->reset(&s, 40.0f, 28.0f, 0.0f);
+    output = ops->update(&s, &p, 40.0f, 30.0f, 1.0f);
+    printf("   ─> PI output: %.2f\n", output);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 21.0f, output);
+
+    TEST_ASSERT_NULL(controller_get(CONTROLLER_COUNT));
+    printf("   ─> Test passed: Setpoint weight and PI terms correct\n\n");
+}
+/**
+ * @brief Test the relay autotune on the plant model finds its oscillation
+ */
+void test_Autotune_RelayOnPlant(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │  - == ===   Test Relay Autotune   === == -  │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct autotune_config cfg = { .hysteresis = 1.0f, .out_max = 5.0f, .cycles = 3, .timeout_s = 600.0f };
+    struct plant_params params;
+    struct plant plant;
+    struct autotune tune;
+    int steps = 0;
+
+    sim_default_plant(&params);
+    plant_init(&plant, &params);
+    autotune_start(&tune, &cfg);
+
+    // Relay on the exact plant temperature, every 250 ms
+    while (tune.status.state == AUTOTUNE_RUNNING && steps++ < 10000) {
+        float output = autotune_update(&tune, 40.0f, plant_temp_mdeg(&plant) / 1000.0f, 0.25f);
+        plant_set_input(&plant, (output > 0.0f) ? 1000 : 0);
+        plant_step(&plant, 250);
+    }
+
+    printf("   ─> Ku: %.3f, Tu: %.2f s, Kp: %.3f, Ki: %.4f, Kd: %.3f\n",
+           tune.status.ku, tune.status.tu, tune.status.kp, tune.status.ki, tune.status.kd);
+
+    TEST_ASSERT_EQUAL(AUTOTUNE_DONE, tune.status.state);
+    TEST_ASSERT_EQUAL(3, tune.status.cycles);
+    // A 2 s dead time oscillates with a period of a few dead times
+    TEST_ASSERT_TRUE(tune.status.tu > 4.0f && tune.status.tu < 20.0f);
+    TEST_ASSERT_TRUE(tune.status.ku > 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.6f * tune.status.ku, tune.status.kp);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f * tune.status.kp / tune.status.tu, tune.status.ki);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, tune.status.kp * tune.status.tu / 8.0f, tune.status.kd);
+    printf("   ─> Test passed: Oscillation measured and gains computed\n\n");
+}
+
+/**
+ * @brief Test the online identification recovers the plant model from a whole-degree sensor
+ */
+void test_Ident_SquareWaveOnPlant(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == === Test Plant Identification === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    struct plant_params params;
+    struct plant plant;
+    struct ident id;
+    struct plant_estimate est;
+    uint16_t input = 0;
+
+    sim_default_plant(&params);
+    plant_init(&plant, &params);
+    ident_init(&id, 0.25f, 1.0f, 10000.0f);
+
+    // Heater on for a minute, off for a minute; the sensor rounds to whole degrees
+    for (int k = 0; k < 4 * 1800; k++) {
+        ident_update(&id, roundf(plant_temp_mdeg(&plant) / 1000.0f), input / 1000.0f);
+        input = sim_square_step(&plant, 60000, 250);
+    }
+    ident_estimate(&id, &est);
+
+    printf("   ─> Gain: %.2f C, tau: %.1f s, dead time: %.1f s, ambient: %.2f C, rms: %.3f C\n",
+           est.gain_c, est.tau_s, est.dead_s, est.ambient_c, est.rms_c);
+
+    TEST_ASSERT_TRUE(est.valid);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, 50.0f, est.gain_c);
+    TEST_ASSERT_FLOAT_WITHIN(6.0f, 40.0f, est.tau_s);
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 2.0f, est.dead_s);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 22.0f, est.ambient_c);
+    printf("   ─> Test passed: Gain, time constant, dead time and ambient recovered\n\n");
+}
+
+/**
+ * @brief Test the control stage restarts the identification when the control period changes
+ */
+void test_Ident_FollowsPeriodChange(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────────╮\n");
+    printf(" │ - == === Test Identification Period Change === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────────╯\n");
+
+    static struct control ctrl;
+    struct rtdb_sensor_status status = { .ok = true };
+
+    rtdb_set_sensor_status(&status);
+    rtdb_set_current_temp_mdeg(25000);
+    control_init(&ctrl, 5.0f);
+
+    // 250 ms control period: 4 samples per 1 s identification period
+    control_step(&ctrl, 0.25f);
+    TEST_ASSERT_EQUAL(4, ctrl.ident.decim);
+    TEST_ASSERT_EQUAL(1, ctrl.ident.count);
+
+    // 500 ms: started again with 2 samples per period, then kept
+    control_step(&ctrl, 0.5f);
+    TEST_ASSERT_EQUAL(2, ctrl.ident.decim);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, ctrl.ident.period_s);
+    control_step(&ctrl, 0.5f);
+    TEST_ASSERT_EQUAL(1, ctrl.ident.samples);
+
+    // 2 s, longer than the identification period: one sample per period, decays for 2 s
+    control_step(&ctrl, 2.0f);
+    printf("   ─> At 2 s: %u sample(s) per period of %.2f s, fastest decay %.4f\n",
+           ctrl.ident.decim, ctrl.ident.period_s, ctrl.ident.alpha[0]);
+    TEST_ASSERT_EQUAL(1, ctrl.ident.decim);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, ctrl.ident.period_s);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expf(-2.0f / IDENT_TAU_MIN_S), ctrl.ident.alpha[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f - 2.0f / 10000.0f, ctrl.ident.lambda);
+    printf("   ─> Test passed: The identification follows the control period\n\n");
+}
 
 
 int main(void) {
@@ -260,6 +471,14 @@ int main(void) {
     RUN_TEST(test_PID_ZeroError);
     RUN_TEST(test_PID_ZeroParameters);
 
+    // Run control strategy tests
+    RUN_TEST(test_Controller_OnOffHysteresis);
+    RUN_TEST(test_Controller_DerivativeOnMeasurement);
+    RUN_TEST(test_Controller_SetpointWeightAndPI);
+    RUN_TEST(test_Autotune_RelayOnPlant);
+    RUN_TEST(test_Ident_SquareWaveOnPlant);
+    RUN_TEST(test_Ident_FollowsPeriodChange);
+
     // Finalize and return test results
     return UNITY_END();
 }
\ No newline at end of file
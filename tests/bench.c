@@ -0,0 +1,450 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "cmdproc.h"
+#include "rtdb.h"
+#include "PID.h"
+#include "gainsched.h"
+#include "mpc.h"
+#include "taskstats.h"
+#include "health.h"
+
+
+/** \file bench.c
+*   \brief Host microbenchmarks of the RTDB, PID, MPC, gain schedule and command processor
+**
+*        Runs the production modules (built against tests/hal) in tight
+*       loops and prints one JSON document on stdout with the time per
+*       operation of each benchmark: mean, standard deviation, variance,
+*       minimum and median over the timed runs, plus the throughput at
+*       the median. The iteration count of a run is calibrated so that
+*       one run takes at least BENCH_MIN_RUN_NS.
+**
+*        Usage: bench [runs] [name filter]
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+#define BENCH_DEFAULT_RUNS 15       /**< Timed runs per benchmark */
+#define BENCH_MAX_RUNS 100          /**< Upper limit of the runs argument */
+#define BENCH_MIN_RUN_NS 2000000LL  /**< Minimum duration of one timed run */
+#define BENCH_FRAME_SIZE 24         /**< Largest command frame built here */
+
+/** A benchmark body: performs iters operations */
+typedef void (*bench_fn)(long iters);
+
+/** Sink that keeps results alive under optimisation */
+static volatile float sinkf;
+static volatile int sinki;
+
+static int first_result = 1;
+
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Calibrates, times and reports one benchmark as a JSON object.
+ */
+static void bench_run(const char *name, bench_fn fn, int runs) {
+    double ns[BENCH_MAX_RUNS];
+    long iters = 1;
+
+    /* Warm up and grow the run until it is long enough to time reliably */
+    for (;;) {
+        long long t0 = now_ns();
+        fn(iters);
+        if (now_ns() - t0 >= BENCH_MIN_RUN_NS || iters >= (1L << 30)) {
+            break;
+        }
+        iters *= 2;
+    }
+
+    double sum = 0.0;
+    for (int r = 0; r < runs; r++) {
+        long long t0 = now_ns();
+        fn(iters);
+        ns[r] = (double)(now_ns() - t0) / (double)iters;
+        sum += ns[r];
+    }
+
+    double mean = sum / runs;
+    double var = 0.0;
+    for (int r = 0; r < runs; r++) {
+        var += (ns[r] - mean) * (ns[r] - mean);
+    }
+    var = (runs > 1) ? var / (runs - 1) : 0.0;
+
+    qsort(ns, runs, sizeof(ns[0]), cmp_double);
+    double median = (runs % 2) ? ns[runs / 2] : (ns[runs / 2 - 1] + ns[runs / 2]) / 2.0;
+
+    printf("%s\n    {\"name\": \"%s\", \"iterations\": %ld, \"runs\": %d, "
+           "\"ns_per_op\": %.3f, \"ns_stddev\": %.3f, \"ns_variance\": %.4f, "
+           "\"ns_min\": %.3f, \"ns_median\": %.3f, \"ops_per_sec\": %.0f}",
+           first_result ? "" : ",", name, iters, runs, mean, sqrt(var), var,
+           ns[0], median, (median > 0.0) ? 1e9 / median : 0.0);
+    first_result = 0;
+}
+
+
+/* === RTDB === */
+
+static void bench_rtdb_get_current_temp(long iters) {
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        acc += rtdb_get_current_temp();
+    }
+    sinki = acc;
+}
+
+static void bench_rtdb_set_current_temp_mdeg(long iters) {
+    for (long n = 0; n < iters; n++) {
+        rtdb_set_current_temp_mdeg(25000 + (int32_t)(n & 1023));
+    }
+}
+
+static void bench_rtdb_get_desired_temp(long iters) {
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        acc += rtdb_get_desired_temp();
+    }
+    sinki = acc;
+}
+
+static void bench_rtdb_set_desired_temp(long iters) {
+    for (long n = 0; n < iters; n++) {
+        rtdb_set_desired_temp(30 + (int)(n & 7));
+    }
+}
+
+static void bench_rtdb_get_heat_on(long iters) {
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        acc += rtdb_get_heat_on();
+    }
+    sinki = acc;
+}
+
+static void bench_rtdb_set_heat_on(long iters) {
+    for (long n = 0; n < iters; n++) {
+        rtdb_set_heat_on(n & 1);
+    }
+}
+
+static void bench_rtdb_get_PID_params(long iters) {
+    float kp, ki, kd, acc = 0.0f;
+    for (long n = 0; n < iters; n++) {
+        rtdb_get_PID_params(&kp, &ki, &kd);
+        acc += kp + ki + kd;
+    }
+    sinkf = acc;
+}
+
+static void bench_rtdb_set_PID_params(long iters) {
+    for (long n = 0; n < iters; n++) {
+        rtdb_set_PID_params(2.0f, 0.1f, 0.05f + (float)(n & 1) * 0.01f);
+    }
+}
+
+static void bench_rtdb_add_latency(long iters) {
+    for (long n = 0; n < iters; n++) {
+        rtdb_add_latency((uint32_t)(100 + (n & 255)));
+    }
+}
+
+static void bench_rtdb_get_sensor_status(long iters) {
+    struct rtdb_sensor_status status;
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        rtdb_get_sensor_status(&status);
+        acc += status.ok;
+    }
+    sinki = acc;
+}
+
+
+/* === PID === */
+
+static void bench_pid_calculate(long iters) {
+    float last_error = 0.0f, integral = 0.0f, acc = 0.0f;
+    for (long n = 0; n < iters; n++) {
+        float measured = 25.0f + (float)(n & 15) * 0.25f;
+        acc += pid_calculate(30.0f, measured, 0.25f, &last_error, &integral);
+    }
+    sinkf = acc;
+}
+
+/* Default plant, 2 s dead time at 250 ms: 8 outputs in the dot product */
+static const struct plant_estimate bench_plant = { .gain_c = 50.0f, .tau_s = 40.0f, .dead_s = 2.0f };
+
+static void bench_mpc_calculate(long iters) {
+    struct mpc m;
+    float acc = 0.0f;
+
+    mpc_init(&m);
+    mpc_set_model(&m, &bench_plant, 5.0f, MPC_MOVE_WEIGHT);
+    for (long n = 0; n < iters; n++) {
+        float measured = 25.0f + (float)(n & 15) * 0.25f;
+        acc += mpc_calculate(&m, 30.0f, measured, 0.25f);
+    }
+    sinkf = acc;
+}
+
+/* Longest dead time the MPC holds: 63 outputs in the dot product */
+static void bench_mpc_calculate_long_dead(long iters) {
+    const struct plant_estimate plant = { .gain_c = 50.0f, .tau_s = 40.0f, .dead_s = 15.75f };
+    struct mpc m;
+    float acc = 0.0f;
+
+    mpc_init(&m);
+    mpc_set_model(&m, &plant, 5.0f, MPC_MOVE_WEIGHT);
+    for (long n = 0; n < iters; n++) {
+        float measured = 25.0f + (float)(n & 15) * 0.25f;
+        acc += mpc_calculate(&m, 30.0f, measured, 0.25f);
+    }
+    sinkf = acc;
+}
+
+/* Gains computed again on every call: the cost of a model change */
+static void bench_mpc_gains(long iters) {
+    struct mpc m;
+    float acc = 0.0f;
+
+    mpc_init(&m);
+    for (long n = 0; n < iters; n++) {
+        mpc_set_model(&m, &bench_plant, 5.0f, MPC_MOVE_WEIGHT + (float)(n & 1));
+        acc += mpc_calculate(&m, 30.0f, 25.0f, 0.25f);
+    }
+    sinkf = acc;
+}
+
+/* Full table, keyed by temperature: a lookup bisects at most three levels */
+static void bench_gainsched_lookup(long iters) {
+    struct gain_schedule gs = { .count = GAINSCHED_MAX, .key = GAINSCHED_TEMP };
+    float kp, ki, kd, acc = 0.0f;
+
+    for (int k = 0; k < GAINSCHED_MAX; k++) {
+        gs.points[k] = (struct gain_point){ 20.0f + 10.0f * k, 2.0f - 0.1f * k, 0.1f, 0.05f * k };
+    }
+    for (long n = 0; n < iters; n++) {
+        gainsched_lookup(&gs, 22.0f + (float)(n & 63), &kp, &ki, &kd);
+        acc += kp + ki + kd;
+    }
+    sinkf = acc;
+}
+
+
+/* === Command processor === */
+
+static const char *frame_body;       /**< Command and data of the frame under test */
+static unsigned char frame[BENCH_FRAME_SIZE];
+static int frame_len;
+
+/**
+ * @brief Builds "#<body><checksum>!" the way a host would send it.
+ */
+static int build_frame(unsigned char *out, const char *body) {
+    int n = strlen(body);
+    int chk = calcChecksum((unsigned char *)body, n);
+    return snprintf((char *)out, BENCH_FRAME_SIZE, "#%s%03d!", body, chk);
+}
+
+/**
+ * @brief Loads the frame under test into an empty receive buffer.
+ */
+static void load_frame(void) {
+    resetRxBuffer();
+    for (int k = 0; k < frame_len; k++) {
+        rxChar(frame[k]);
+    }
+}
+
+static void bench_checksum(long iters) {
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        acc += calcChecksum(frame + 1, frame_len - 5);
+    }
+    sinki = acc;
+}
+
+/* Receive buffer refill only: the fixed cost inside every command benchmark */
+static void bench_frame_load(long iters) {
+    for (long n = 0; n < iters; n++) {
+        load_frame();
+        resetTxBuffer();
+    }
+}
+
+static void bench_command(long iters) {
+    int acc = 0;
+    for (long n = 0; n < iters; n++) {
+        load_frame();
+        acc += cmdProcessor();
+        resetTxBuffer();
+    }
+    sinki = acc;
+}
+
+/* Host builds the frame, the target answers and the host checks the reply */
+static void bench_roundtrip(long iters) {
+    unsigned char out[BENCH_FRAME_SIZE];
+    unsigned char ans[UART_TX_SIZE];
+    int acc = 0;
+
+    for (long n = 0; n < iters; n++) {
+        int len = build_frame(out, frame_body);
+        resetRxBuffer();
+        for (int k = 0; k < len; k++) {
+            rxChar(out[k]);
+        }
+        cmdProcessor();
+        getTxBuffer(ans, &len);
+        resetTxBuffer();
+        acc += (len > 5 && calcChecksum(ans + 1, len - 5) == atoi((char *)ans + len - 4));
+    }
+    sinki = acc;
+}
+
+static void no_report(void) {
+}
+
+
+/** One command benchmarked through cmdProcessor() */
+struct bench_cmd {
+    const char *name;
+    const char *body;
+};
+
+static const struct bench_cmd commands[] = {
+    { "cmdProcessor/C", "C" },
+    { "cmdProcessor/D", "D" },
+    { "cmdProcessor/M", "M+30" },
+    { "cmdProcessor/S", "Sp2.00" },
+    { "cmdProcessor/V", "V" },
+    { "cmdProcessor/L", "L" },
+    { "cmdProcessor/P", "Ps0250" },
+    { "cmdProcessor/T", "T1r" },
+    { "cmdProcessor/R", "R" },
+    { "cmdProcessor/W", "W" },
+    { "cmdProcessor/I", "I" },
+    { "cmdProcessor/A", "A" },
+    { "cmdProcessor/bad_checksum", NULL },
+};
+
+static const struct {
+    const char *name;
+    bench_fn fn;
+} functions[] = {
+    { "rtdb_get_current_temp", bench_rtdb_get_current_temp },
+    { "rtdb_set_current_temp_mdeg", bench_rtdb_set_current_temp_mdeg },
+    { "rtdb_get_desired_temp", bench_rtdb_get_desired_temp },
+    { "rtdb_set_desired_temp", bench_rtdb_set_desired_temp },
+    { "rtdb_get_heat_on", bench_rtdb_get_heat_on },
+    { "rtdb_set_heat_on", bench_rtdb_set_heat_on },
+    { "rtdb_get_PID_params", bench_rtdb_get_PID_params },
+    { "rtdb_set_PID_params", bench_rtdb_set_PID_params },
+    { "rtdb_add_latency", bench_rtdb_add_latency },
+    { "rtdb_get_sensor_status", bench_rtdb_get_sensor_status },
+    { "pid_calculate", bench_pid_calculate },
+    { "mpc_calculate", bench_mpc_calculate },
+    { "mpc_calculate/long_dead", bench_mpc_calculate_long_dead },
+    { "mpc_gains", bench_mpc_gains },
+    { "gainsched_lookup", bench_gainsched_lookup },
+};
+
+
+/**
+ * @brief Selects the frame under test and checks it is accepted.
+ * @return 0 if cmdProcessor() accepts the frame, -1 otherwise.
+ */
+static int select_frame(const char *body) {
+    if (body == NULL) {
+        /* Valid framing, wrong checksum: exercises the reject path */
+        frame_body = "C";
+        frame_len = snprintf((char *)frame, sizeof(frame), "#C000!");
+        return 0;
+    }
+
+    frame_body = body;
+    frame_len = build_frame(frame, body);
+    load_frame();
+    int ret = cmdProcessor();
+    resetTxBuffer();
+    return (ret == 0) ? 0 : -1;
+}
+
+
+static int selected(const char *name, const char *filter) {
+    return filter == NULL || strstr(name, filter) != NULL;
+}
+
+
+int main(int argc, char **argv) {
+    int runs = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_RUNS;
+    const char *filter = (argc > 2) ? argv[2] : NULL;
+
+    if (runs < 1 || runs > BENCH_MAX_RUNS) {
+        fprintf(stderr, "usage: %s [runs 1-%d] [name filter]\n", argv[0], BENCH_MAX_RUNS);
+        return 1;
+    }
+
+    rtdb_init();
+    taskstats_init(1);
+    health_init();
+    setMemReportHandler(no_report);
+
+    printf("{\n  \"unit\": \"ns\",\n  \"benchmarks\": [");
+
+    for (size_t k = 0; k < sizeof(functions) / sizeof(functions[0]); k++) {
+        if (selected(functions[k].name, filter)) {
+            bench_run(functions[k].name, functions[k].fn, runs);
+        }
+    }
+
+    if (select_frame("Sp2.00") == 0 && selected("calcChecksum", filter)) {
+        bench_run("calcChecksum", bench_checksum, runs);
+    }
+    if (select_frame("C") == 0 && selected("frame_load", filter)) {
+        bench_run("frame_load", bench_frame_load, runs);
+    }
+
+    int failed = 0;
+    for (size_t k = 0; k < sizeof(commands) / sizeof(commands[0]); k++) {
+        if (!selected(commands[k].name, filter)) {
+            continue;
+        }
+        if (select_frame(commands[k].body) != 0) {
+            fprintf(stderr, "%s: frame rejected\n", commands[k].name);
+            failed = 1;
+            continue;
+        }
+        bench_run(commands[k].name, bench_command, runs);
+    }
+
+    if (select_frame("C") == 0 && selected("roundtrip/C", filter)) {
+        bench_run("roundtrip/C", bench_roundtrip, runs);
+    }
+    if (select_frame("I") == 0 && selected("roundtrip/I", filter)) {
+        bench_run("roundtrip/I", bench_roundtrip, runs);
+    }
+
+    printf("\n  ]\n}\n");
+    return failed;
+}
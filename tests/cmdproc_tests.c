@@ -1,6 +1,9 @@
 //gcc tests.c modules/cmdproc.c Unity/src/unity.c -o test
+#include <math.h>
+#include <string.h>
 #include "Unity/src/unity.h"
 #include "modules/cmdproc.h"
+#include "modules/rtdb.h"
 
 
 /** \file cmdproc_tests.c
@@ -233,6 +236,356 @@ void test_SetPIDparams(void) {
     printf("\n");
 }
 
+/**
+ * @brief Test that each #S command changes only its own gain, to the value sent.
+ */
+void test_SetPIDparamsValue(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===   PID Parameter Values    === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const char *frames[] = {"Sp2.50", "Si0.10", "Sd0.05"};
+    float kp, ki, kd;
+
+    rtdb_set_PID_params(1.0f, 1.0f, 1.0f);
+
+    for (int k = 0; k < 3; k++) {
+        unsigned char frame[16];
+        int len = sprintf((char *)frame, "#%s%03d!", frames[k],
+                          calcChecksum((unsigned char *)frames[k], strlen(frames[k])));
+
+        resetTxBuffer();
+        resetRxBuffer();
+        for (int c = 0; c < len; c++) {
+            rxChar(frame[c]);
+        }
+        printf("   ─> Sent: %s\n", frame);
+        TEST_ASSERT_EQUAL(0, cmdProcessor());
+    }
+
+    rtdb_get_PID_params(&kp, &ki, &kd);
+    printf("   ─> Expected gains:  Kp=2.50 Ki=0.10 Kd=0.05\n");
+    printf("   ─> Resulting gains: Kp=%.2f Ki=%.2f Kd=%.2f\n\n", kp, ki, kd);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.50f, kp);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.10f, ki);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.05f, kd);
+}
+
+/**
+ * @brief Test function for selecting the control strategy of a zone.
+ */
+void test_SelectController(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Select Control Strategy  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const char *frames[] = {"K03", "K14", "K07"};
+    const int expected[] = {0, -2, -2};
+
+    rtdb_set_controller(CONTROLLER_PID);
+
+    for (int k = 0; k < 3; k++) {
+        unsigned char frame[16];
+        int len = sprintf((char *)frame, "#%s%03d!", frames[k],
+                          calcChecksum((unsigned char *)frames[k], strlen(frames[k])));
+
+        resetTxBuffer();
+        resetRxBuffer();
+        for (int c = 0; c < len; c++) {
+            rxChar(frame[c]);
+        }
+        int result = cmdProcessor();
+        printf("   ─> Sent: %s, result %d (expected %d)\n", frame, result, expected[k]);
+        TEST_ASSERT_EQUAL(expected[k], result);
+    }
+
+    // Only the valid frame (zone 0, 2-DOF PID) changed the strategy
+    printf("   ─> Strategy: %d (expected %d)\n\n", rtdb_get_controller(), CONTROLLER_PID_2DOF);
+    TEST_ASSERT_EQUAL(CONTROLLER_PID_2DOF, rtdb_get_controller());
+}
+
+/**
+ * @brief Test function for starting the autotune and reading its result.
+ */
+void test_Autotune(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===      Relay Autotune       === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct autotune_status tune = {
+        .state = AUTOTUNE_DONE, .cycles = 3, .ku = 2.251f, .tu = 13.0f,
+        .kp = 1.35f, .ki = 0.2078f, .kd = 2.195f,
+    };
+    const char *payload = "u23013500020802195";
+    char expected[32];
+    unsigned char ans[32];
+    int len;
+
+    // Start: only leaves the request for the controller
+    const unsigned char start[] = "#U1134!";
+    for (int c = 0; c < (int)strlen((const char *)start); c++) {
+        rxChar(start[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    TEST_ASSERT_EQUAL(AUTOTUNE_REQ_START, rtdb_take_autotune_request());
+    TEST_ASSERT_EQUAL(AUTOTUNE_REQ_NONE, rtdb_take_autotune_request());
+
+    // Status: state, periods and the gains in thousandths
+    rtdb_set_autotune_status(&tune);
+    sprintf(expected, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+
+    const unsigned char status[] = "#Us200!";
+    resetTxBuffer();
+    resetRxBuffer();
+    for (int c = 0; c < (int)strlen((const char *)status); c++) {
+        rxChar(status[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+
+    printf("   ─> Expected response:  %s", expected);
+    printf("\n   ─> Generated response: %.*s\n\n", len, ans);
+
+    TEST_ASSERT_EQUAL(strlen(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, ans, len);
+
+    // Negative or NaN gains (reverse-acting or mis-identified plant) read as 0
+    struct autotune_status bad = tune;
+    bad.kp = -1.35f;
+    bad.ki = NAN;
+    rtdb_set_autotune_status(&bad);
+    payload = "u23000000000002195";
+    sprintf(expected, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+
+    resetTxBuffer();
+    resetRxBuffer();
+    for (int c = 0; c < (int)strlen((const char *)status); c++) {
+        rxChar(status[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+    printf("   ─> Negative and NaN gains: %.*s\n\n", len, ans);
+
+    TEST_ASSERT_EQUAL(strlen(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, ans, len);
+}
+
+/**
+ * @brief Test function for reading the heater switching statistics.
+ */
+void test_GetSwitchStats(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===   Heater Switching Stats  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct governor_stats stats = {
+        .switches = 12, .suppressed = 3, .held_min_on = 1, .held_min_off = 2, .held_rate = 0,
+    };
+    const unsigned char frame[] = "#G071!";
+    const char *payload = "g0001200003000010000200000";
+    char expected[32];
+    unsigned char ans[32];
+    int len;
+
+    rtdb_set_switch_stats(&stats);
+    sprintf(expected, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+
+    for (int c = 0; c < (int)strlen((const char *)frame); c++) {
+        rxChar(frame[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+
+    printf("   ─> Expected response:  %s", expected);
+    printf("\n   ─> Generated response: %.*s\n\n", len, ans);
+
+    TEST_ASSERT_EQUAL(strlen(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, ans, len);
+}
+
+/**
+ * @brief Test function for reading the identified plant model.
+ */
+void test_GetPlantEstimate(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===   Plant Model Estimate    === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    const struct plant_estimate est = {
+        .valid = true, .gain_c = 47.32f, .tau_s = 41.7f, .dead_s = 3.0f, .ambient_c = 22.44f, .samples = 1234,
+    };
+    const unsigned char frame[] = "#N078!";
+    const char *payload = "n1047300417030022401234";
+    char expected[32];
+    unsigned char ans[32];
+    int len;
+
+    rtdb_set_plant_estimate(&est);
+    sprintf(expected, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+
+    for (int c = 0; c < (int)strlen((const char *)frame); c++) {
+        rxChar(frame[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+
+    printf("   ─> Expected response:  %s", expected);
+    printf("\n   ─> Generated response: %.*s\n\n", len, ans);
+
+    TEST_ASSERT_EQUAL(strlen(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, ans, len);
+}
+
+/**
+ * @brief Test function for uploading the gain schedule in one frame.
+ */
+void test_SetGainSchedule(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===   Upload Gain Schedule    === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    //  Valid, out of order, bad key, one point short
+    const char *frames[] = {
+        "Bt3030040000020000100060020000010000050090010000005000200",
+        "Bs2060020000010000050030040000020000100",
+        "Bx1030040000020000100",
+        "Bt3030040000020000100060020000010000050",
+    };
+    const int expected[] = {0, -2, -2, -4};
+    struct gain_schedule gs;
+
+    for (int k = 0; k < 4; k++) {
+        unsigned char frame[UART_RX_SIZE];
+        int len = sprintf((char *)frame, "#%s%03d!", frames[k],
+                          calcChecksum((unsigned char *)frames[k], strlen(frames[k])));
+
+        resetTxBuffer();
+        resetRxBuffer();
+        for (int c = 0; c < len; c++) {
+            rxChar(frame[c]);
+        }
+        int result = cmdProcessor();
+        printf("   ─> Sent: %s, result %d (expected %d)\n", frame, result, expected[k]);
+        TEST_ASSERT_EQUAL(expected[k], result);
+    }
+
+    // Only the first frame reached the RTDB
+    rtdb_get_gain_schedule(&gs);
+    printf("   ─> Points: %u, key %u, Kp at 60 C: %.3f\n\n", gs.count, gs.key, gs.points[1].kp);
+    TEST_ASSERT_EQUAL(3, gs.count);
+    TEST_ASSERT_EQUAL(GAINSCHED_TEMP, gs.key);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, gs.points[0].temp_c);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, gs.points[0].kp);
+    TEST_ASSERT_EQUAL_FLOAT(0.2f, gs.points[0].ki);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, gs.points[0].kd);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, gs.points[1].kp);
+    TEST_ASSERT_EQUAL_FLOAT(90.0f, gs.points[2].temp_c);
+    TEST_ASSERT_EQUAL_FLOAT(0.2f, gs.points[2].kd);
+
+    // An empty schedule stops scheduling
+    gs.count = 0;
+    rtdb_set_gain_schedule(&gs);
+}
+
+/**
+ * @brief Test function for uploading, starting and querying the setpoint profile.
+ */
+void test_SetpointProfile(void) {
+
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Setpoint Profile Engine  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    //  Valid upload, non-digit rate, one segment short, start, unknown action
+    const char *frames[] = {
+        "F201000400003000000030000060",
+        "F101x0040000300",
+        "F20100040000300",
+        "O1",
+        "Ox",
+    };
+    const int expected[] = {0, -2, -4, 0, -2};
+    const struct profile_status prof = {
+        .state = PROFILE_RUNNING, .segment = 1, .holding = true, .setpoint_c = 30.0f, .remaining_ms = 42300,
+    };
+    const char *payload = "o111030000042";
+    char status[32];
+    unsigned char ans[32];
+    struct profile prog;
+    int len;
+
+    for (int k = 0; k < 5; k++) {
+        unsigned char frame[UART_RX_SIZE];
+        len = sprintf((char *)frame, "#%s%03d!", frames[k],
+                      calcChecksum((unsigned char *)frames[k], strlen(frames[k])));
+
+        resetTxBuffer();
+        resetRxBuffer();
+        for (int c = 0; c < len; c++) {
+            rxChar(frame[c]);
+        }
+        int result = cmdProcessor();
+        printf("   ─> Sent: %s, result %d (expected %d)\n", frame, result, expected[k]);
+        TEST_ASSERT_EQUAL(expected[k], result);
+    }
+
+    // Only the first upload reached the RTDB; the start is left for the controller
+    rtdb_get_profile(&prog);
+    TEST_ASSERT_EQUAL(2, prog.count);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, prog.segments[0].rate);
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, prog.segments[0].target_c);
+    TEST_ASSERT_EQUAL(300000, prog.segments[0].hold_ms);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, prog.segments[1].rate);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, prog.segments[1].target_c);
+    TEST_ASSERT_EQUAL(60000, prog.segments[1].hold_ms);
+    TEST_ASSERT_EQUAL(PROFILE_REQ_START, rtdb_take_profile_request());
+    TEST_ASSERT_EQUAL(PROFILE_REQ_NONE, rtdb_take_profile_request());
+
+    // A manual setpoint stops the profile, so it is not overwritten
+    const unsigned char manual[] = "#M+30219!";
+    resetTxBuffer();
+    resetRxBuffer();
+    for (int c = 0; c < (int)strlen((const char *)manual); c++) {
+        rxChar(manual[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    TEST_ASSERT_EQUAL(PROFILE_REQ_STOP, rtdb_take_profile_request());
+    TEST_ASSERT_EQUAL(30, rtdb_get_desired_temp());
+
+    // Status: state, segment, holding, setpoint in 0.1 C and the time left in s
+    rtdb_set_profile_status(&prof);
+    sprintf(status, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+
+    const unsigned char query[] = "#Os194!";
+    resetTxBuffer();
+    resetRxBuffer();
+    for (int c = 0; c < (int)strlen((const char *)query); c++) {
+        rxChar(query[c]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+
+    printf("   ─> Expected response:  %s", status);
+    printf("\n   ─> Generated response: %.*s\n\n", len, ans);
+
+    TEST_ASSERT_EQUAL(strlen(status), len);
+    TEST_ASSERT_EQUAL_MEMORY(status, ans, len);
+}
+
 /**
  * @brief Test function for toggling the verbose mode.
  */
@@ -629,6 +982,13 @@ int main(void){
     RUN_TEST(test_ReadDesiredTemp);
     RUN_TEST(test_SetDesiredTemp);
     RUN_TEST(test_SetPIDparams);
+    RUN_TEST(test_SetPIDparamsValue);
+    RUN_TEST(test_SelectController);
+    RUN_TEST(test_Autotune);
+    RUN_TEST(test_GetSwitchStats);
+    RUN_TEST(test_GetPlantEstimate);
+    RUN_TEST(test_SetGainSchedule);
+    RUN_TEST(test_SetpointProfile);
     RUN_TEST(test_ToggleVerbose);
     RUN_TEST(test_invalidcommand);
     RUN_TEST(test_invalidchecksum);
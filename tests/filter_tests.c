@@ -0,0 +1,169 @@
+#include "unity.h"
+#include "filter.h"
+
+
+/** \file filter_tests.c
+*   \brief Unit tests of the temperature filters
+**
+*        Checks the moving average and median while their window fills,
+*       the rounding of the even-length median and the IIR convergence
+*       at both ends of its shift range
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the moving average uses the samples received so far until its window is full
+ */
+void test_Filter_MovingAverageWarmUp(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Moving Average Warm-Up  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────╯\n");
+
+    struct filter f;
+    filter_init(&f, FILTER_MOVING_AVG, 4, 0);
+
+    // Mean of 1, 2, 3 and then 4 samples, rounded to the nearest
+    TEST_ASSERT_EQUAL(10, filter_update(&f, 10));
+    TEST_ASSERT_EQUAL(15, filter_update(&f, 20));
+    TEST_ASSERT_EQUAL(20, filter_update(&f, 31));
+    TEST_ASSERT_EQUAL(25, filter_update(&f, 40));
+
+    // Full window: the oldest sample drops out
+    int32_t y = filter_update(&f, 50);
+    printf("   ─> Mean of 20, 31, 40, 50: %d\n", y);
+    TEST_ASSERT_EQUAL(35, y);
+
+    // Halves round away from zero; a reset starts the warm-up again
+    filter_reset(&f);
+    TEST_ASSERT_EQUAL(-1, filter_update(&f, -1));
+    TEST_ASSERT_EQUAL(-2, filter_update(&f, -2));
+
+    // Out-of-range lengths are clamped
+    filter_init(&f, FILTER_MOVING_AVG, 0, 0);
+    TEST_ASSERT_EQUAL(1, f.len);
+    filter_init(&f, FILTER_MOVING_AVG, 40, 0);
+    TEST_ASSERT_EQUAL(FILTER_MAX_LEN, f.len);
+    printf("   ─> Test passed: The average warms up over the first samples\n\n");
+}
+
+/**
+ * @brief Test the median warms up like the average, rejects spikes and rounds the even-length middle pair
+ */
+void test_Filter_MedianWarmUp(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Median Warm-Up and Rounding  === == - │\n");
+    printf(" ╰──────────────────────────────────────────────────────╯\n");
+
+    struct filter f;
+    filter_init(&f, FILTER_MEDIAN, 5, 0);
+
+    // Odd counts take the middle sample, even counts the mean of the middle pair
+    TEST_ASSERT_EQUAL(100, filter_update(&f, 100));
+    TEST_ASSERT_EQUAL(50, filter_update(&f, 0));
+    TEST_ASSERT_EQUAL(100, filter_update(&f, 1000));
+    TEST_ASSERT_EQUAL(100, filter_update(&f, 100));
+
+    // A single spike in a full window is rejected
+    int32_t y = filter_update(&f, 100000);
+    printf("   ─> Median of 100, 0, 1000, 100, 100000: %d\n", y);
+    TEST_ASSERT_EQUAL(100, y);
+
+    // Even length: 1 and 2 give 1.5, rounded away from zero to 2 (and -2 for negatives)
+    filter_init(&f, FILTER_MEDIAN, 4, 0);
+    filter_update(&f, 1);
+    TEST_ASSERT_EQUAL(2, filter_update(&f, 2));
+    filter_reset(&f);
+    filter_update(&f, -1);
+    TEST_ASSERT_EQUAL(-2, filter_update(&f, -2));
+
+    // Unsorted full window: middle pair 3 and 10 gives 6.5, rounded to 7
+    filter_reset(&f);
+    filter_update(&f, 10);
+    filter_update(&f, 1);
+    filter_update(&f, 20);
+    y = filter_update(&f, 3);
+    printf("   ─> Median of 10, 1, 20, 3: %d\n", y);
+    TEST_ASSERT_EQUAL(7, y);
+    printf("   ─> Test passed: The median warms up and rounds the middle pair\n\n");
+}
+
+/**
+ * @brief Test the IIR passes samples through at shift 0 and settles exactly on a step at shift 12
+ */
+void test_Filter_IIRConvergence(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test IIR Convergence  === == - │\n");
+    printf(" ╰──────────────────────────────────────────╯\n");
+
+    struct filter f;
+
+    // Shift 0: no smoothing at all
+    filter_init(&f, FILTER_IIR, 1, 0);
+    TEST_ASSERT_EQUAL(25000, filter_update(&f, 25000));
+    TEST_ASSERT_EQUAL(-300, filter_update(&f, -300));
+    TEST_ASSERT_EQUAL(7, filter_update(&f, 7));
+
+    // Shift 12 (larger shifts are clamped): starts from the first sample
+    filter_init(&f, FILTER_IIR, 1, 20);
+    TEST_ASSERT_EQUAL(12, f.shift);
+    TEST_ASSERT_EQUAL(0, filter_update(&f, 0));
+
+    // One time constant (4096 samples) covers about 63% of a step...
+    int32_t y = 0;
+    for (int i = 0; i < 4096; i++) {
+        y = filter_update(&f, 1000);
+    }
+    printf("   ─> After 4096 samples of a 1000 step: %d\n", y);
+    TEST_ASSERT_INT_WITHIN(2, 632, y);
+
+    // ...and it settles exactly on the input, with no rounding dead band
+    for (int i = 0; i < 20 * 4096; i++) {
+        y = filter_update(&f, 1000);
+    }
+    TEST_ASSERT_EQUAL(1000, y);
+
+    // Full-range step near 2^19 without overflowing the state
+    filter_reset(&f);
+    filter_update(&f, 500000);
+    for (int i = 0; i < 30 * 4096; i++) {
+        y = filter_update(&f, -500000);
+    }
+    printf("   ─> After a step from 500000 to -500000: %d\n", y);
+    TEST_ASSERT_EQUAL(-500000, y);
+    printf("   ─> Test passed: The IIR converges at both ends of its shift range\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Filter_MovingAverageWarmUp);
+    RUN_TEST(test_Filter_MedianWarmUp);
+    RUN_TEST(test_Filter_IIRConvergence);
+
+    return UNITY_END();
+}
@@ -0,0 +1,98 @@
+#include "unity.h"
+#include "gainsched.h"
+
+
+/** \file gainsched_tests.c
+*   \brief Unit tests of the PID gain schedule
+**
+*        Looks gains up in a schedule keyed by temperature: ends, points,
+*       interpolation, continuity and the checks of a table
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the schedule holds its ends, interpolates between points and rejects bad tables
+ */
+void test_GainSched_Interpolation(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────────╮\n");
+    printf(" │ - == === Test Gain Schedule Interpolation === == - │\n");
+    printf(" ╰────────────────────────────────────────────────────╯\n");
+
+    struct gain_schedule gs = {
+        .count = 4,
+        .key = GAINSCHED_TEMP,
+        .points = {
+            { 20.0f, 4.0f, 0.4f, 0.0f },
+            { 40.0f, 2.0f, 0.2f, 0.1f },
+            { 60.0f, 1.0f, 0.1f, 0.2f },
+            { 80.0f, 1.0f, 0.0f, 0.4f },
+        },
+    };
+    float kp = -1.0f, ki = -1.0f, kd = -1.0f;
+
+    TEST_ASSERT_EQUAL(0, gainsched_check(&gs));
+
+    // Ends are held, points are hit exactly, and between points the gains are interpolated
+    gainsched_lookup(&gs, 10.0f, &kp, &ki, &kd);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, kp);
+    gainsched_lookup(&gs, 100.0f, &kp, &ki, &kd);
+    TEST_ASSERT_EQUAL_FLOAT(0.4f, kd);
+    gainsched_lookup(&gs, 40.0f, &kp, &ki, &kd);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, kp);
+    gainsched_lookup(&gs, 75.0f, &kp, &ki, &kd);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.025f, ki);
+    gainsched_lookup(&gs, 50.0f, &kp, &ki, &kd);
+    printf("   ─> Gains at 50 C: %.3f, %.3f, %.3f\n", kp, ki, kd);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.5f, kp);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.15f, ki);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.15f, kd);
+
+    // No jump across a point
+    float kp_below, kp_above;
+    gainsched_lookup(&gs, 39.999f, &kp_below, &ki, &kd);
+    gainsched_lookup(&gs, 40.001f, &kp_above, &ki, &kd);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, kp_below, kp_above);
+
+    // Points out of order and negative gains are rejected; no points leaves the gains alone
+    gs.points[2].temp_c = 40.0f;
+    TEST_ASSERT_EQUAL(-1, gainsched_check(&gs));
+    gs.points[2].temp_c = 60.0f;
+    gs.points[1].ki = -0.1f;
+    TEST_ASSERT_EQUAL(-1, gainsched_check(&gs));
+    gs.count = 0;
+    kp = 7.0f;
+    gainsched_lookup(&gs, 50.0f, &kp, &ki, &kd);
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, kp);
+    printf("   ─> Test passed: Gains held, interpolated and checked\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_GainSched_Interpolation);
+
+    return UNITY_END();
+}
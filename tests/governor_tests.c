@@ -0,0 +1,221 @@
+#include "unity.h"
+#include "governor.h"
+
+
+/** \file governor_tests.c
+*   \brief Unit tests of the FET switching governor
+**
+*        Checks the minimum on/off times, the refill of the switching
+*       rate credit, the counting of held back transitions and the
+*       quantisation of the duty of the periodic outputs
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test a transition waits for the minimum on or off time and is applied once it has elapsed
+ */
+void test_Governor_MinOnOffTime(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Minimum On/Off Time  === == - │\n");
+    printf(" ╰──────────────────────────────────────────────╯\n");
+
+    const struct governor_config cfg = { .min_on_ms = 1000, .min_off_ms = 1000, .max_per_min = 0 };
+    struct governor g;
+    governor_init(&g, &cfg, 5000);
+
+    // Off "forever" at start: switching on is not held back
+    TEST_ASSERT_TRUE(governor_request(&g, true, 5000));
+
+    // Off after 999 ms on is held back, after 1000 ms it is not
+    TEST_ASSERT_TRUE(governor_request(&g, false, 5500));
+    TEST_ASSERT_TRUE(governor_request(&g, false, 5999));
+    TEST_ASSERT_FALSE(governor_request(&g, false, 6000));
+    TEST_ASSERT_EQUAL(1, g.stats.held_min_on);
+
+    // Same for on, after the minimum off time
+    TEST_ASSERT_FALSE(governor_request(&g, true, 6200));
+    TEST_ASSERT_TRUE(governor_request(&g, true, 7000));
+    printf("   ─> Switches: %u, held by min on: %u, by min off: %u\n", (unsigned)g.stats.switches,
+           (unsigned)g.stats.held_min_on, (unsigned)g.stats.held_min_off);
+    TEST_ASSERT_EQUAL(3, g.stats.switches);
+    TEST_ASSERT_EQUAL(1, g.stats.held_min_off);
+    TEST_ASSERT_EQUAL(0, g.stats.held_rate);
+
+    // The fail safe does not wait for the minimum on time
+    governor_force_off(&g, 7001);
+    TEST_ASSERT_FALSE(g.state);
+    TEST_ASSERT_EQUAL(4, g.stats.switches);
+    printf("   ─> Test passed: Transitions wait for the minimum times\n\n");
+}
+
+/**
+ * @brief Test the rate limit credit allows a burst of one on/off cycle and refills at one switch per 60000 / max ms
+ */
+void test_Governor_CreditRefill(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Credit Refill  === == - │\n");
+    printf(" ╰────────────────────────────────────────╯\n");
+
+    // 20 switches per minute: 3000 ms of credit per switch, at most 6000
+    const struct governor_config cfg = { .min_on_ms = 0, .min_off_ms = 0, .max_per_min = 20 };
+    struct governor g;
+    governor_init(&g, &cfg, 0);
+    TEST_ASSERT_EQUAL(6000, g.credit_ms);
+
+    // A full cycle at once, then the third switch waits for credit
+    TEST_ASSERT_TRUE(governor_request(&g, true, 0));
+    TEST_ASSERT_FALSE(governor_request(&g, false, 10));
+    TEST_ASSERT_FALSE(governor_request(&g, true, 20));
+    TEST_ASSERT_EQUAL(1, g.stats.held_rate);
+
+    // 10 ms of credit were left: the switch is allowed 2990 ms after the last one
+    TEST_ASSERT_FALSE(governor_request(&g, true, 2999));
+    TEST_ASSERT_TRUE(governor_request(&g, true, 3000));
+    TEST_ASSERT_EQUAL(0, g.credit_ms);
+
+    // A long idle time refills two switches, not more
+    TEST_ASSERT_FALSE(governor_request(&g, false, 600000));
+    TEST_ASSERT_TRUE(governor_request(&g, true, 600000));
+    TEST_ASSERT_TRUE(governor_request(&g, false, 600000));
+    printf("   ─> Switches: %u, held by the rate limit: %u\n", (unsigned)g.stats.switches, (unsigned)g.stats.held_rate);
+    TEST_ASSERT_EQUAL(5, g.stats.switches);
+    TEST_ASSERT_EQUAL(2, g.stats.held_rate);
+
+    // The credit also refills across the 32-bit ms wrap
+    governor_init(&g, &cfg, 0xFFFFF000u);
+    governor_request(&g, true, 0xFFFFF000u);
+    governor_request(&g, false, 0xFFFFF000u);
+    TEST_ASSERT_FALSE(governor_request(&g, true, 0xFFFFF000u + 2999));
+    TEST_ASSERT_TRUE(governor_request(&g, true, 0xFFFFF000u + 3000));
+    printf("   ─> Test passed: The credit refills up to one on/off cycle\n\n");
+}
+
+/**
+ * @brief Test a held back transition is counted once however often it is requested, and again after it was dropped
+ */
+void test_Governor_SuppressedOncePerPending(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Suppressed Once per Pending  === == - │\n");
+    printf(" ╰──────────────────────────────────────────────────────╯\n");
+
+    const struct governor_config cfg = { .min_on_ms = 1000, .min_off_ms = 0, .max_per_min = 0 };
+    struct governor g;
+    governor_init(&g, &cfg, 0);
+    governor_request(&g, true, 0);
+
+    // Requested every control period while held back: one suppressed transition
+    for (uint32_t t = 100; t < 1000; t += 100) {
+        TEST_ASSERT_TRUE(governor_request(&g, false, t));
+    }
+    TEST_ASSERT_EQUAL(1, g.stats.suppressed);
+    TEST_ASSERT_TRUE(g.pending);
+
+    // Asking for the current state drops it; asking again counts a new one
+    governor_request(&g, true, 950);
+    TEST_ASSERT_FALSE(g.pending);
+    governor_request(&g, false, 960);
+    TEST_ASSERT_EQUAL(2, g.stats.suppressed);
+
+    // Applied later: not counted again
+    TEST_ASSERT_FALSE(governor_request(&g, false, 1000));
+    TEST_ASSERT_FALSE(g.pending);
+    printf("   ─> Suppressed: %u, held by min on: %u, switches: %u\n", (unsigned)g.stats.suppressed,
+           (unsigned)g.stats.held_min_on, (unsigned)g.stats.switches);
+    TEST_ASSERT_EQUAL(2, g.stats.suppressed);
+    TEST_ASSERT_EQUAL(2, g.stats.held_min_on);
+    TEST_ASSERT_EQUAL(2, g.stats.switches);
+    printf("   ─> Test passed: Each held back transition is counted once\n\n");
+}
+
+/**
+ * @brief Test the duty of a periodic output is rounded to the minimum on/off times and its edges counted per period
+ */
+void test_Governor_DutyQuantisation(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Duty Quantisation  === == - │\n");
+    printf(" ╰────────────────────────────────────────────╯\n");
+
+    // 10 ms minimums on a 100 ms PWM period: pulses and gaps of at least 100 ‰
+    const struct governor_config cfg = { .min_on_ms = 10, .min_off_ms = 10, .max_per_min = 0 };
+    struct governor g;
+    governor_init(&g, &cfg, 0);
+
+    TEST_ASSERT_EQUAL(0, governor_duty(&g, 0, 100, 0));
+    TEST_ASSERT_EQUAL(0, governor_duty(&g, 49, 100, 0));
+    TEST_ASSERT_EQUAL(100, governor_duty(&g, 50, 100, 0));
+    TEST_ASSERT_EQUAL(500, governor_duty(&g, 500, 100, 0));
+    TEST_ASSERT_EQUAL(900, governor_duty(&g, 950, 100, 0));
+    TEST_ASSERT_EQUAL(1000, governor_duty(&g, 951, 100, 0));
+    TEST_ASSERT_EQUAL(1000, governor_duty(&g, 1500, 100, 0));
+
+    // Counted once while the requested duty keeps being rounded
+    printf("   ─> Rounded by min on: %u, by min off: %u\n", (unsigned)g.stats.held_min_on, (unsigned)g.stats.held_min_off);
+    TEST_ASSERT_EQUAL(1, g.stats.held_min_on);
+    TEST_ASSERT_EQUAL(1, g.stats.held_min_off);
+    TEST_ASSERT_EQUAL(2, g.stats.suppressed);
+
+    // Pulsing for one second from fully off: one edge to start, two per period
+    governor_init(&g, &cfg, 0);
+    governor_duty(&g, 300, 100, 0);
+    governor_duty(&g, 300, 100, 250);
+    governor_duty(&g, 400, 100, 1000);
+    printf("   ─> Switches after 1 s at 30-40 %%: %u\n", (unsigned)g.stats.switches);
+    TEST_ASSERT_EQUAL(21, g.stats.switches);
+
+    // The fail safe stops the pulses at once
+    governor_force_off(&g, 1050);
+    TEST_ASSERT_EQUAL(22, g.stats.switches);
+    TEST_ASSERT_EQUAL(0, g.duty);
+
+    // No room for both minimums in the period: on/off at 500 ‰, through the minimum times
+    const struct governor_config slow = { .min_on_ms = 1000, .min_off_ms = 1000, .max_per_min = 0 };
+    governor_init(&g, &slow, 0);
+    TEST_ASSERT_EQUAL(0, governor_duty(&g, 499, 100, 0));
+    TEST_ASSERT_EQUAL(1000, governor_duty(&g, 500, 100, 0));
+    TEST_ASSERT_EQUAL(1000, governor_duty(&g, 100, 100, 500));
+    TEST_ASSERT_EQUAL(0, governor_duty(&g, 100, 100, 1000));
+
+    // Two edges per 2 s window exceed 20 switches per minute, per 6 s window they do not
+    const struct governor_config rate = { .min_on_ms = 0, .min_off_ms = 0, .max_per_min = 20 };
+    governor_init(&g, &rate, 0);
+    TEST_ASSERT_EQUAL(0, governor_duty(&g, 300, 2000, 0));
+    TEST_ASSERT_EQUAL(300, governor_duty(&g, 300, 6000, 0));
+    printf("   ─> Test passed: Pulses and gaps respect the minimum times\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Governor_MinOnOffTime);
+    RUN_TEST(test_Governor_CreditRefill);
+    RUN_TEST(test_Governor_SuppressedOncePerPending);
+    RUN_TEST(test_Governor_DutyQuantisation);
+
+    return UNITY_END();
+}
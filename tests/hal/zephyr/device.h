@@ -0,0 +1,47 @@
+#ifndef HOST_ZEPHYR_DEVICE_H
+#define HOST_ZEPHYR_DEVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/devicetree.h>
+
+/**
+ * @file device.h
+ * @brief Host stand-in for <zephyr/device.h>.
+ *
+ * DEVICE_DT_INST_DEFINE() defines the device declared by devicetree.h, for
+ * DEVICE_DT_GET() and the tests to use. The init function is kept for the
+ * tests to call; power management, init level and priority are ignored,
+ * and every device is ready.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+/** Device instance */
+struct device {
+    const char *name;                       /**< Instance name (the node identifier) */
+    int (*init)(const struct device *dev);  /**< Init function, NULL if none */
+    const void *config;                     /**< Driver configuration */
+    const void *api;                        /**< Driver API */
+    void *data;                             /**< Driver state */
+};
+
+#define DEVICE_DT_GET(node) (&HOST_DT_DEVICE(node))
+#define DEVICE_DT_INST_GET(inst) DEVICE_DT_GET(DT_DRV_INST(inst))
+
+#define DEVICE_DT_INST_DEFINE(inst, init_fn, pm, data_ptr, config_ptr, level, prio, api_ptr) \
+    const struct device HOST_DT_DEVICE(DT_DRV_INST(inst)) = {                                \
+        .name = HOST_DT_STR(DT_DRV_INST(inst)),                                             \
+        .init = (init_fn),                                                                  \
+        .config = (config_ptr),                                                             \
+        .api = (api_ptr),                                                                   \
+        .data = (data_ptr),                                                                 \
+    };
+
+static inline bool device_is_ready(const struct device *dev) {
+    return dev != NULL;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef HOST_ZEPHYR_DEVICETREE_H
+#define HOST_ZEPHYR_DEVICETREE_H
+
+/**
+ * @file devicetree.h
+ * @brief Host stand-in for <zephyr/devicetree.h>.
+ *
+ * A test describes its devicetree in the header named by HOST_DT_HEADER:
+ * HOST_DT_INSTS(fn) lists the instance numbers of the driver under test,
+ * HOST_DT_NODES(fn) the same nodes (DT_N_INST_<n>), and DT_N_INST_<n>_BUS
+ * and DT_N_INST_<n>_REG their bus node and address, and HOST_DT_BUSES(fn)
+ * the bus nodes, which the test defines. Every device is declared here,
+ * as Zephyr does for DEVICE_DT_GET(). Without the header there is a
+ * single instance, 0, on no bus.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#if defined(HOST_DT_HEADER)
+#include HOST_DT_HEADER
+#endif
+
+#ifndef HOST_DT_INSTS
+#define HOST_DT_INSTS(fn) fn(0)
+#define HOST_DT_NODES(fn) fn(DT_N_INST_0)
+#endif
+
+#define HOST_DT_CAT(a, b) HOST_DT_CAT_(a, b)
+#define HOST_DT_CAT_(a, b) a##b
+#define HOST_DT_STR(x) HOST_DT_STR_(x)
+#define HOST_DT_STR_(x) #x
+
+#define HOST_DT_DEVICE(node) HOST_DT_CAT(host_dt_, node)
+#define HOST_DT_DECLARE(node) extern const struct device HOST_DT_DEVICE(node);
+
+struct device;
+HOST_DT_NODES(HOST_DT_DECLARE)
+#if defined(HOST_DT_BUSES)
+HOST_DT_BUSES(HOST_DT_DECLARE)
+#endif
+
+#define DT_DRV_INST(inst) HOST_DT_CAT(DT_N_INST_, inst)
+#define DT_BUS(node) HOST_DT_CAT(node, _BUS)
+#define DT_REG_ADDR(node) HOST_DT_CAT(node, _REG)
+
+#define DT_HAS_COMPAT_STATUS_OKAY(compat) 1
+#define DT_FOREACH_STATUS_OKAY(compat, fn) HOST_DT_NODES(fn)
+#define DT_INST_FOREACH_STATUS_OKAY(fn) HOST_DT_INSTS(fn)
+
+#endif
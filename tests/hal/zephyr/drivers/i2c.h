@@ -0,0 +1,97 @@
+#ifndef HOST_ZEPHYR_DRIVERS_I2C_H
+#define HOST_ZEPHYR_DRIVERS_I2C_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @file i2c.h
+ * @brief Host stand-in for <zephyr/drivers/i2c.h>.
+ *
+ * The transfers go to the api of the bus device, so that a test can
+ * provide the controller. i2c_transfer_cb() returns -ENOSYS when the
+ * controller has no callback support, as in Zephyr.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define I2C_MSG_WRITE 0             /**< Write message */
+#define I2C_MSG_READ BIT(0)         /**< Read message */
+#define I2C_MSG_STOP BIT(1)         /**< Stop after this message */
+#define I2C_MSG_RESTART BIT(2)      /**< Repeated start before this message */
+
+/** One message of a transfer */
+struct i2c_msg {
+    uint8_t *buf;                   /**< Data */
+    uint32_t len;                   /**< Length of buf */
+    uint8_t flags;                  /**< I2C_MSG_* */
+};
+
+/** Completion callback of i2c_transfer_cb() */
+typedef void (*i2c_callback_t)(const struct device *dev, int result, void *userdata);
+
+/** I2C controller API */
+struct i2c_driver_api {
+    int (*transfer)(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr);
+    int (*transfer_cb)(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr,
+                       i2c_callback_t cb, void *userdata);
+};
+
+/** I2C target from the devicetree */
+struct i2c_dt_spec {
+    const struct device *bus;       /**< I2C controller */
+    uint16_t addr;                  /**< Target address */
+};
+
+#define I2C_DT_SPEC_INST_GET(inst)                                   \
+    {                                                                \
+        .bus = DEVICE_DT_GET(DT_BUS(DT_DRV_INST(inst))),             \
+        .addr = DT_REG_ADDR(DT_DRV_INST(inst)),                      \
+    }
+
+static inline int i2c_transfer(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr) {
+    const struct i2c_driver_api *api = dev->api;
+
+    return api->transfer(dev, msgs, num_msgs, addr);
+}
+
+static inline int i2c_transfer_cb(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs,
+                                  uint16_t addr, i2c_callback_t cb, void *userdata) {
+    const struct i2c_driver_api *api = dev->api;
+
+    if (api->transfer_cb == NULL) {
+        return -ENOSYS;
+    }
+    return api->transfer_cb(dev, msgs, num_msgs, addr, cb, userdata);
+}
+
+static inline int i2c_transfer_cb_dt(const struct i2c_dt_spec *spec, struct i2c_msg *msgs, uint8_t num_msgs,
+                                     i2c_callback_t cb, void *userdata) {
+    return i2c_transfer_cb(spec->bus, msgs, num_msgs, spec->addr, cb, userdata);
+}
+
+static inline int i2c_write_dt(const struct i2c_dt_spec *spec, const uint8_t *buf, uint32_t num_bytes) {
+    struct i2c_msg msg = { (uint8_t *)buf, num_bytes, I2C_MSG_WRITE | I2C_MSG_STOP };
+
+    return i2c_transfer(spec->bus, &msg, 1, spec->addr);
+}
+
+static inline int i2c_write_read_dt(const struct i2c_dt_spec *spec, const void *write_buf, size_t num_write,
+                                    void *read_buf, size_t num_read) {
+    struct i2c_msg msgs[2] = {
+        { (uint8_t *)write_buf, (uint32_t)num_write, I2C_MSG_WRITE },
+        { (uint8_t *)read_buf, (uint32_t)num_read, I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP },
+    };
+
+    return i2c_transfer(spec->bus, msgs, 2, spec->addr);
+}
+
+static inline bool i2c_is_ready_dt(const struct i2c_dt_spec *spec) {
+    return device_is_ready(spec->bus);
+}
+
+#endif
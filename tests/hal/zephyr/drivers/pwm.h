@@ -0,0 +1,85 @@
+#ifndef HOST_ZEPHYR_DRIVERS_PWM_H
+#define HOST_ZEPHYR_DRIVERS_PWM_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+/**
+ * @file pwm.h
+ * @brief Host stand-in for <zephyr/drivers/pwm.h>.
+ *
+ * Converts nanoseconds to cycles and calls the driver the way Zephyr does,
+ * so that the PWM emulator of native_sim runs unchanged on the host.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+typedef uint16_t pwm_flags_t;
+
+#define PWM_POLARITY_NORMAL 0           /**< Active high */
+#define PWM_POLARITY_INVERTED (1 << 0)  /**< Active low */
+
+#define PWM_USEC(us) ((us) * 1000UL)
+#define PWM_MSEC(ms) (PWM_USEC(ms) * 1000UL)
+
+/** PWM driver API */
+struct pwm_driver_api {
+    int (*set_cycles)(const struct device *dev, uint32_t channel, uint32_t period_cycles,
+                      uint32_t pulse_cycles, pwm_flags_t flags);
+    int (*get_cycles_per_sec)(const struct device *dev, uint32_t channel, uint64_t *cycles);
+};
+
+/** PWM channel from the devicetree */
+struct pwm_dt_spec {
+    const struct device *dev;  /**< PWM controller */
+    uint32_t channel;          /**< Channel */
+    uint32_t period;           /**< Period (ns) */
+    pwm_flags_t flags;         /**< Polarity */
+};
+
+static inline int pwm_set_cycles(const struct device *dev, uint32_t channel, uint32_t period,
+                                 uint32_t pulse, pwm_flags_t flags) {
+    const struct pwm_driver_api *api = dev->api;
+
+    if (pulse > period) {
+        return -EINVAL;
+    }
+    return api->set_cycles(dev, channel, period, pulse, flags);
+}
+
+static inline int pwm_get_cycles_per_sec(const struct device *dev, uint32_t channel, uint64_t *cycles) {
+    const struct pwm_driver_api *api = dev->api;
+
+    return api->get_cycles_per_sec(dev, channel, cycles);
+}
+
+static inline int pwm_set(const struct device *dev, uint32_t channel, uint32_t period, uint32_t pulse,
+                          pwm_flags_t flags) {
+    uint64_t cycles;
+    int err = pwm_get_cycles_per_sec(dev, channel, &cycles);
+
+    if (err < 0) {
+        return err;
+    }
+
+    uint64_t period_cycles = (uint64_t)period * cycles / NSEC_PER_SEC;
+    uint64_t pulse_cycles = (uint64_t)pulse * cycles / NSEC_PER_SEC;
+    if (period_cycles > UINT32_MAX || pulse_cycles > UINT32_MAX) {
+        return -ENOTSUP;
+    }
+    return pwm_set_cycles(dev, channel, (uint32_t)period_cycles, (uint32_t)pulse_cycles, flags);
+}
+
+static inline int pwm_set_pulse_dt(const struct pwm_dt_spec *spec, uint32_t pulse) {
+    return pwm_set(spec->dev, spec->channel, spec->period, pulse, spec->flags);
+}
+
+static inline bool pwm_is_ready_dt(const struct pwm_dt_spec *spec) {
+    return device_is_ready(spec->dev);
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef HOST_ZEPHYR_DRIVERS_SENSOR_H
+#define HOST_ZEPHYR_DRIVERS_SENSOR_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/**
+ * @file sensor.h
+ * @brief Host stand-in for <zephyr/drivers/sensor.h> (fetch and get only).
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+/** Sensor channels */
+enum sensor_channel {
+    SENSOR_CHAN_AMBIENT_TEMP,       /**< Ambient temperature, °C */
+    SENSOR_CHAN_ALL,                /**< Every channel */
+};
+
+/** Sensor reading: val1 + val2 / 1000000 */
+struct sensor_value {
+    int32_t val1;                   /**< Integer part */
+    int32_t val2;                   /**< Fractional part, in millionths */
+};
+
+/** Sensor driver API */
+struct sensor_driver_api {
+    int (*sample_fetch)(const struct device *dev, enum sensor_channel chan);
+    int (*channel_get)(const struct device *dev, enum sensor_channel chan, struct sensor_value *val);
+};
+
+static inline int sensor_sample_fetch(const struct device *dev) {
+    const struct sensor_driver_api *api = dev->api;
+
+    return api->sample_fetch(dev, SENSOR_CHAN_ALL);
+}
+
+static inline int sensor_channel_get(const struct device *dev, enum sensor_channel chan,
+                                     struct sensor_value *val) {
+    const struct sensor_driver_api *api = dev->api;
+
+    return api->channel_get(dev, chan, val);
+}
+
+#endif
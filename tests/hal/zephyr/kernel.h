@@ -0,0 +1,137 @@
+#ifndef HOST_ZEPHYR_KERNEL_H
+#define HOST_ZEPHYR_KERNEL_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @file kernel.h
+ * @brief Host stand-in for the parts of <zephyr/kernel.h> used by src/modules.
+ *
+ * Lets the unit tests and host tools compile the production modules
+ * unchanged: k_mutex maps to a pthread mutex and k_uptime_get() to the
+ * monotonic clock. Timeouts are ignored, every lock waits forever.
+ * k_spinlock is a plain test-and-set spinlock. k_sem is a polled counter
+ * and its timeout, in ms, is honoured.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+/** Kernel timeout in ms (only k_sem_take() honours it) */
+typedef struct {
+    int64_t ticks;
+} k_timeout_t;
+
+#define K_FOREVER ((k_timeout_t){ -1 })
+#define K_NO_WAIT ((k_timeout_t){ 0 })
+#define K_MSEC(ms) ((k_timeout_t){ (ms) })
+
+#define NSEC_PER_MSEC 1000000U       /**< Nanoseconds per millisecond */
+#define NSEC_PER_SEC 1000000000U     /**< Nanoseconds per second */
+
+#define BUILD_ASSERT(cond, msg) _Static_assert(cond, msg)
+
+/** Kernel mutex backed by a pthread mutex (zero-initialised statics work too) */
+struct k_mutex {
+    pthread_mutex_t m;
+};
+
+static inline int k_mutex_init(struct k_mutex *mutex) {
+    return pthread_mutex_init(&mutex->m, NULL);
+}
+
+static inline int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout) {
+    (void)timeout;
+    return pthread_mutex_lock(&mutex->m);
+}
+
+static inline int k_mutex_unlock(struct k_mutex *mutex) {
+    return pthread_mutex_unlock(&mutex->m);
+}
+
+/** Spinlock (zero-initialised means unlocked) */
+struct k_spinlock {
+    bool locked;
+};
+
+typedef int k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l) {
+    while (__atomic_test_and_set(&l->locked, __ATOMIC_ACQUIRE)) {
+    }
+    return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key) {
+    (void)key;
+    __atomic_clear(&l->locked, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Milliseconds elapsed on the monotonic clock.
+ */
+static inline int64_t k_uptime_get(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static inline uint32_t k_uptime_get_32(void) {
+    return (uint32_t)k_uptime_get();
+}
+
+/** Counting semaphore, given from any thread (e.g. a bus completion) */
+struct k_sem {
+    long count;
+    long limit;
+};
+
+#define K_SEM_DEFINE(name, initial, max) struct k_sem name = { (initial), (max) }
+
+static inline void k_sem_give(struct k_sem *sem) {
+    long count = __atomic_load_n(&sem->count, __ATOMIC_RELAXED);
+
+    while (count < sem->limit && !__atomic_compare_exchange_n(&sem->count, &count, count + 1, false,
+                                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+static inline void k_sem_reset(struct k_sem *sem) {
+    __atomic_store_n(&sem->count, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Takes the semaphore, polling every 100 µs until the timeout.
+ * @return 0, -EBUSY with K_NO_WAIT or -EAGAIN on timeout.
+ */
+static inline int k_sem_take(struct k_sem *sem, k_timeout_t timeout) {
+    const struct timespec poll = { 0, 100000 };
+    int64_t deadline = k_uptime_get() + timeout.ticks;
+
+    for (;;) {
+        long count = __atomic_load_n(&sem->count, __ATOMIC_ACQUIRE);
+        if (count > 0) {
+            if (__atomic_compare_exchange_n(&sem->count, &count, count - 1, false,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return 0;
+            }
+            continue;
+        }
+        if (timeout.ticks == 0) {
+            return -EBUSY;
+        }
+        if (timeout.ticks > 0 && k_uptime_get() >= deadline) {
+            return -EAGAIN;
+        }
+        nanosleep(&poll, NULL);
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef HOST_ZEPHYR_SYS_ATOMIC_H
+#define HOST_ZEPHYR_SYS_ATOMIC_H
+
+#include <stdbool.h>
+
+/**
+ * @file atomic.h
+ * @brief Host stand-in for <zephyr/sys/atomic.h>, on the GCC __atomic builtins.
+ *
+ * Same semantics as Zephyr with CONFIG_ATOMIC_OPERATIONS_BUILTIN: every
+ * operation is sequentially consistent.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+typedef long atomic_t;
+typedef atomic_t atomic_val_t;
+
+static inline atomic_val_t atomic_get(const atomic_t *target) {
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_clear(atomic_t *target) {
+    return atomic_set(target, 0);
+}
+
+static inline atomic_val_t atomic_add(atomic_t *target, atomic_val_t value) {
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t *target) {
+    return atomic_add(target, 1);
+}
+
+static inline bool atomic_cas(atomic_t *target, atomic_val_t old_value, atomic_val_t new_value) {
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef HOST_ZEPHYR_SYS_BARRIER_H
+#define HOST_ZEPHYR_SYS_BARRIER_H
+
+/**
+ * @file barrier.h
+ * @brief Host stand-in for <zephyr/sys/barrier.h>.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+static inline void barrier_dmem_fence_full(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif
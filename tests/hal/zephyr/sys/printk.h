@@ -0,0 +1,17 @@
+#ifndef HOST_ZEPHYR_SYS_PRINTK_H
+#define HOST_ZEPHYR_SYS_PRINTK_H
+
+#include <stdio.h>
+
+/**
+ * @file printk.h
+ * @brief Host stand-in for <zephyr/sys/printk.h>: printk() is printf().
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define printk printf
+
+#endif
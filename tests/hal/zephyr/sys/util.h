@@ -0,0 +1,32 @@
+#ifndef HOST_ZEPHYR_SYS_UTIL_H
+#define HOST_ZEPHYR_SYS_UTIL_H
+
+/**
+ * @file util.h
+ * @brief Host stand-in for the macros of <zephyr/sys/util.h> used by src/modules.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef CLAMP
+#define CLAMP(val, low, high) (((val) <= (low)) ? (low) : MIN(val, high))
+#endif
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#endif
+#ifndef ARG_UNUSED
+#define ARG_UNUSED(x) (void)(x)
+#endif
+#ifndef BIT
+#define BIT(n) (1UL << (n))
+#endif
+
+#endif
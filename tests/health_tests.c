@@ -0,0 +1,120 @@
+#include "unity.h"
+#include "health.h"
+
+
+/** \file health_tests.c
+*   \brief Unit tests of the task health monitor
+**
+*        Checks the deadline-miss counters and the heartbeat timeout
+*       that gates the hardware watchdog
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+    health_init();
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test only responses past the deadline of a monitored task count as misses
+ */
+void test_Health_DeadlineMisses(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Deadline-Miss Counting  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────╯\n");
+
+    health_set_deadline(TASK_PID, 50, 0);
+
+    // Finishing exactly at the deadline is on time
+    health_job_done(TASK_PID, 30, 100);
+    health_job_done(TASK_PID, 50, 150);
+    TEST_ASSERT_EQUAL(0, health_get_misses(TASK_PID));
+
+    health_job_done(TASK_PID, 51, 200);
+    TEST_ASSERT_EQUAL(1, health_get_misses(TASK_PID));
+
+    // Overruns reported by the timers add up with the late jobs
+    health_add_misses(TASK_PID, 3);
+    printf("   ─> PID misses: %u\n", health_get_misses(TASK_PID));
+    TEST_ASSERT_EQUAL(4, health_get_misses(TASK_PID));
+
+    // Unmonitored tasks never miss, invalid tasks are ignored
+    health_job_done(TASK_HEATER, 1000, 200);
+    TEST_ASSERT_EQUAL(0, health_get_misses(TASK_HEATER));
+    health_add_misses(TASK_COUNT, 5);
+    health_job_done(-1, 1000, 200);
+    TEST_ASSERT_EQUAL(0, health_get_misses(TASK_COUNT));
+    TEST_ASSERT_EQUAL(0, health_get_misses(-1));
+
+    // Initialising again clears the counters
+    health_init();
+    TEST_ASSERT_EQUAL(0, health_get_misses(TASK_PID));
+    printf("   ─> Test passed: Late jobs count as deadline misses\n\n");
+}
+
+/**
+ * @brief Test a task is stalled after HEALTH_HEARTBEAT_FACTOR deadlines without checking in, across an uptime wrap
+ */
+void test_Health_AliveTimeout(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Heartbeat Timeout  === == - │\n");
+    printf(" ╰────────────────────────────────────────────╯\n");
+
+    // Nothing monitored: always alive
+    TEST_ASSERT_TRUE(health_all_alive(1000000));
+
+    // 100 ms deadline registered at 1 s: stalled once more than 200 ms go by
+    health_set_deadline(TASK_SENSOR, 100, 1000);
+    TEST_ASSERT_TRUE(health_all_alive(1000 + HEALTH_HEARTBEAT_FACTOR * 100));
+    TEST_ASSERT_FALSE(health_all_alive(1001 + HEALTH_HEARTBEAT_FACTOR * 100));
+    printf("   ─> Sensor alive at 1200 ms: %d, at 1201 ms: %d\n", health_all_alive(1200), health_all_alive(1201));
+
+    // Checking in or finishing a job restarts the timeout
+    health_checkin(TASK_SENSOR, 1300);
+    TEST_ASSERT_TRUE(health_all_alive(1500));
+    health_job_done(TASK_SENSOR, 10, 1600);
+    TEST_ASSERT_TRUE(health_all_alive(1800));
+    TEST_ASSERT_FALSE(health_all_alive(1801));
+
+    // One stalled task is enough; a zero deadline stops monitoring it
+    health_set_deadline(TASK_LED, 500, 1000);
+    TEST_ASSERT_FALSE(health_all_alive(1900));
+    health_set_deadline(TASK_SENSOR, 0, 1900);
+    TEST_ASSERT_TRUE(health_all_alive(1900));
+
+    // The elapsed time survives the uptime counter wrapping around
+    health_init();
+    health_set_deadline(TASK_PID, 200, 0xFFFFFF00u);
+    TEST_ASSERT_TRUE(health_all_alive(0x50));
+    TEST_ASSERT_FALSE(health_all_alive(0x91));
+    printf("   ─> Test passed: Stalled tasks are detected\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Health_DeadlineMisses);
+    RUN_TEST(test_Health_AliveTimeout);
+
+    return UNITY_END();
+}
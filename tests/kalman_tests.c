@@ -0,0 +1,88 @@
+#include <math.h>
+#include "unity.h"
+#include "kalman.h"
+#include "sim.h"
+
+
+/** \file kalman_tests.c
+*   \brief Unit tests of the Kalman temperature estimate
+**
+*        Runs the estimator on the plant model, with the whole-degree
+*       reads of the TC74, and compares its error with the sensor's
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the estimate tracks the plant closer than the rounded reads under a square wave
+ */
+void test_Kalman_SquareWaveOnPlant(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────────╮\n");
+    printf(" │ - == === Test Kalman Temperature Estimate === == - │\n");
+    printf(" ╰────────────────────────────────────────────────────╯\n");
+
+    struct plant_params params;
+    struct plant_estimate model;
+    struct plant plant;
+    struct kalman k;
+    uint16_t input = 0;
+    double est_err2 = 0.0, read_err2 = 0.0;
+    int n = 0;
+
+    sim_default_plant(&params);
+    sim_plant_model(&params, &model);
+    plant_init(&plant, &params);
+    kalman_init(&k, KALMAN_R_WHOLE_DEGREE, KALMAN_Q_TEMP, KALMAN_Q_OFFSET);
+    kalman_set_model(&k, &model);
+
+    // Heater on for a minute, off for a minute; predict every 125 ms, read every 250 ms
+    for (int step = 0; step < 8 * 600; step++) {
+        float temp = plant_temp_mdeg(&plant) / 1000.0f;
+        kalman_predict(&k, input / 1000.0f, 0.125f);
+        if (step % 2 == 0) {
+            kalman_correct(&k, roundf(temp));
+        }
+        if (step >= 8 * 120) {
+            est_err2 += (k.temp - temp) * (k.temp - temp);
+            read_err2 += (roundf(temp) - temp) * (roundf(temp) - temp);
+            n++;
+        }
+        input = sim_square_step(&plant, 60000, 125);
+    }
+
+    float est_rms = sqrtf(est_err2 / n), read_rms = sqrtf(read_err2 / n);
+    printf("   ─> Estimate error: %.3f C rms, sensor error: %.3f C rms\n", est_rms, read_rms);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f * read_rms, est_rms);
+    printf("   ─> Test passed: Estimate closer to the plant than the sensor\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Kalman_SquareWaveOnPlant);
+
+    return UNITY_END();
+}
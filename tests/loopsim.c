@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim.h"
+
+
+/** \file loopsim.c
+*   \brief Accelerated closed-loop simulation of the temperature controller
+**
+*        Runs the firmware control chain (sim.c) on the plant model and
+*       prints the step response metrics as JSON. With -t, the trace is
+*       written as CSV for plotting. -O selects the heater output stage,
+*       as CONFIG_APP_HEATER_OUTPUT does in the firmware, and -m the
+*       switching limits of the FET. -c selects the control strategy, as
+*       CONFIG_APP_CONTROLLER or #K do. -A starts with a relay autotune, as
+*       #U1 does, and reports its result; the run goes on with its gains.
+*       -G loads a gain schedule, as #B does, indexed by the setpoint (s)
+*       or the temperature (t), with a temperature and three gains per
+*       point. -P runs a setpoint profile from the start, as #F and #O1
+*       do, with a ramp rate, a target and a hold time per segment. -M
+*       sets the move weight of the MPC (-c mpc), which plans on the
+*       default model until the identification takes over.
+**
+*        Usage: loopsim [-s setpoint °C] [-d duration s] [-p period ms]
+*                       [-o oversample] [-f none|avg|median|iir] [-l length/shift]
+*                       [-e steps per read] [-k kp,ki,kd]
+*                       [-G s|t,temp °C,kp,ki,kd,...]
+*                       [-P rate °C/min,target °C,hold s,...]
+*                       [-c onoff|pi|pid|pid2dof|mpc]
+*                       [-H hysteresis °C] [-B setpoint weight] [-M move weight]
+*                       [-A] [-R relay band °C]
+*                       [-O onoff|tpo|pwm] [-w window ms]
+*                       [-n slots] [-W pwm period ms] [-F full scale]
+*                       [-m min on ms,min off ms,switches/min]
+*                       [-a ambient °C] [-g gain °C]
+*                       [-T tau s] [-D dead time s] [-b band °C]
+*                       [-t trace.csv] [-i trace interval ms]
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+static const char *filter_names[] = {
+    [FILTER_NONE] = "none",
+    [FILTER_MOVING_AVG] = "avg",
+    [FILTER_MEDIAN] = "median",
+    [FILTER_IIR] = "iir",
+};
+
+
+static const char *output_names[] = {
+    [SIM_OUTPUT_ONOFF] = "onoff",
+    [SIM_OUTPUT_TPO] = "tpo",
+    [SIM_OUTPUT_PWM] = "pwm",
+};
+
+
+static const char *tune_states[] = {
+    [AUTOTUNE_IDLE] = "idle",
+    [AUTOTUNE_RUNNING] = "running",
+    [AUTOTUNE_DONE] = "done",
+    [AUTOTUNE_FAILED] = "failed",
+};
+
+
+static int parse_output(const char *name, enum sim_output *output) {
+    for (int k = 0; k < (int)(sizeof(output_names) / sizeof(output_names[0])); k++) {
+        if (strcmp(name, output_names[k]) == 0) {
+            *output = (enum sim_output)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+
+static int parse_controller(const char *name, enum controller_type *type) {
+    for (int k = 0; k < CONTROLLER_COUNT; k++) {
+        if (strcmp(name, controller_get((enum controller_type)k)->name) == 0) {
+            *type = (enum controller_type)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+
+static int parse_schedule(const char *arg, struct gain_schedule *gs) {
+    char key;
+    int used;
+
+    memset(gs, 0, sizeof(*gs));
+    if (sscanf(arg, "%c%n", &key, &used) != 1 || (key != 's' && key != 't')) {
+        return -1;
+    }
+    gs->key = (key == 't') ? GAINSCHED_TEMP : GAINSCHED_SETPOINT;
+    arg += used;
+
+    while (*arg != '\0') {
+        struct gain_point *p = &gs->points[gs->count];
+        if (gs->count == GAINSCHED_MAX ||
+            sscanf(arg, ",%f,%f,%f,%f%n", &p->temp_c, &p->kp, &p->ki, &p->kd, &used) != 4) {
+            return -1;
+        }
+        gs->count++;
+        arg += used;
+    }
+    return gainsched_check(gs);
+}
+
+
+static int parse_profile(const char *arg, struct profile *prog) {
+    int used;
+
+    memset(prog, 0, sizeof(*prog));
+    while (*arg != '\0') {
+        struct profile_segment *seg = &prog->segments[prog->count];
+        float hold_s;
+        if (prog->count == PROFILE_MAX ||
+            sscanf(arg, "%f,%f,%f%n", &seg->rate, &seg->target_c, &hold_s, &used) != 3 || hold_s < 0.0f) {
+            return -1;
+        }
+        seg->hold_ms = (uint32_t)(hold_s * 1000.0f);
+        prog->count++;
+        arg += used;
+        if (*arg == ',') {
+            arg++;
+        }
+    }
+    return profile_check(prog);
+}
+
+
+static int parse_filter(const char *name, enum filter_type *type) {
+    for (int k = 0; k < (int)(sizeof(filter_names) / sizeof(filter_names[0])); k++) {
+        if (strcmp(name, filter_names[k]) == 0) {
+            *type = (enum filter_type)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s setpoint C] [-d duration s] [-p period ms] [-o oversample]\n"
+                    "          [-f none|avg|median|iir] [-l length, or shift for iir] [-e steps per read]\n"
+                    "          [-k kp,ki,kd] [-G s|t,temp C,kp,ki,kd,...]\n"
+                    "          [-P rate C/min,target C,hold s,...] [-c onoff|pi|pid|pid2dof|mpc]\n"
+                    "          [-H hysteresis C] [-B 2-DOF setpoint weight] [-M MPC move weight]\n"
+                    "          [-A autotune first] [-R relay band C]\n"
+                    "          [-O onoff|tpo|pwm] [-w window ms] [-n slots] [-W pwm period ms]\n"
+                    "          [-F PID output for full power] [-m min on ms,min off ms,switches/min]\n"
+                    "          [-a ambient C] [-g gain C] [-T tau s] [-D dead time s]\n"
+                    "          [-b band C] [-t trace.csv] [-i trace interval ms]\n", prog);
+}
+
+
+int main(int argc, char **argv) {
+    struct sim_config cfg;
+    struct sim_result res;
+    const char *trace_path = NULL;
+    int opt;
+
+    sim_default_config(&cfg);
+    cfg.trace_ms = 1000;
+
+    while ((opt = getopt(argc, argv, "s:d:p:o:f:l:e:k:G:P:c:H:B:M:AR:O:w:n:W:F:m:a:g:T:D:b:t:i:h")) != -1) {
+        switch (opt) {
+            case 's': cfg.setpoint = atoi(optarg); break;
+            case 'd': cfg.duration_ms = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'p': cfg.period_ms = (uint32_t)atoi(optarg); break;
+            case 'o': cfg.oversample = atoi(optarg); break;
+            case 'l': cfg.filter_len = atoi(optarg); cfg.filter_shift = atoi(optarg); break;
+            case 'e': cfg.kalman_divider = atoi(optarg); break;
+            case 'H': cfg.hysteresis = (float)atof(optarg); break;
+            case 'B': cfg.beta = (float)atof(optarg); break;
+            case 'M': cfg.move_weight = (float)atof(optarg); break;
+            case 'A': cfg.autotune = true; break;
+            case 'R': cfg.tune_hysteresis = (float)atof(optarg); break;
+            case 'w': cfg.window_ms = (uint32_t)atoi(optarg); break;
+            case 'n': cfg.slots = (uint16_t)atoi(optarg); break;
+            case 'W': cfg.pwm_period_ms = (uint32_t)atoi(optarg); break;
+            case 'F': cfg.full_scale = (float)atof(optarg); break;
+            case 'a': cfg.plant.ambient_mdeg = (int32_t)(atof(optarg) * 1000.0); break;
+            case 'g': cfg.plant.gain_mdeg = (int32_t)(atof(optarg) * 1000.0); break;
+            case 'T': cfg.plant.tau_ms = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'D': cfg.plant.dead_ms = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'b': cfg.band_mdeg = (int32_t)(atof(optarg) * 1000.0); break;
+            case 't': trace_path = optarg; break;
+            case 'i': cfg.trace_ms = (uint32_t)atoi(optarg); break;
+            case 'f':
+                if (parse_filter(optarg, &cfg.filter) != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'c':
+                if (parse_controller(optarg, &cfg.controller) != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'O':
+                if (parse_output(optarg, &cfg.output) != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'k':
+                if (sscanf(optarg, "%f,%f,%f", &cfg.kp, &cfg.ki, &cfg.kd) != 3) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'G':
+                if (parse_schedule(optarg, &cfg.schedule) != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'P':
+                if (parse_profile(optarg, &cfg.profile) != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'm': {
+                unsigned min_on, min_off, max_per_min;
+                if (sscanf(optarg, "%u,%u,%u", &min_on, &min_off, &max_per_min) != 3) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                cfg.governor.min_on_ms = min_on;
+                cfg.governor.min_off_ms = min_off;
+                cfg.governor.max_per_min = (uint16_t)max_per_min;
+                break;
+            }
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    FILE *trace = NULL;
+    if (trace_path != NULL) {
+        trace = fopen(trace_path, "w");
+        if (trace == NULL) {
+            perror(trace_path);
+            return 1;
+        }
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int ret = sim_run(&cfg, &res, trace);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (trace != NULL) {
+        fclose(trace);
+    }
+    if (ret != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    double wall_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    printf("{\n  \"setpoint_c\": %d,\n  \"controller\": \"%s\",\n  \"kp\": %g,\n  \"ki\": %g,\n  \"kd\": %g,\n"
+           "  \"period_ms\": %u,\n  \"oversample\": %d,\n  \"filter\": \"%s\",\n  \"kalman_divider\": %d,\n"
+           "  \"output\": \"%s\",\n  \"window_ms\": %u,\n  \"slots\": %u,\n"
+           "  \"pwm_period_ms\": %u,\n  \"full_scale\": %g,\n"
+           "  \"min_on_ms\": %u,\n  \"min_off_ms\": %u,\n  \"max_switches_per_min\": %u,\n"
+           "  \"simulated_s\": %.1f,\n  \"wall_ms\": %.3f,\n  \"speedup\": %.0f,\n"
+           "  \"rise_time_s\": %.2f,\n  \"settling_time_s\": %.2f,\n"
+           "  \"overshoot_c\": %.3f,\n  \"overshoot_pct\": %.2f,\n  \"iae\": %.1f,\n"
+           "  \"final_error_c\": %.3f,\n  \"duty\": %.4f,\n  \"final_duty\": %.4f,\n"
+           "  \"switches\": %u,\n  \"suppressed\": %u",
+           cfg.setpoint, controller_get(cfg.controller)->name, cfg.kp, cfg.ki, cfg.kd,
+           (unsigned)cfg.period_ms, cfg.oversample,
+           filter_names[cfg.filter], cfg.kalman_divider, output_names[cfg.output], (unsigned)cfg.window_ms,
+           (unsigned)cfg.slots, (unsigned)cfg.pwm_period_ms, cfg.full_scale,
+           (unsigned)cfg.governor.min_on_ms, (unsigned)cfg.governor.min_off_ms,
+           (unsigned)cfg.governor.max_per_min,
+           cfg.duration_ms / 1000.0, wall_ms,
+           (wall_ms > 0.0) ? cfg.duration_ms / wall_ms : 0.0,
+           res.rise_time_s, res.settling_time_s, res.overshoot_c, res.overshoot_pct, res.iae,
+           res.final_error_c, res.duty, res.final_duty, (unsigned)res.switches, (unsigned)res.suppressed);
+    if (cfg.autotune) {
+        printf(",\n  \"autotune\": { \"state\": \"%s\", \"end_s\": %.2f, \"cycles\": %u,"
+               " \"ku\": %.3f, \"tu_s\": %.2f, \"kp\": %.3f, \"ki\": %.4f, \"kd\": %.3f }",
+               tune_states[res.tune.state], res.tune_end_s, (unsigned)res.tune.cycles,
+               res.tune.ku, res.tune.tu, res.tune.kp, res.tune.ki, res.tune.kd);
+    }
+    if (cfg.profile.count > 0) {
+        printf(",\n  \"profile\": { \"segments\": %u, \"end_s\": %.2f }",
+               (unsigned)cfg.profile.count, res.profile_end_s);
+    }
+    printf(",\n  \"plant_estimate\": { \"valid\": %s, \"gain_c\": %.2f, \"tau_s\": %.1f,"
+           " \"dead_s\": %.1f, \"ambient_c\": %.2f, \"rms_c\": %.3f }",
+           res.plant_est.valid ? "true" : "false", res.plant_est.gain_c, res.plant_est.tau_s,
+           res.plant_est.dead_s, res.plant_est.ambient_c, res.plant_est.rms_c);
+    printf("\n}\n");
+    return 0;
+}
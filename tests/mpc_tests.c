@@ -0,0 +1,90 @@
+#include <math.h>
+#include "unity.h"
+#include "mpc.h"
+#include "sim.h"
+
+
+/** \file mpc_tests.c
+*   \brief Unit tests of the model-predictive controller
+**
+*        Closes the loop of the MPC on the plant model with a long dead
+*       time, and checks when its gains are computed again
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the MPC settles a long dead time plant with no overshoot, clamps its output and keeps its gains
+ */
+void test_MPC_LongDeadTimeOnPlant(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────────────╮\n");
+    printf(" │ - == === Test MPC on a Long Dead Time Plant === == - │\n");
+    printf(" ╰──────────────────────────────────────────────────────╯\n");
+
+    struct plant_params params;
+    struct plant_estimate model;
+    struct plant plant;
+    struct mpc m;
+    float peak = 0.0f, temp = 0.0f;
+
+    // Default plant with a 10 s dead time, and its exact model
+    sim_default_plant(&params);
+    params.dead_ms = 10000;
+    sim_plant_model(&params, &model);
+    plant_init(&plant, &params);
+    mpc_init(&m);
+    mpc_set_model(&m, &model, 1.0f, MPC_MOVE_WEIGHT);
+
+    // Step from ambient to 40 C, 20 minutes at 250 ms
+    for (int step = 0; step < 4 * 1200; step++) {
+        temp = plant_temp_mdeg(&plant) / 1000.0f;
+        float output = mpc_calculate(&m, 40.0f, temp, 0.25f);
+
+        TEST_ASSERT_TRUE(output >= 0.0f && output <= 1.0f);
+        peak = fmaxf(peak, temp);
+        plant_set_input(&plant, (uint16_t)(output * 1000.0f + 0.5f));
+        plant_step(&plant, 250);
+    }
+    printf("   ─> Peak: %.2f C, final: %.2f C\n", peak, temp);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 40.0f, peak);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 40.0f, temp);
+    TEST_ASSERT_EQUAL(40, m.delay);
+
+    // Same model again: the gains are kept; a new one computes them again
+    mpc_set_model(&m, &model, 1.0f, MPC_MOVE_WEIGHT);
+    TEST_ASSERT_EQUAL_FLOAT(0.25f, m.dt);
+    mpc_set_model(&m, &model, 1.0f, 2.0f * MPC_MOVE_WEIGHT);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, m.dt);
+    printf("   ─> Test passed: No overshoot, no offset, output clamped\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_MPC_LongDeadTimeOnPlant);
+
+    return UNITY_END();
+}
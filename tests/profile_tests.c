@@ -0,0 +1,108 @@
+#include "unity.h"
+#include "profile.h"
+
+
+/** \file profile_tests.c
+*   \brief Unit tests of the setpoint profile executor
+**
+*        Runs a ramp/soak profile on a given clock: ramp position,
+*       holds, pause and resume, the end of the profile and stop
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test ramps, holds, pause and stop follow the clock, with no drift however often it is updated
+ */
+void test_Profile_RampHoldPause(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Setpoint Profile Executor  === == - │\n");
+    printf(" ╰────────────────────────────────────────────────────╯\n");
+
+    //  Ramp 20 -> 30 C at 10 C/min (60 s), hold 60 s, then step to 25 C and hold 30 s
+    const struct profile prog = {
+        .count = 2,
+        .segments = {
+            { 10.0f, 30.0f, 60000 },
+            { 0.0f, 25.0f, 30000 },
+        },
+    };
+    struct profile_run r, coarse;
+
+    TEST_ASSERT_EQUAL(0, profile_check(&prog));
+
+    // Halfway up the ramp, then at the target, holding
+    profile_start(&r, &prog, 20.0f, 1000);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 25.0f, profile_update(&r, 31000));
+    TEST_ASSERT_EQUAL(30000, r.status.remaining_ms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, profile_update(&r, 61000));
+    TEST_ASSERT_TRUE(r.status.holding);
+
+    // Paused from 91 s to 201 s: the setpoint and the hold stand still
+    profile_update(&r, 91000);
+    profile_pause(&r);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, profile_update(&r, 150000));
+    TEST_ASSERT_EQUAL(30000, r.status.remaining_ms);
+    profile_resume(&r, 201000);
+    profile_update(&r, 230000);
+    TEST_ASSERT_EQUAL(PROFILE_RUNNING, r.status.state);
+    TEST_ASSERT_EQUAL(1, r.status.remaining_ms / 1000);
+
+    // Step to 25 C, done after its 30 s hold
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 25.0f, profile_update(&r, 232000));
+    TEST_ASSERT_EQUAL(1, r.status.segment);
+    profile_update(&r, 262000);
+    printf("   ─> State %u at 262 s, setpoint %.2f C\n", r.status.state, r.status.setpoint_c);
+    TEST_ASSERT_EQUAL(PROFILE_DONE, r.status.state);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 25.0f, r.status.setpoint_c);
+
+    // Updating every 250 ms or once lands on the same setpoint: no drift
+    profile_start(&r, &prog, 20.0f, 0);
+    profile_start(&coarse, &prog, 20.0f, 0);
+    for (uint32_t t = 250; t <= 45000; t += 250) {
+        profile_update(&r, t);
+    }
+    profile_update(&coarse, 45000);
+    printf("   ─> Setpoint at 45 s: %.4f C in steps, %.4f C at once\n", r.status.setpoint_c, coarse.status.setpoint_c);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, coarse.status.setpoint_c, r.status.setpoint_c);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 27.5f, r.status.setpoint_c);
+
+    // Negative rates are rejected; stopping keeps the setpoint
+    struct profile bad = prog;
+    bad.segments[1].rate = -1.0f;
+    TEST_ASSERT_EQUAL(-1, profile_check(&bad));
+    profile_stop(&r);
+    TEST_ASSERT_EQUAL(PROFILE_IDLE, r.status.state);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 27.5f, profile_update(&r, 60000));
+    printf("   ─> Test passed: Ramps, holds, pause and stop follow the clock\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Profile_RampHoldPause);
+
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+#include <errno.h>
+#include "unity.h"
+#include "governor.h"
+#include "pwm_emul.h"
+#include <zephyr/drivers/pwm.h>
+
+
+/** \file pwm_emul_tests.c
+*   \brief Unit tests of the heater PWM output on the PWM emulator
+**
+*        Builds the native_sim PWM emulator against the device and PWM
+*       stand-ins of tests/hal, drives it the way heater_apply() and
+*       the supervisor fail safe of main.c do, and reads the duty back
+*       with pwm_emul_duty_get()
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/** heater-pwm of the native_sim overlay: channel 0, 100 ms */
+static const struct pwm_dt_spec heater_pwm = {
+    .dev = DEVICE_DT_INST_GET(0),
+    .channel = 0,
+    .period = PWM_MSEC(100),
+    .flags = PWM_POLARITY_NORMAL,
+};
+
+static struct governor fet_gov;
+static uint16_t heater_pulse;
+
+/**
+ * @brief Sets the PWM duty as pwm_set_duty() in main.c.
+ */
+static void pwm_set_duty(uint16_t duty) {
+    if (duty != heater_pulse) {
+        TEST_ASSERT_EQUAL(0, pwm_set_pulse_dt(&heater_pwm, (uint32_t)((uint64_t)heater_pwm.period * duty / 1000U)));
+        heater_pulse = duty;
+    }
+}
+
+/**
+ * @brief Applies a duty as heater_apply() in main.c, with the PWM output.
+ */
+static void heater_apply(uint16_t duty, uint32_t now_ms) {
+    pwm_set_duty(governor_duty(&fet_gov, duty, heater_pwm.period / NSEC_PER_MSEC, now_ms));
+}
+
+/**
+ * @brief Switches the heater off as fet_force_off() in main.c, with the PWM output.
+ */
+static void fet_force_off(uint32_t now_ms) {
+    governor_force_off(&fet_gov, now_ms);
+    pwm_set_duty(0);
+}
+
+/**
+ * @brief Sets up the heater output as heater_init() in main.c.
+ */
+static void heater_init(const struct governor_config *cfg) {
+    TEST_ASSERT_TRUE(pwm_is_ready_dt(&heater_pwm));
+    TEST_ASSERT_EQUAL(0, pwm_set_pulse_dt(&heater_pwm, 0));
+    heater_pulse = 0;
+    governor_init(&fet_gov, cfg, 0);
+    heater_apply(0, 0);
+}
+
+/**
+ * @brief Reads the heater duty back from the emulator.
+ */
+static uint16_t duty_get(void) {
+    uint16_t permille = 0xFFFF;
+
+    TEST_ASSERT_EQUAL(0, pwm_emul_duty_get(heater_pwm.dev, heater_pwm.channel, &permille));
+    return permille;
+}
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the emulator reports channels never set and out of range
+ */
+void test_PwmEmul_ChannelErrors(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Emulator Channel Errors  === == - │\n");
+    printf(" ╰──────────────────────────────────────────────────╯\n");
+
+    uint16_t permille;
+    TEST_ASSERT_EQUAL(-ENODATA, pwm_emul_duty_get(heater_pwm.dev, 1, &permille));
+    TEST_ASSERT_EQUAL(-EINVAL, pwm_emul_duty_get(heater_pwm.dev, 4, &permille));
+    TEST_ASSERT_EQUAL(-EINVAL, pwm_set_pulse_dt(&(struct pwm_dt_spec){ heater_pwm.dev, 4, PWM_MSEC(100), 0 }, 0));
+    printf("   ─> Test passed: Unset and out-of-range channels are rejected\n\n");
+}
+
+/**
+ * @brief Test the pulse width set by the heater output gives back the requested duty, and the polarity is honoured
+ */
+void test_PwmEmul_PulseWidth(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Heater Pulse Width  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    // No limits: the duty reaches the channel as requested
+    const struct governor_config none = { 0 };
+    heater_init(&none);
+    TEST_ASSERT_EQUAL(0, duty_get());
+
+    const uint16_t duties[] = { 1, 250, 333, 999, 1000 };
+    for (size_t i = 0; i < sizeof(duties) / sizeof(duties[0]); i++) {
+        heater_apply(duties[i], 100 * i);
+        printf("   ─> Duty %4u ‰: %4u ‰ read back\n", duties[i], duty_get());
+        TEST_ASSERT_EQUAL(duties[i], duty_get());
+    }
+
+    // An active-low channel is high for the rest of the period
+    const struct pwm_dt_spec inverted = { heater_pwm.dev, 2, PWM_MSEC(100), PWM_POLARITY_INVERTED };
+    uint16_t permille;
+    TEST_ASSERT_EQUAL(0, pwm_set_pulse_dt(&inverted, PWM_MSEC(30)));
+    TEST_ASSERT_EQUAL(0, pwm_emul_duty_get(inverted.dev, inverted.channel, &permille));
+    TEST_ASSERT_EQUAL(700, permille);
+    printf("   ─> Test passed: The pulse width follows the duty\n\n");
+}
+
+/**
+ * @brief Test the default governor limits (10 ms on the 100 ms period) round the pulse width
+ */
+void test_PwmEmul_GovernedPulseWidth(void) {
+    printf("\n");
+    printf(" ╭───────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Governed Pulse Width  === == - │\n");
+    printf(" ╰───────────────────────────────────────────────╯\n");
+
+    const struct governor_config cfg = { .min_on_ms = 10, .min_off_ms = 10, .max_per_min = 0 };
+    heater_init(&cfg);
+
+    heater_apply(40, 0);
+    TEST_ASSERT_EQUAL(0, duty_get());
+    heater_apply(70, 100);
+    TEST_ASSERT_EQUAL(100, duty_get());
+    heater_apply(420, 200);
+    TEST_ASSERT_EQUAL(420, duty_get());
+    heater_apply(930, 300);
+    TEST_ASSERT_EQUAL(900, duty_get());
+    heater_apply(970, 400);
+    TEST_ASSERT_EQUAL(1000, duty_get());
+    printf("   ─> Rounded: %u, switches: %u\n", (unsigned)fet_gov.stats.suppressed, (unsigned)fet_gov.stats.switches);
+    printf("   ─> Test passed: No pulse or gap is shorter than 10 ms\n\n");
+}
+
+/**
+ * @brief Test the supervisor fail safe leaves the channel at 0, even while the governor holds the heater on
+ */
+void test_PwmEmul_FailsafeOff(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Fail-Safe Pulse Width  === == - │\n");
+    printf(" ╰────────────────────────────────────────────────╯\n");
+
+    // Minimums longer than the period: the output runs on/off, fully on here
+    const struct governor_config cfg = { .min_on_ms = 1000, .min_off_ms = 1000, .max_per_min = 0 };
+    heater_init(&cfg);
+    heater_apply(800, 0);
+    TEST_ASSERT_EQUAL(1000, duty_get());
+
+    // The controller asking for 0 is held back by the minimum on time...
+    heater_apply(0, 200);
+    TEST_ASSERT_EQUAL(1000, duty_get());
+
+    // ...the supervisor, as in supervisor_tick(), is not
+    heater_apply(0, 300);
+    fet_force_off(300);
+    printf("   ─> Duty after the fail safe: %u ‰\n", duty_get());
+    TEST_ASSERT_EQUAL(0, duty_get());
+
+    // Same from a pulsing output
+    const struct governor_config pwm_cfg = { .min_on_ms = 10, .min_off_ms = 10, .max_per_min = 0 };
+    heater_init(&pwm_cfg);
+    heater_apply(650, 0);
+    TEST_ASSERT_EQUAL(650, duty_get());
+    heater_apply(0, 100);
+    fet_force_off(100);
+    TEST_ASSERT_EQUAL(0, duty_get());
+    TEST_ASSERT_EQUAL(0, fet_gov.duty);
+    printf("   ─> Test passed: The fail safe leaves the FET off\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_PwmEmul_ChannelErrors);
+    RUN_TEST(test_PwmEmul_PulseWidth);
+    RUN_TEST(test_PwmEmul_GovernedPulseWidth);
+    RUN_TEST(test_PwmEmul_FailsafeOff);
+
+    return UNITY_END();
+}
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "rtdb.h"
+#include "sched.h"
+
+
+/** \file rtdb_stress.c
+*   \brief Multi-threaded stress and contention test of the RTDB
+**
+*        Hammers the RTDB from reader and writer threads that follow the
+*       access pattern of the firmware tasks, checks that no reader ever
+*       sees a half-written group, and reports the throughput and the
+*       extra time per call caused by contention, as JSON on stdout.
+**
+*        The same source is built once per synchronisation backend
+*       (CONFIG_APP_RTDB_MUTEX, _SEQLOCK or _ATOMIC); compare the outputs
+*       of rtdb_stress_mutex, rtdb_stress_seqlock and rtdb_stress_atomic.
+**
+*        Usage: rtdb_stress [readers] [writers] [duration ms]
+**
+*        Writer roles, assigned in turn: sensor (current temperature and
+*       sensor status), uart (PID gains, setpoint, periods, verbose) and
+*       heater (heater state and latency). Reader roles: controller, led
+*       and status (the UART queries). The default of 3 readers and 2
+*       writers gives the five firmware threads.
+**
+*        Invariants checked by the readers:
+*        - the PID gains are always (k, 2k, 3k) as written by the uart role;
+*        - the sensor counters are always (n, 2n, 3n) with ok == n & 1;
+*        - the latency average and last value never exceed the maximum;
+*        - with one sensor writer, the temperature never goes backwards.
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+#if defined(CONFIG_APP_RTDB_SEQLOCK)
+#define BACKEND "seqlock"
+#elif defined(CONFIG_APP_RTDB_ATOMIC)
+#define BACKEND "atomic"
+#else
+#define BACKEND "mutex"
+#endif
+
+#define MAX_THREADS 32              /**< Readers plus writers */
+#define BATCH 64                    /**< Role iterations per timestamp */
+#define BASELINE_NS 20000000LL      /**< Single-thread run per role for the uncontended figure */
+
+enum role_kind { READER, WRITER };
+
+/** Per-thread state and results */
+struct worker {
+    pthread_t thread;
+    enum role_kind kind;
+    int role;
+    unsigned long n;                /**< Iterations done (also the value written) */
+    unsigned long ops;              /**< RTDB calls done */
+    long long busy_ns;              /**< Time spent in the role loop */
+    unsigned long violations;       /**< Invariant violations seen */
+    int32_t last_mdeg;              /**< Last temperature read (monotonic check) */
+    double baseline_ns;             /**< Uncontended ns per call of this role */
+};
+
+static struct worker workers[MAX_THREADS];
+static pthread_barrier_t start_barrier;
+static volatile int stop;
+static int sensor_writers;
+
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+/* === Writer roles === */
+
+/* Sensor task: filtered temperature and bus status */
+static int write_sensor(struct worker *w) {
+    unsigned long n = ++w->n;
+    struct rtdb_sensor_status status = {
+        .ok = n & 1,
+        .timeouts = (uint32_t)n,
+        .retries = (uint32_t)(2 * n),
+        .failures = (uint32_t)(3 * n),
+    };
+
+    rtdb_set_current_temp_mdeg((int32_t)(n & 0x3fffffff));
+    rtdb_set_sensor_status(&status);
+    return 2;
+}
+
+/* UART task: commands that change the configuration */
+static int write_uart(struct worker *w) {
+    unsigned long n = ++w->n;
+    float k = (float)(n % 1000000 + 1);
+
+    rtdb_set_PID_params(k, 2.0f * k, 3.0f * k);
+    rtdb_set_desired_temp((int)(n & 63));
+    rtdb_set_task_period((int)(n % TASK_COUNT), 10 + (uint32_t)(n & 1023));
+    rtdb_set_verbose(n & 1);
+    return 4;
+}
+
+/* Heater task: output state and sample-to-actuation latency */
+static int write_heater(struct worker *w) {
+    unsigned long n = ++w->n;
+
+    rtdb_set_heat_on(n & 1);
+    rtdb_add_latency((uint32_t)(n & 4095));
+    return 2;
+}
+
+
+/* === Reader roles === */
+
+/* Controller: temperatures, gains and sensor health */
+static int read_controller(struct worker *w) {
+    float kp, ki, kd;
+    int32_t mdeg = rtdb_get_current_temp_mdeg();
+
+    if (sensor_writers == 1 && mdeg < w->last_mdeg) {
+        w->violations++;
+    }
+    w->last_mdeg = mdeg;
+
+    (void)rtdb_get_desired_temp();
+    rtdb_get_PID_params(&kp, &ki, &kd);
+    if (ki != 2.0f * kp || kd != 3.0f * kp) {
+        w->violations++;
+    }
+    (void)rtdb_get_sensor_ok();
+    w->n++;
+    return 4;
+}
+
+/* LED task: state shown on the board */
+static int read_led(struct worker *w) {
+    (void)rtdb_get_system_on();
+    (void)rtdb_get_current_temp();
+    (void)rtdb_get_desired_temp();
+    (void)rtdb_get_heat_on();
+    w->n++;
+    return 4;
+}
+
+/* UART queries: #I, #L, periods and verbose */
+static int read_status(struct worker *w) {
+    struct rtdb_sensor_status status;
+    uint32_t last, max, avg;
+
+    rtdb_get_sensor_status(&status);
+    if (status.retries != 2 * status.timeouts || status.failures != 3 * status.timeouts ||
+        status.ok != (status.timeouts & 1)) {
+        w->violations++;
+    }
+
+    rtdb_get_latency(&last, &max, &avg);
+    if (last > max || avg > max) {
+        w->violations++;
+    }
+
+    (void)rtdb_get_task_period((int)(w->n % TASK_COUNT));
+    (void)rtdb_get_verbose();
+    w->n++;
+    return 4;
+}
+
+typedef int (*role_fn)(struct worker *w);
+
+static const struct {
+    const char *name;
+    role_fn fn;
+} roles[2][3] = {
+    [READER] = { { "controller", read_controller }, { "led", read_led }, { "status", read_status } },
+    [WRITER] = { { "sensor", write_sensor }, { "uart", write_uart }, { "heater", write_heater } },
+};
+
+
+/**
+ * @brief Runs batches of a role until stop is set.
+ */
+static void run_role(struct worker *w) {
+    role_fn fn = roles[w->kind][w->role].fn;
+
+    while (!stop) {
+        long long t0 = now_ns();
+        for (int b = 0; b < BATCH; b++) {
+            w->ops += fn(w);
+        }
+        w->busy_ns += now_ns() - t0;
+    }
+}
+
+static void *worker_main(void *arg) {
+    struct worker *w = arg;
+
+    pthread_barrier_wait(&start_barrier);
+    run_role(w);
+    return NULL;
+}
+
+
+/**
+ * @brief Initial values that satisfy every invariant.
+ */
+static void reset_db(void) {
+    struct rtdb_sensor_status status = { 0 };
+
+    rtdb_init();
+    rtdb_set_PID_params(1.0f, 2.0f, 3.0f);
+    rtdb_set_sensor_status(&status);
+    rtdb_set_current_temp_mdeg(0);
+}
+
+
+/**
+ * @brief Measures the ns per call of one role running alone.
+ */
+static double baseline(enum role_kind kind, int role) {
+    struct worker w = { .kind = kind, .role = role };
+    role_fn fn = roles[kind][role].fn;
+
+    reset_db();
+    long long t0 = now_ns();
+    while (now_ns() - t0 < BASELINE_NS) {
+        for (int b = 0; b < BATCH; b++) {
+            w.ops += fn(&w);
+        }
+    }
+    return (double)(now_ns() - t0) / (double)w.ops;
+}
+
+
+int main(int argc, char **argv) {
+    int readers = (argc > 1) ? atoi(argv[1]) : 3;
+    int writers = (argc > 2) ? atoi(argv[2]) : 2;
+    int duration_ms = (argc > 3) ? atoi(argv[3]) : 500;
+    int count = readers + writers;
+
+    if (readers < 0 || writers < 0 || count < 1 || count > MAX_THREADS || duration_ms < 1) {
+        fprintf(stderr, "usage: %s [readers] [writers] [duration ms] (at most %d threads)\n",
+                argv[0], MAX_THREADS);
+        return 2;
+    }
+
+    double base[2][3];
+    for (int k = 0; k < 2; k++) {
+        for (int r = 0; r < 3; r++) {
+            base[k][r] = baseline((enum role_kind)k, r);
+        }
+    }
+
+    reset_db();
+    sensor_writers = (writers + 2) / 3;
+    pthread_barrier_init(&start_barrier, NULL, count + 1);
+
+    for (int t = 0; t < count; t++) {
+        struct worker *w = &workers[t];
+        w->kind = (t < writers) ? WRITER : READER;
+        w->role = (w->kind == WRITER) ? t % 3 : (t - writers) % 3;
+        w->baseline_ns = base[w->kind][w->role];
+        pthread_create(&w->thread, NULL, worker_main, w);
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    long long t0 = now_ns();
+    struct timespec run = { duration_ms / 1000, (long)(duration_ms % 1000) * 1000000L };
+    nanosleep(&run, NULL);
+    stop = 1;
+    for (int t = 0; t < count; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed_s = (double)(now_ns() - t0) / 1e9;
+
+    unsigned long reads = 0, writes = 0, violations = 0;
+    double read_wait = 0.0, write_wait = 0.0;
+
+    printf("{\n  \"backend\": \"%s\",\n  \"readers\": %d,\n  \"writers\": %d,\n"
+           "  \"duration_ms\": %d,\n  \"threads\": [", BACKEND, readers, writers, duration_ms);
+
+    for (int t = 0; t < count; t++) {
+        struct worker *w = &workers[t];
+        double ns = (w->ops > 0) ? (double)w->busy_ns / (double)w->ops : 0.0;
+        double wait = (ns > w->baseline_ns) ? ns - w->baseline_ns : 0.0;
+
+        if (w->kind == READER) {
+            reads += w->ops;
+            read_wait += wait * w->ops;
+        } else {
+            writes += w->ops;
+            write_wait += wait * w->ops;
+        }
+        violations += w->violations;
+
+        printf("%s\n    {\"role\": \"%s\", \"kind\": \"%s\", \"ops\": %lu, \"ns_per_op\": %.1f, "
+               "\"uncontended_ns_per_op\": %.1f, \"wait_ns_per_op\": %.1f, \"violations\": %lu}",
+               t ? "," : "", roles[w->kind][w->role].name, (w->kind == READER) ? "reader" : "writer",
+               w->ops, ns, w->baseline_ns, wait, w->violations);
+    }
+
+    printf("\n  ],\n  \"reads_per_sec\": %.0f,\n  \"writes_per_sec\": %.0f,\n"
+           "  \"read_wait_ns_per_op\": %.1f,\n  \"write_wait_ns_per_op\": %.1f,\n"
+           "  \"violations\": %lu\n}\n",
+           reads / elapsed_s, writes / elapsed_s,
+           reads ? read_wait / reads : 0.0, writes ? write_wait / writes : 0.0, violations);
+
+    pthread_barrier_destroy(&start_barrier);
+    return violations ? 1 : 0;
+}
@@ -58,6 +58,14 @@ void test_DesiredTemp(void) {
 
     rtdb_set_desired_temp(-10);
     TEST_ASSERT_EQUAL(-10, rtdb_get_desired_temp());
+    TEST_ASSERT_EQUAL(-10000, rtdb_get_desired_temp_mdeg());
+
+    // Profile setpoints keep their fraction; whole degrees are rounded
+    rtdb_set_desired_temp_mdeg(37650);
+    TEST_ASSERT_EQUAL(37650, rtdb_get_desired_temp_mdeg());
+    TEST_ASSERT_EQUAL(38, rtdb_get_desired_temp());
+    rtdb_set_desired_temp_mdeg(-2400);
+    TEST_ASSERT_EQUAL(-2, rtdb_get_desired_temp());
 }
 
 /**
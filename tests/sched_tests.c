@@ -0,0 +1,155 @@
+#include "unity.h"
+#include "sched.h"
+
+
+/** \file sched_tests.c
+*   \brief Unit tests of the rate-monotonic analysis
+**
+*        Checks the rate-monotonic priority order, the Liu & Layland
+*       bound and the response-time analysis on known task sets
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test shorter periods get more urgent priorities, equal periods share a level and unused tasks are ignored
+ */
+void test_Sched_RateMonotonicOrder(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Rate-Monotonic Priority Order  === == - │\n");
+    printf(" ╰────────────────────────────────────────────────────────╯\n");
+
+    struct sched_task tasks[] = {
+        { "slow", 100, 1000, -1, 0 },
+        { "unused", 0, 1000, -1, 0 },
+        { "fast", 10, 1000, -1, 0 },
+        { "mid", 50, 1000, -1, 0 },
+        { "fast2", 10, 1000, -1, 0 },
+    };
+
+    sched_assign_rm(tasks, 5, 3);
+    for (int i = 0; i < 5; i++) {
+        printf("   ─> %-6s T = %3u ms, priority %d\n", tasks[i].name, tasks[i].period_ms, tasks[i].priority);
+    }
+
+    TEST_ASSERT_EQUAL(3, tasks[2].priority);
+    TEST_ASSERT_EQUAL(3, tasks[4].priority);
+    TEST_ASSERT_EQUAL(4, tasks[3].priority);
+    TEST_ASSERT_EQUAL(5, tasks[0].priority);
+    TEST_ASSERT_EQUAL(-1, tasks[1].priority);
+    printf("   ─> Test passed: Priorities follow the periods\n\n");
+}
+
+/**
+ * @brief Test the Liu & Layland bound for the number of active tasks and a set below it
+ */
+void test_Sched_LiuLaylandBound(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Liu & Layland Bound  === == - │\n");
+    printf(" ╰──────────────────────────────────────────────╯\n");
+
+    struct sched_task tasks[10] = { 0 };
+    uint32_t util, bound;
+
+    // Two tasks at 20% each: 400 per mille, below the 828 per mille bound
+    tasks[0] = (struct sched_task){ "a", 10, 2000, 0, 0 };
+    tasks[1] = (struct sched_task){ "b", 20, 4000, 0, 0 };
+    sched_assign_rm(tasks, 2, 0);
+    TEST_ASSERT_EQUAL(0, sched_analyse(tasks, 2, &util, &bound));
+    printf("   ─> 2 tasks: utilization %u, bound %u per mille\n", util, bound);
+    TEST_ASSERT_EQUAL(400, util);
+    TEST_ASSERT_EQUAL(828, bound);
+    TEST_ASSERT_EQUAL(2000, tasks[0].response_us);
+    TEST_ASSERT_EQUAL(6000, tasks[1].response_us);
+
+    // Unused tasks do not count towards the bound
+    tasks[2] = (struct sched_task){ "c", 40, 1000, 0, 0 };
+    tasks[3] = (struct sched_task){ "unused", 0, 1000, 0, 0 };
+    sched_assign_rm(tasks, 4, 0);
+    sched_analyse(tasks, 4, &util, &bound);
+    TEST_ASSERT_EQUAL(779, bound);
+
+    // Past 8 tasks the bound settles at ln 2
+    for (int i = 0; i < 10; i++) {
+        tasks[i] = (struct sched_task){ "t", 100, 1000, 0, 0 };
+    }
+    sched_assign_rm(tasks, 10, 0);
+    TEST_ASSERT_EQUAL(0, sched_analyse(tasks, 10, &util, &bound));
+    printf("   ─> 10 tasks: utilization %u, bound %u per mille\n", util, bound);
+    TEST_ASSERT_EQUAL(100, util);
+    TEST_ASSERT_EQUAL(693, bound);
+    printf("   ─> Test passed: The bound matches the number of active tasks\n\n");
+}
+
+/**
+ * @brief Test the response-time analysis accepts a harmonic set above the bound and rejects an infeasible one
+ */
+void test_Sched_ResponseTime(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Response-Time Analysis  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────╯\n");
+
+    uint32_t util, bound;
+
+    // Harmonic set at full utilization: above the bound, but every deadline is met
+    struct sched_task harmonic[] = {
+        { "a", 10, 5000, 0, 0 },
+        { "b", 20, 10000, 0, 0 },
+    };
+    sched_assign_rm(harmonic, 2, 0);
+    TEST_ASSERT_EQUAL(1, sched_analyse(harmonic, 2, &util, &bound));
+    printf("   ─> Harmonic set: utilization %u per mille, R = %u / %u us\n",
+           util, harmonic[0].response_us, harmonic[1].response_us);
+    TEST_ASSERT_EQUAL(1000, util);
+    TEST_ASSERT_EQUAL(5000, harmonic[0].response_us);
+    TEST_ASSERT_EQUAL(20000, harmonic[1].response_us);
+
+    // Below 100% but the slower task misses its 14 ms deadline: R = 5 + 2 * 6 = 17 ms
+    struct sched_task infeasible[] = {
+        { "a", 10, 6000, 0, 0 },
+        { "b", 14, 5000, 0, 0 },
+    };
+    sched_assign_rm(infeasible, 2, 0);
+    TEST_ASSERT_EQUAL(-1, sched_analyse(infeasible, 2, &util, &bound));
+    printf("   ─> Infeasible set: utilization %u per mille, R = %u / %u us\n",
+           util, infeasible[0].response_us, infeasible[1].response_us);
+    TEST_ASSERT_EQUAL(957, util);
+    TEST_ASSERT_EQUAL(6000, infeasible[0].response_us);
+    TEST_ASSERT_EQUAL(17000, infeasible[1].response_us);
+    TEST_ASSERT_GREATER_THAN(14000, infeasible[1].response_us);
+    printf("   ─> Test passed: Response times decide schedulability\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Sched_RateMonotonicOrder);
+    RUN_TEST(test_Sched_LiuLaylandBound);
+    RUN_TEST(test_Sched_ResponseTime);
+
+    return UNITY_END();
+}
@@ -0,0 +1,26 @@
+#ifndef SENSORS_DT_H
+#define SENSORS_DT_H
+
+/**
+ * @file sensors_dt.h
+ * @brief Devicetree of sensors_tests (HOST_DT_HEADER, see tests/hal/zephyr/devicetree.h).
+ *
+ * Three TC74: two on i2c0, at 0x48 and 0x49, and one on i2c1, at 0x4A.
+ * \author Pedro Ramos, n.º 107348
+ * \author Rafael Morgado, n.º 104277
+ * \date 01/06/2025
+ */
+
+
+#define HOST_DT_INSTS(fn) fn(0) fn(1) fn(2)
+#define HOST_DT_NODES(fn) fn(DT_N_INST_0) fn(DT_N_INST_1) fn(DT_N_INST_2)
+#define HOST_DT_BUSES(fn) fn(DT_N_I2C0) fn(DT_N_I2C1)
+
+#define DT_N_INST_0_BUS DT_N_I2C0
+#define DT_N_INST_0_REG 0x48
+#define DT_N_INST_1_BUS DT_N_I2C0
+#define DT_N_INST_1_REG 0x49
+#define DT_N_INST_2_BUS DT_N_I2C1
+#define DT_N_INST_2_REG 0x4A
+
+#endif
@@ -0,0 +1,387 @@
+#include <string.h>
+#include <pthread.h>
+#include "unity.h"
+#include "cmdproc.h"
+#include "control.h"
+#include "rtdb.h"
+#include "sensors.h"
+#include <zephyr/drivers/i2c.h>
+
+
+/** \file sensors_tests.c
+*   \brief Unit tests of the batched TC74 reads
+**
+*        Builds src/modules/sensors.c and the TC74 driver against the
+*       devicetree of sensors_dt.h, with a test I2C controller per bus
+*       that completes transfers from another thread, as an interrupt
+*       would, and that can refuse or stall them. Checks the per-bus
+*       batching, the retries, the timeouts, the -EBUSY path of the
+*       async fetch, the #I counters and the heater fail safe
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+#define TC74_CMD_RTR 0x00           /**< Read temperature register */
+#define TC74_CMD_RWCR 0x01          /**< Read/write configuration register */
+#define COMPLETE_MS 1               /**< Time a transfer takes on the test controller */
+
+/** Behaviour of a test I2C controller */
+enum fake_mode {
+    FAKE_OK,                        /**< Answers (after the NACKs left, if any) */
+    FAKE_STALL,                     /**< Never completes a transfer */
+};
+
+/** Test I2C controller: one transfer in flight, completed by the completer thread */
+struct fake_i2c {
+    pthread_mutex_t lock;           /**< Serializes the sampling thread and the completer */
+    enum fake_mode mode;            /**< Behaviour */
+    int nacks;                      /**< Transfers still to be refused with -EIO */
+    int attempts;                   /**< Asynchronous transfers requested */
+    bool pending;                   /**< A transfer is in flight */
+    int64_t started_ms;             /**< Time it was started */
+    struct i2c_msg *msgs;           /**< Its messages */
+    uint16_t addr;                  /**< Its target */
+    i2c_callback_t cb;              /**< Its completion callback */
+    void *userdata;                 /**< Argument of the callback */
+};
+
+static struct fake_i2c fake[2] = {
+    { .lock = PTHREAD_MUTEX_INITIALIZER },
+    { .lock = PTHREAD_MUTEX_INITIALIZER },
+};
+static int8_t temp_reg[0x80];       /**< Temperature register of each target */
+static uint8_t config_reg[0x80];    /**< Configuration register of each target */
+static int in_flight;               /**< Transfers in flight on every bus */
+static int max_in_flight;           /**< Most transfers in flight at once */
+static volatile bool completer_stop;
+static pthread_t completer_thread;
+
+static struct rtdb_sensor_status status;
+static struct control ctrl;
+
+/**
+ * @brief Runs the messages of a transfer on the TC74 registers.
+ */
+static int fake_run(struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr) {
+    uint8_t cmd = msgs[0].buf[0];
+
+    if (num_msgs == 2 && cmd == TC74_CMD_RTR) {
+        msgs[1].buf[0] = (uint8_t)temp_reg[addr];
+    } else if (num_msgs == 2 && cmd == TC74_CMD_RWCR) {
+        msgs[1].buf[0] = config_reg[addr];
+    } else if (num_msgs == 1 && msgs[0].len == 2 && cmd == TC74_CMD_RWCR) {
+        config_reg[addr] = msgs[0].buf[1];
+    } else {
+        return -EIO;
+    }
+    return 0;
+}
+
+/**
+ * @brief Blocking transfer (TC74 init).
+ */
+static int fake_transfer(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr) {
+    ARG_UNUSED(dev);
+    return fake_run(msgs, num_msgs, addr);
+}
+
+/**
+ * @brief Starts an asynchronous transfer, -EBUSY while another one is in flight.
+ */
+static int fake_transfer_cb(const struct device *dev, struct i2c_msg *msgs, uint8_t num_msgs, uint16_t addr,
+                            i2c_callback_t cb, void *userdata) {
+    struct fake_i2c *f = dev->data;
+    int ret = 0;
+
+    TEST_ASSERT_EQUAL(2, num_msgs);
+    pthread_mutex_lock(&f->lock);
+    f->attempts++;
+    if (f->pending) {
+        ret = -EBUSY;
+    } else {
+        f->pending = true;
+        f->started_ms = k_uptime_get();
+        f->msgs = msgs;
+        f->addr = addr;
+        f->cb = cb;
+        f->userdata = userdata;
+        int n = __atomic_add_fetch(&in_flight, 1, __ATOMIC_SEQ_CST);
+        if (n > max_in_flight) {
+            max_in_flight = n;
+        }
+    }
+    pthread_mutex_unlock(&f->lock);
+    return ret;
+}
+
+static const struct i2c_driver_api fake_api = {
+    .transfer = fake_transfer,
+    .transfer_cb = fake_transfer_cb,
+};
+
+const struct device HOST_DT_DEVICE(DT_N_I2C0) = { .name = "i2c0", .api = &fake_api, .data = &fake[0] };
+const struct device HOST_DT_DEVICE(DT_N_I2C1) = { .name = "i2c1", .api = &fake_api, .data = &fake[1] };
+
+static const struct device *const buses[2] = { DEVICE_DT_GET(DT_N_I2C0), DEVICE_DT_GET(DT_N_I2C1) };
+
+/**
+ * @brief Completes a pending transfer, unless stalled, and calls its callback.
+ */
+static void fake_complete(const struct device *bus, bool force) {
+    struct fake_i2c *f = bus->data;
+    i2c_callback_t cb = NULL;
+    void *userdata = NULL;
+    int result = 0;
+
+    pthread_mutex_lock(&f->lock);
+    if (f->pending && (force || (f->mode != FAKE_STALL && k_uptime_get() - f->started_ms >= COMPLETE_MS))) {
+        if (force) {
+            result = -EIO;
+        } else if (f->nacks > 0) {
+            f->nacks--;
+            result = -EIO;
+        } else {
+            result = fake_run(f->msgs, 2, f->addr);
+        }
+        cb = f->cb;
+        userdata = f->userdata;
+        f->pending = false;
+        __atomic_sub_fetch(&in_flight, 1, __ATOMIC_SEQ_CST);
+    }
+    pthread_mutex_unlock(&f->lock);
+
+    if (cb != NULL) {
+        cb(bus, result, userdata);
+    }
+}
+
+/**
+ * @brief Completer thread: plays the I2C interrupts.
+ */
+static void *completer(void *arg) {
+    const struct timespec poll = { 0, 200000 };
+
+    ARG_UNUSED(arg);
+    while (!completer_stop) {
+        fake_complete(buses[0], false);
+        fake_complete(buses[1], false);
+        nanosleep(&poll, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Samples every sensor and publishes the status, as sensor_stage() in main.c.
+ * @return Number of sensors read.
+ */
+static int sensor_stage(void) {
+    int valid = sensors_sample(&status);
+
+    status.ok = (valid > 0);
+    rtdb_set_sensor_status(&status);
+    return valid;
+}
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+    for (int b = 0; b < 2; b++) {
+        fake[b].mode = FAKE_OK;
+        fake[b].nacks = 0;
+        fake[b].attempts = 0;
+        //  A bus recovery aborts what a previous test left stalled
+        fake_complete(buses[b], true);
+    }
+    max_in_flight = 0;
+    temp_reg[0x48] = 21;
+    temp_reg[0x49] = 23;
+    temp_reg[0x4A] = -5;
+    memset(&status, 0, sizeof(status));
+    rtdb_init();
+    TEST_ASSERT_EQUAL(3, sensors_init());
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the TC74 init wakes a sensor in standby and one cycle reads every sensor, both buses in parallel
+ */
+void test_Sensors_BatchedRead(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Batched TC74 Reads  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────╯\n");
+
+    // The sensor at 0x49 boots in standby
+    config_reg[0x49] = 0x80;
+    const struct device *const tc74[3] = { DEVICE_DT_GET(DT_N_INST_0), DEVICE_DT_GET(DT_N_INST_1),
+                                           DEVICE_DT_GET(DT_N_INST_2) };
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(0, tc74[i]->init(tc74[i]));
+    }
+    TEST_ASSERT_EQUAL(0x00, config_reg[0x49]);
+
+    TEST_ASSERT_EQUAL(3, sensor_stage());
+    int t[3];
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(sensors_get_temp(i, &t[i]));
+    }
+    printf("   ─> %s: %d, %s: %d, %s: %d\n", sensors_name(0), t[0], sensors_name(1), t[1], sensors_name(2), t[2]);
+    TEST_ASSERT_EQUAL(21, t[0]);
+    TEST_ASSERT_EQUAL(23, t[1]);
+    TEST_ASSERT_EQUAL(-5, t[2]);
+
+    // Back-to-back on i2c0, in parallel with i2c1
+    printf("   ─> Transfers on i2c0: %d, on i2c1: %d, at once: %d\n", fake[0].attempts, fake[1].attempts, max_in_flight);
+    TEST_ASSERT_EQUAL(2, fake[0].attempts);
+    TEST_ASSERT_EQUAL(1, fake[1].attempts);
+    TEST_ASSERT_EQUAL(2, max_in_flight);
+    TEST_ASSERT_TRUE(rtdb_get_sensor_ok());
+    TEST_ASSERT_EQUAL(0, status.timeouts + status.retries + status.failures);
+    printf("   ─> Test passed: One cycle reads every sensor\n\n");
+}
+
+/**
+ * @brief Test a refused read is retried CONFIG_APP_SENSOR_RETRIES times and then counted as a failure
+ */
+void test_Sensors_Retries(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test TC74 Read Retries  === == - │\n");
+    printf(" ╰────────────────────────────────────────────╯\n");
+
+    // Two NACKs: the last retry reads it
+    fake[1].nacks = CONFIG_APP_SENSOR_RETRIES;
+    TEST_ASSERT_EQUAL(3, sensor_stage());
+    TEST_ASSERT_EQUAL(CONFIG_APP_SENSOR_RETRIES, status.retries);
+    TEST_ASSERT_EQUAL(0, status.failures);
+
+    // One more: the sample of that sensor is lost, the others are not
+    fake[1].nacks = CONFIG_APP_SENSOR_RETRIES + 1;
+    TEST_ASSERT_EQUAL(2, sensor_stage());
+    int t;
+    TEST_ASSERT_FALSE(sensors_get_temp(2, &t));
+    TEST_ASSERT_TRUE(sensors_get_temp(1, &t));
+    printf("   ─> Retries: %u, failures: %u\n", (unsigned)status.retries, (unsigned)status.failures);
+    TEST_ASSERT_EQUAL(2 * CONFIG_APP_SENSOR_RETRIES, status.retries);
+    TEST_ASSERT_EQUAL(1, status.failures);
+    TEST_ASSERT_EQUAL(0, status.timeouts);
+    TEST_ASSERT_TRUE(rtdb_get_sensor_ok());
+    printf("   ─> Test passed: Failed reads are retried, then dropped\n\n");
+}
+
+/**
+ * @brief Test a stalled bus times out and is abandoned, and its sensor is refused with -EBUSY while the transfer hangs
+ */
+void test_Sensors_StalledBus(void) {
+    printf("\n");
+    printf(" ╭──────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Stalled I2C Bus  === == - │\n");
+    printf(" ╰──────────────────────────────────────────╯\n");
+
+    // i2c0 hangs on the first sensor: the rest of the bus is given up, i2c1 is read
+    fake[0].mode = FAKE_STALL;
+    int64_t start = k_uptime_get();
+    TEST_ASSERT_EQUAL(1, sensor_stage());
+    int64_t elapsed = k_uptime_get() - start;
+    printf("   ─> Cycle with a stalled bus: %lld ms\n", (long long)elapsed);
+    TEST_ASSERT_GREATER_OR_EQUAL(CONFIG_APP_SENSOR_TIMEOUT_MS, elapsed);
+    TEST_ASSERT_EQUAL(1, status.timeouts);
+    TEST_ASSERT_EQUAL(2, status.failures);
+    TEST_ASSERT_EQUAL(0, status.retries);
+    TEST_ASSERT_EQUAL(1, fake[0].attempts);
+
+    // Next cycle: the TC74 still owns the hung transfer (-EBUSY, never reaching
+    // the bus), and the controller refuses the next sensor while it is busy
+    TEST_ASSERT_EQUAL(1, sensor_stage());
+    printf("   ─> Timeouts: %u, retries: %u, failures: %u\n", (unsigned)status.timeouts,
+           (unsigned)status.retries, (unsigned)status.failures);
+    TEST_ASSERT_EQUAL(1 + (1 + CONFIG_APP_SENSOR_RETRIES), fake[0].attempts);
+    TEST_ASSERT_EQUAL(1, status.timeouts);
+    TEST_ASSERT_EQUAL(2 * CONFIG_APP_SENSOR_RETRIES, status.retries);
+    TEST_ASSERT_EQUAL(2 + 2, status.failures);
+
+    // Once the bus recovers, every sensor is read again
+    fake[0].mode = FAKE_OK;
+    fake_complete(buses[0], true);
+    TEST_ASSERT_EQUAL(3, sensor_stage());
+    TEST_ASSERT_EQUAL(2 + 2, status.failures);
+    printf("   ─> Test passed: A stalled bus does not hold up the others\n\n");
+}
+
+/**
+ * @brief Test #I reports the counters and the heater is switched off when every bus stalls
+ */
+void test_Sensors_AllStalledHeaterOff(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Sensor Loss Fail Safe  === == - │\n");
+    printf(" ╰────────────────────────────────────────────────╯\n");
+
+    // Heating towards 50 °C on good samples
+    control_init(&ctrl, 5.0f);
+    rtdb_set_system_on(true);
+    rtdb_set_desired_temp(50);
+    TEST_ASSERT_EQUAL(3, sensor_stage());
+    rtdb_set_current_temp_mdeg(20000);
+    TEST_ASSERT_EQUAL(0, control_step(&ctrl, 1.0f));
+    TEST_ASSERT_GREATER_THAN(0, control_heater_duty());
+
+    // Both buses hang: no sample, the controller stops and the heater stage forces the FET off
+    fake[0].mode = FAKE_STALL;
+    fake[1].mode = FAKE_STALL;
+    TEST_ASSERT_EQUAL(0, sensor_stage());
+    TEST_ASSERT_FALSE(rtdb_get_sensor_ok());
+    TEST_ASSERT_EQUAL(-1, control_step(&ctrl, 1.0f));
+    TEST_ASSERT_EQUAL(0, control_heater_duty());
+    TEST_ASSERT_FALSE(rtdb_get_heat_on());
+
+    // #I: not ok, 2 timeouts, no retries, 3 failures
+    char payload[] = "I";
+    char frame[16];
+    unsigned char ans[32];
+    int len;
+    sprintf(frame, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+    resetTxBuffer();
+    resetRxBuffer();
+    for (size_t i = 0; i < strlen(frame); i++) {
+        rxChar((unsigned char)frame[i]);
+    }
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    getTxBuffer(ans, &len);
+    ans[len] = '\0';
+    printf("   ─> #I answer: %s\n", (char *)ans);
+    TEST_ASSERT_EQUAL_STRING_LEN("#i0000020000000003", (char *)ans, 18);
+    printf("   ─> Test passed: The sensor loss is reported and the heater is off\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    pthread_create(&completer_thread, NULL, completer, NULL);
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Sensors_BatchedRead);
+    RUN_TEST(test_Sensors_Retries);
+    RUN_TEST(test_Sensors_StalledBus);
+    RUN_TEST(test_Sensors_AllStalledHeaterOff);
+
+    int result = UNITY_END();
+    completer_stop = true;
+    pthread_join(completer_thread, NULL);
+    return result;
+}
@@ -0,0 +1,319 @@
+#include <string.h>
+#include <math.h>
+#include "rtdb.h"
+#include "sched.h"
+#include "control.h"
+#include "tpo.h"
+#include "governor.h"
+#include "kalman.h"
+#include "sim.h"
+
+
+/** \file sim.c
+*   \brief Closed-loop simulation of the controller on a virtual clock
+**
+*        Runs the firmware control chain against the FOPDT plant model
+*       with no kernel and no real time: every sensor read converts the
+*       plant temperature like the TC74 (whole degrees), feeds the same
+*       filter and the RTDB, and every oversample-th read runs
+*       control_step() and applies control_heater_duty() to the plant,
+*       exactly as the sensor, controller and heater stages of main.c.
+*       The on/off output switches the plant at once. With the
+*       time-proportional output, the plant input follows tpo_tick() at
+*       every slot, as the slot timer of main.c does. The switching
+*       governor of the FET holds back the on/off transitions and
+*       quantises the duty of the other two outputs. With the hardware
+*       PWM, the duty takes effect at the next PWM period and, the period
+*       being much shorter than the plant time constant, heats the plant
+*       with the mean power. A setpoint profile runs on the virtual clock,
+*       as it does on the kernel clock in the controller stage.
+*       An hour of plant time takes a few milliseconds.
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Fill the default plant: 22 °C ambient, 50 °C rise at full power, 40 s, 2 s dead time.
+ * @param params Plant parameters to fill.
+ */
+void sim_default_plant(struct plant_params *params) {
+    params->ambient_mdeg = 22000;
+    params->gain_mdeg = 50000;
+    params->tau_ms = 40000;
+    params->dead_ms = 2000;
+}
+
+
+/**
+ * @brief The exact model of a plant, as the estimators and the MPC take it.
+ * @param params Plant parameters.
+ * @param model Model to fill.
+ */
+void sim_plant_model(const struct plant_params *params, struct plant_estimate *model) {
+    memset(model, 0, sizeof(*model));
+    model->gain_c = params->gain_mdeg / 1000.0f;
+    model->tau_s = params->tau_ms / 1000.0f;
+    model->dead_s = params->dead_ms / 1000.0f;
+    model->ambient_c = params->ambient_mdeg / 1000.0f;
+    model->valid = true;
+}
+
+
+/**
+ * @brief Step the plant under a square wave of the heater.
+ * @param p Plant.
+ * @param half_ms Time on, then off, from the start of the plant clock.
+ * @param dt_ms Step.
+ * @return Input applied over the step (‰).
+ */
+uint16_t sim_square_step(struct plant *p, uint32_t half_ms, uint32_t dt_ms) {
+    uint16_t input = ((p->now_ms / half_ms) % 2 == 0) ? 1000 : 0;
+
+    plant_set_input(p, input);
+    plant_step(p, dt_ms);
+    return input;
+}
+
+
+/**
+ * @brief Fill a configuration with the firmware defaults.
+ * @param cfg Configuration to fill.
+ */
+void sim_default_config(struct sim_config *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    sim_default_plant(&cfg->plant);
+    cfg->setpoint = 40;
+    cfg->duration_ms = 3600000;
+    cfg->period_ms = 250;
+    cfg->oversample = 2;
+    cfg->filter = FILTER_MOVING_AVG;
+    cfg->filter_len = 4;
+    cfg->filter_shift = 2;
+    cfg->kalman_divider = 0;
+    cfg->kalman_model.gain_c = 50.0f;
+    cfg->kalman_model.tau_s = 40.0f;
+    cfg->kalman_model.dead_s = 2.0f;
+    cfg->kp = 2.0f;
+    cfg->ki = 0.1f;
+    cfg->kd = 0.05f;
+    cfg->controller = CONTROLLER_PID;
+    cfg->hysteresis = 1.0f;
+    cfg->beta = 0.5f;
+    cfg->mpc_model = cfg->kalman_model;
+    cfg->move_weight = MPC_MOVE_WEIGHT;
+    cfg->autotune = false;
+    cfg->tune_hysteresis = 1.0f;
+    cfg->output = SIM_OUTPUT_PWM;
+    cfg->full_scale = 5.0f;
+    cfg->window_ms = 2000;
+    cfg->slots = 20;
+    cfg->pwm_period_ms = 100;
+    cfg->band_mdeg = 500;
+    cfg->trace_ms = 0;
+}
+
+
+/**
+ * @brief TC74 reading of a temperature: whole degrees, -65 to 127 °C.
+ */
+static int32_t sensor_read_mdeg(int32_t mdeg) {
+    int32_t deg = (mdeg >= 0) ? (mdeg + 500) / 1000 : (mdeg - 500) / 1000;
+    deg = (deg < -65) ? -65 : (deg > 127) ? 127 : deg;
+    return deg * 1000;
+}
+
+
+/**
+ * @brief Adds the time from..to to the heater totals: [0] the whole run, [1] the final tail.
+ */
+static void count_heater(uint64_t on_ms[2], uint64_t total_ms[2], uint16_t input,
+                         uint32_t from, uint32_t to, uint32_t tail_ms) {
+    for (int k = 0; k < ((from >= tail_ms) ? 2 : 1); k++) {
+        on_ms[k] += (uint64_t)(to - from) * input;
+        total_ms[k] += (uint64_t)(to - from) * 1000;
+    }
+}
+
+
+/**
+ * @brief Run one closed-loop simulation from ambient temperature.
+ * @param cfg Simulation parameters.
+ * @param res Metrics of the run.
+ * @param trace CSV trace destination, or NULL.
+ * @return 0 on success, -1 on invalid parameters.
+ */
+int sim_run(const struct sim_config *cfg, struct sim_result *res, FILE *trace) {
+    if (cfg->period_ms == 0 || controller_get(cfg->controller) == NULL || cfg->oversample < 1 || cfg->duration_ms == 0 ||
+        (cfg->output == SIM_OUTPUT_TPO && (cfg->slots == 0 || cfg->window_ms < cfg->slots)) ||
+        (cfg->output == SIM_OUTPUT_PWM && cfg->pwm_period_ms == 0)) {
+        return -1;
+    }
+
+    const uint32_t read_ms = (cfg->period_ms / cfg->oversample > 0) ? cfg->period_ms / cfg->oversample : 1;
+    const float dt = cfg->period_ms / 1000.0f;
+    const int32_t setpoint_mdeg = cfg->setpoint * 1000;
+    const float step_mdeg = (float)(setpoint_mdeg - cfg->plant.ambient_mdeg);
+    const float dir = (step_mdeg >= 0.0f) ? 1.0f : -1.0f;
+    const uint32_t tail_ms = cfg->duration_ms - cfg->duration_ms / 10;
+    const uint32_t slot_ms = (cfg->output == SIM_OUTPUT_TPO) ? cfg->window_ms / cfg->slots :
+                             (cfg->output == SIM_OUTPUT_PWM) ? cfg->pwm_period_ms : 0;
+
+    struct plant plant;
+    struct filter filter;
+    struct control ctrl;
+    struct tpo tpo;
+    struct governor gov;
+    struct kalman kalman;
+    struct rtdb_sensor_status status = { .ok = true };
+
+    plant_init(&plant, &cfg->plant);
+    filter_init(&filter, cfg->filter, cfg->filter_len, cfg->filter_shift);
+    control_init(&ctrl, (cfg->output == SIM_OUTPUT_ONOFF) ? 0.0f : cfg->full_scale);
+    ctrl.hysteresis = cfg->hysteresis;
+    ctrl.beta = cfg->beta;
+    ctrl.mpc_model = cfg->mpc_model;
+    ctrl.move_weight = cfg->move_weight;
+    ctrl.tune_cfg.hysteresis = cfg->tune_hysteresis;
+    tpo_init(&tpo, cfg->slots);
+    governor_init(&gov, &cfg->governor, 0);
+    kalman_init(&kalman, KALMAN_R_WHOLE_DEGREE, KALMAN_Q_TEMP, KALMAN_Q_OFFSET);
+    ctrl.use_estimate = (cfg->kalman_divider > 0);
+
+    rtdb_init();
+    rtdb_set_system_on(true);
+    rtdb_set_desired_temp(cfg->setpoint);
+    rtdb_set_PID_params(cfg->kp, cfg->ki, cfg->kd);
+    rtdb_set_gain_schedule(&cfg->schedule);
+    if (cfg->profile.count > 0) {
+        rtdb_set_profile(&cfg->profile);
+        rtdb_request_profile(PROFILE_REQ_START);
+    }
+    rtdb_set_controller(cfg->controller);
+    if (cfg->autotune) {
+        rtdb_request_autotune(AUTOTUNE_REQ_START);
+    }
+    rtdb_set_task_period(TASK_SENSOR, cfg->period_ms);
+    rtdb_set_sensor_status(&status);
+
+    memset(res, 0, sizeof(*res));
+    res->rise_time_s = -1.0f;
+    res->tune_end_s = -1.0f;
+    res->profile_end_s = -1.0f;
+
+    float peak = -INFINITY;
+    double iae = 0.0, tail_err = 0.0;
+    uint64_t on_ms[2] = { 0, 0 }, total_ms[2] = { 0, 0 }, tail_samples = 0;
+    uint32_t last_out_ms = 0, next_trace = 0, next_slot = 0;
+    uint16_t input = 0, duty = 0;
+    bool out_of_band = false;
+    int reads = 0, steps = 0;
+    int32_t measured = 0;
+
+    if (trace != NULL) {
+        fprintf(trace, "time_ms,temp_mdeg,measured_mdeg,estimated_mdeg,setpoint_mdeg,heater,pid_output,input_permille\n");
+    }
+
+    for (uint32_t t = 0; t < cfg->duration_ms; t += read_ms) {
+        int32_t temp = plant_temp_mdeg(&plant);
+
+        /* Sensor stage; with the estimator, a read every kalman_divider steps */
+        bool read = (cfg->kalman_divider == 0 || steps++ % cfg->kalman_divider == 0);
+        if (read) {
+            measured = filter_update(&filter, sensor_read_mdeg(temp));
+            rtdb_set_current_temp_mdeg(measured);
+        }
+        if (cfg->kalman_divider > 0) {
+            struct plant_estimate est;
+            rtdb_get_plant_estimate(&est);
+            kalman_set_model(&kalman, est.valid ? &est : &cfg->kalman_model);
+            kalman_predict(&kalman, control_heater_duty() / 1000.0f, read_ms / 1000.0f);
+            if (read) {
+                kalman_correct(&kalman, sensor_read_mdeg(temp) / 1000.0f);
+            }
+            rtdb_set_estimated_temp_mdeg((int32_t)lroundf(kalman.temp * 1000.0f));
+        }
+
+        /* Controller and heater stages, once per control period */
+        if (++reads >= cfg->oversample) {
+            reads = 0;
+            control_profile(&ctrl, t);
+            if (res->profile_end_s < 0.0f && ctrl.profile.status.state == PROFILE_DONE) {
+                res->profile_end_s = t / 1000.0f;
+            }
+            control_step(&ctrl, dt);
+            if (cfg->autotune && res->tune_end_s < 0.0f && ctrl.tune.status.state != AUTOTUNE_RUNNING) {
+                res->tune_end_s = t / 1000.0f;
+            }
+            duty = control_heater_duty();
+            if (cfg->output == SIM_OUTPUT_TPO) {
+                tpo_set_duty(&tpo, governor_duty(&gov, duty, cfg->window_ms, t));
+            } else if (cfg->output == SIM_OUTPUT_PWM) {
+                duty = governor_duty(&gov, duty, cfg->pwm_period_ms, t);
+            } else if (cfg->output == SIM_OUTPUT_ONOFF) {
+                uint16_t state = governor_request(&gov, duty > 0, t) ? 1000 : 0;
+                res->switches += (state != input);
+                input = state;
+                plant_set_input(&plant, input);
+            }
+        }
+
+        /* Metrics on the true plant temperature */
+        int32_t target_mdeg = rtdb_get_desired_temp_mdeg();
+        float err = (float)(target_mdeg - temp);
+        peak = fmaxf(peak, dir * (float)temp);
+        iae += fabsf(err) / 1000.0f * read_ms / 1000.0;
+        if (res->rise_time_s < 0.0f && dir * (temp - cfg->plant.ambient_mdeg) >= 0.9f * dir * step_mdeg) {
+            res->rise_time_s = t / 1000.0f;
+        }
+        out_of_band = fabsf(err) > cfg->band_mdeg;
+        if (out_of_band) {
+            last_out_ms = t;
+        }
+        if (t >= tail_ms) {
+            tail_err += err / 1000.0f;
+            tail_samples++;
+        }
+
+        if (trace != NULL && cfg->trace_ms > 0 && t >= next_trace) {
+            fprintf(trace, "%u,%d,%d,%d,%d,%d,%.3f,%u\n", (unsigned)t, (int)temp, (int)measured,
+                    (int)rtdb_get_estimated_temp_mdeg(), (int)target_mdeg, (input > 0) ? 1 : 0,
+                    ctrl.output, (unsigned)input);
+            next_trace = t + cfg->trace_ms;
+        }
+
+        /* Plant up to the next read, updating the output at every slot or PWM period */
+        uint32_t now = t;
+        while (slot_ms > 0 && next_slot < t + read_ms) {
+            plant_step(&plant, next_slot - now);
+            count_heater(on_ms, total_ms, input, now, next_slot, tail_ms);
+            now = next_slot;
+
+            uint16_t state = (cfg->output == SIM_OUTPUT_TPO) ? (tpo_tick(&tpo) ? 1000 : 0) : duty;
+            if (cfg->output == SIM_OUTPUT_PWM && state > 0 && state < 1000) {
+                res->switches += 2;
+            } else {
+                res->switches += ((state > 0) != (input > 0));
+            }
+            input = state;
+            plant_set_input(&plant, input);
+            next_slot += slot_ms;
+        }
+        plant_step(&plant, t + read_ms - now);
+        count_heater(on_ms, total_ms, input, now, t + read_ms, tail_ms);
+    }
+
+    res->settling_time_s = out_of_band ? -1.0f : (last_out_ms + read_ms) / 1000.0f;
+    res->overshoot_c = fmaxf(peak - dir * setpoint_mdeg, 0.0f) / 1000.0f;
+    res->overshoot_pct = (step_mdeg != 0.0f) ? 100.0f * res->overshoot_c * 1000.0f / fabsf(step_mdeg) : 0.0f;
+    res->iae = (float)iae;
+    res->final_error_c = tail_samples ? (float)(tail_err / tail_samples) : 0.0f;
+    res->duty = (float)on_ms[0] / total_ms[0];
+    res->final_duty = total_ms[1] ? (float)on_ms[1] / total_ms[1] : 0.0f;
+    res->suppressed = gov.stats.suppressed;
+    rtdb_get_autotune_status(&res->tune);
+    rtdb_get_plant_estimate(&res->plant_est);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "filter.h"
+#include "governor.h"
+#include "controller.h"
+#include "autotune.h"
+#include "ident.h"
+#include "kalman.h"
+#include "gainsched.h"
+#include "profile.h"
+#include "plant.h"
+
+/** \file sim.h
+*   \brief Closed-loop simulation of the controller on a virtual clock
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+/**
+ * @brief Heater output stage (CONFIG_APP_HEATER_OUTPUT).
+ */
+enum sim_output {
+    SIM_OUTPUT_ONOFF,           /**< Fully on while the PID output is positive */
+    SIM_OUTPUT_TPO,             /**< Time-proportional slots of a window */
+    SIM_OUTPUT_PWM,             /**< Hardware PWM, averaged by the plant */
+};
+
+/**
+ * @brief Simulation parameters.
+ */
+struct sim_config {
+    struct plant_params plant;  /**< Thermal model */
+    int setpoint;               /**< Desired temperature (°C) */
+    uint32_t duration_ms;       /**< Simulated time */
+    uint32_t period_ms;         /**< Control period (CONFIG_APP_SAMPLE_PERIOD_MS) */
+    int oversample;             /**< Sensor reads per control period (CONFIG_APP_OVERSAMPLE) */
+    enum filter_type filter;    /**< Temperature filter (CONFIG_APP_FILTER) */
+    int filter_len;             /**< Window length (CONFIG_APP_FILTER_LENGTH) */
+    int filter_shift;           /**< IIR shift (CONFIG_APP_FILTER_IIR_SHIFT) */
+    int kalman_divider;         /**< Control on the Kalman estimate, with a sensor read every this many steps (CONFIG_APP_KALMAN_READ_DIVIDER); 0 to control on the filtered reads */
+    struct plant_estimate kalman_model;  /**< Estimator model until the identification is valid (CONFIG_APP_KALMAN_MODEL_*) */
+    float kp;                   /**< Proportional gain */
+    float ki;                   /**< Integral gain */
+    float kd;                   /**< Derivative gain */
+    struct gain_schedule schedule;  /**< Gain schedule (#B), no points to use kp, ki and kd */
+    struct profile profile;     /**< Setpoint profile (#F), started with the run (#O1); no segments to hold the setpoint */
+    enum controller_type controller;  /**< Control strategy (CONFIG_APP_CONTROLLER, #K) */
+    float hysteresis;           /**< On/off strategy band, °C (CONFIG_APP_CONTROL_HYSTERESIS_MDEG) */
+    float beta;                 /**< 2-DOF setpoint weight (CONFIG_APP_CONTROL_SETPOINT_WEIGHT) */
+    struct plant_estimate mpc_model;  /**< MPC model until the identification is valid (CONFIG_APP_MPC_MODEL_*) */
+    float move_weight;          /**< MPC weight of the output moves (CONFIG_APP_MPC_MOVE_WEIGHT) */
+    bool autotune;              /**< Start with a relay autotune (#U1), then control with its gains */
+    float tune_hysteresis;      /**< Relay band, °C (CONFIG_APP_AUTOTUNE_HYSTERESIS_MDEG) */
+    enum sim_output output;     /**< Heater output stage */
+    float full_scale;           /**< PID output for 100 % duty (CONFIG_APP_HEATER_FULL_SCALE) */
+    uint32_t window_ms;         /**< Time-proportional window (CONFIG_APP_HEATER_WINDOW_MS) */
+    uint16_t slots;             /**< Slots per window (CONFIG_APP_HEATER_SLOTS) */
+    uint32_t pwm_period_ms;     /**< PWM period (heater-pwm devicetree alias) */
+    struct governor_config governor;  /**< FET switching limits (CONFIG_APP_HEATER_MIN_ON_MS...) */
+    int32_t band_mdeg;          /**< Settling band around the setpoint (m°C) */
+    uint32_t trace_ms;          /**< Trace interval, 0 for no trace */
+};
+
+/**
+ * @brief Step response metrics, on the plant temperature.
+ */
+struct sim_result {
+    float rise_time_s;          /**< First time 90% of the step is reached, -1 if never */
+    float settling_time_s;      /**< Time after which the temperature stays in the band, -1 if never */
+    float overshoot_c;          /**< Peak beyond the setpoint (°C) */
+    float overshoot_pct;        /**< Overshoot in % of the step */
+    float iae;                  /**< Integral of the absolute error (°C·s) */
+    float final_error_c;        /**< Mean error over the last 10% of the run (°C) */
+    float duty;                 /**< Mean heater power, as a fraction of full power */
+    float final_duty;           /**< Mean heater power over the last 10% of the run */
+    uint32_t switches;          /**< Heater on/off transitions (FET edges) */
+    uint32_t suppressed;        /**< Transitions held back by the switching governor */
+    struct autotune_status tune;  /**< Autotune result */
+    float tune_end_s;           /**< Time the autotune ended, -1 if it did not run or end */
+    float profile_end_s;        /**< Time the profile ended, -1 if it did not run or end */
+    struct plant_estimate plant_est;  /**< Plant model identified online at the end of the run */
+};
+
+/**
+ * @brief Fill the default plant: 22 °C ambient, 50 °C rise at full power, 40 s, 2 s dead time.
+ * @param params Plant parameters to fill.
+ */
+void sim_default_plant(struct plant_params *params);
+
+/**
+ * @brief The exact model of a plant, as the estimators and the MPC take it.
+ * @param params Plant parameters.
+ * @param model Model to fill, marked valid.
+ */
+void sim_plant_model(const struct plant_params *params, struct plant_estimate *model);
+
+/**
+ * @brief Step the plant under a square wave of the heater.
+ *
+ * The heater is fully on for half_ms, then off for half_ms, and so on, on
+ * the plant clock; the input is set before the step, as a controller that
+ * has just read the plant would.
+ *
+ * @param p Plant.
+ * @param half_ms Time on, then off.
+ * @param dt_ms Step.
+ * @return Input applied over the step (‰), for the estimator of the next step.
+ */
+uint16_t sim_square_step(struct plant *p, uint32_t half_ms, uint32_t dt_ms);
+
+/**
+ * @brief Fill a configuration with the firmware defaults.
+ * @param cfg Configuration to fill.
+ */
+void sim_default_config(struct sim_config *cfg);
+
+/**
+ * @brief Run one closed-loop simulation from ambient temperature.
+ *
+ * With a profile, the error, the settling band and the trace follow its
+ * setpoint; the rise time and the overshoot stay on the setpoint.
+ *
+ * Uses the global RTDB, so simulations must not run concurrently in one
+ * process unless rtdb.c is built with a per-thread RTDB_STORAGE.
+ *
+ * @param cfg Simulation parameters.
+ * @param res Metrics of the run.
+ * @param trace CSV trace destination, or NULL.
+ * @return 0 on success, -1 on invalid parameters.
+ */
+int sim_run(const struct sim_config *cfg, struct sim_result *res, FILE *trace);
+
+#endif
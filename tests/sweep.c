@@ -0,0 +1,392 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "cmdproc.h"
+#include "rtdb.h"
+#include "sim.h"
+
+
+/** \file sweep.c
+*   \brief Parallel PID gain sweep over the closed-loop simulation
+**
+*        Simulates every (kp, ki, kd) of a grid with sim_run() on all cores,
+*       ranks the candidates and prints the best ones as JSON, followed by
+*       the #S commands that load the winner into the firmware.
+**
+*        The grid is split into one contiguous block per worker. A worker
+*       takes candidates from the front of its own block; when it runs
+*       out it steals the back half of the largest remaining block, so
+*       the cores stay busy even when some gains take longer to simulate.
+*       This executable is built with a per-thread RTDB (RTDB_STORAGE), so
+*       the simulations of different workers do not share state.
+**
+*        The #S command carries 4 characters per gain, so the grid values
+*       are rounded to what #S can send (0.00-9.99, 10.0-99.9, 100-9999)
+*       before they are simulated. The commands are checked by feeding
+*       them to cmdProcessor() and reading the gains back.
+**
+*        Usage: sweep [-p kp_min:kp_max:n] [-i ki_min:ki_max:n]
+*                     [-d kd_min:kd_max:n] [-r iae|overshoot|settling]
+*                     [-j threads] [-n top] [-s setpoint °C]
+*                     [-D duration s] [-P period ms]
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+#define MAX_WORKERS 64              /**< Upper limit of the -j argument */
+#define GAIN_CHARS 4                /**< Characters of a gain in the #S command */
+
+/** A range of gains: n values from min to max */
+struct axis {
+    float min;
+    float max;
+    int n;
+};
+
+/** One simulated candidate */
+struct candidate {
+    float kp, ki, kd;
+    struct sim_result res;
+};
+
+/** Block of candidates owned by a worker: [head, tail) */
+struct worker {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+    int id;
+    unsigned long done;             /**< Candidates simulated */
+    unsigned long steals;           /**< Successful steals */
+};
+
+enum rank_key { RANK_IAE, RANK_OVERSHOOT, RANK_SETTLING };
+
+static struct sim_config base_cfg;
+static struct candidate *cands;
+static struct worker workers[MAX_WORKERS];
+static int n_workers;
+static enum rank_key rank_by = RANK_IAE;
+
+
+/**
+ * @brief Formats a gain with the 4 characters of the #S command.
+ */
+static void format_gain(char *out, float v) {
+    char tmp[16];
+
+    if (v < 9.995f) {
+        snprintf(tmp, sizeof(tmp), "%.2f", v);
+    } else if (v < 99.95f) {
+        snprintf(tmp, sizeof(tmp), "%.1f", v);
+    } else {
+        snprintf(tmp, sizeof(tmp), "%4.0f", fminf(v, 9999.0f));
+    }
+    memcpy(out, tmp, GAIN_CHARS);
+    out[GAIN_CHARS] = '\0';
+}
+
+
+/**
+ * @brief Rounds a gain to the value the firmware gets from #S.
+ */
+static float sendable(float v) {
+    char s[GAIN_CHARS + 1];
+
+    format_gain(s, fmaxf(v, 0.0f));
+    return (float)atof(s);
+}
+
+
+static float axis_value(const struct axis *a, int k) {
+    return (a->n > 1) ? a->min + (a->max - a->min) * k / (a->n - 1) : a->min;
+}
+
+
+static int parse_axis(const char *arg, struct axis *a) {
+    return (sscanf(arg, "%f:%f:%d", &a->min, &a->max, &a->n) == 3 && a->n >= 1 &&
+            a->min >= 0.0f && a->max >= a->min) ? 0 : -1;
+}
+
+
+/* === Work-stealing pool === */
+
+/**
+ * @brief Takes the next candidate of a worker's own block.
+ * @return Candidate index, or -1 if the block is empty.
+ */
+static int take_own(struct worker *w) {
+    int idx = -1;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->head < w->tail) {
+        idx = w->head;
+        __atomic_store_n(&w->head, idx + 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return idx;
+}
+
+
+/**
+ * @brief Moves the back half of the largest other block to w.
+ * @return 0 if something was stolen, -1 if every block is empty.
+ */
+static int steal(struct worker *w) {
+    for (;;) {
+        struct worker *victim = NULL;
+        int best = 0;
+
+        /* Unlocked peek to pick a victim; re-checked under its lock.
+         * head and tail are stored atomically for the peek's sake */
+        for (int k = 0; k < n_workers; k++) {
+            struct worker *v = &workers[k];
+            int left = __atomic_load_n(&v->tail, __ATOMIC_RELAXED) -
+                       __atomic_load_n(&v->head, __ATOMIC_RELAXED);
+            if (v != w && left > best) {
+                best = left;
+                victim = v;
+            }
+        }
+        if (victim == NULL) {
+            return -1;
+        }
+
+        pthread_mutex_lock(&victim->lock);
+        int left = victim->tail - victim->head;
+        if (left <= 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        int mid = victim->tail - (left + 1) / 2;
+        int end = victim->tail;
+        __atomic_store_n(&victim->tail, mid, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&w->lock);
+        __atomic_store_n(&w->head, mid, __ATOMIC_RELAXED);
+        __atomic_store_n(&w->tail, end, __ATOMIC_RELAXED);
+        w->steals++;
+        pthread_mutex_unlock(&w->lock);
+        return 0;
+    }
+}
+
+
+static void *worker_main(void *arg) {
+    struct worker *w = arg;
+
+    for (;;) {
+        int idx = take_own(w);
+        if (idx < 0) {
+            if (steal(w) != 0) {
+                break;
+            }
+            continue;
+        }
+
+        struct sim_config cfg = base_cfg;
+        cfg.kp = cands[idx].kp;
+        cfg.ki = cands[idx].ki;
+        cfg.kd = cands[idx].kd;
+        sim_run(&cfg, &cands[idx].res, NULL);
+        w->done++;
+    }
+    return NULL;
+}
+
+
+/* === Ranking === */
+
+/**
+ * @brief Ranking cost: runs that never settle or never reach the setpoint go last.
+ */
+static float cost(const struct candidate *c) {
+    const struct sim_result *r = &c->res;
+    float penalty = ((r->settling_time_s < 0.0f) ? 1e9f : 0.0f) + ((r->rise_time_s < 0.0f) ? 2e9f : 0.0f);
+
+    switch (rank_by) {
+        case RANK_OVERSHOOT:
+            return penalty + r->overshoot_c * 1e6f + r->iae;
+        case RANK_SETTLING:
+            return penalty + r->settling_time_s * 1e3f + r->iae;
+        default:
+            return penalty + r->iae;
+    }
+}
+
+
+static int cmp_candidates(const void *a, const void *b) {
+    float x = cost(a), y = cost(b);
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Builds the #S frame of one gain.
+ */
+static void build_command(char *out, char gain, float value) {
+    unsigned char body[GAIN_CHARS + 3];
+
+    body[0] = 'S';
+    body[1] = (unsigned char)gain;
+    format_gain((char *)&body[2], value);
+    sprintf(out, "#%s%03d!", (char *)body, calcChecksum(body, GAIN_CHARS + 2));
+}
+
+
+/**
+ * @brief Sends the commands through cmdProcessor() and checks the resulting gains.
+ */
+static int verify_commands(char cmds[3][16], const struct candidate *c) {
+    float kp, ki, kd;
+
+    rtdb_init();
+    for (int k = 0; k < 3; k++) {
+        resetRxBuffer();
+        resetTxBuffer();
+        for (size_t n = 0; n < strlen(cmds[k]); n++) {
+            rxChar((unsigned char)cmds[k][n]);
+        }
+        if (cmdProcessor() != 0) {
+            return -1;
+        }
+    }
+    rtdb_get_PID_params(&kp, &ki, &kd);
+    return (kp == c->kp && ki == c->ki && kd == c->kd) ? 0 : -1;
+}
+
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-p kp_min:kp_max:n] [-i ki_min:ki_max:n] [-d kd_min:kd_max:n]\n"
+                    "          [-r iae|overshoot|settling] [-j threads] [-n top]\n"
+                    "          [-s setpoint C] [-D duration s] [-P period ms]\n", prog);
+}
+
+
+int main(int argc, char **argv) {
+    struct axis ax_p = { 0.5f, 10.0f, 10 };
+    struct axis ax_i = { 0.0f, 0.5f, 10 };
+    struct axis ax_d = { 0.0f, 2.0f, 10 };
+    int top = 5;
+    int opt;
+
+    sim_default_config(&base_cfg);
+    base_cfg.duration_ms = 1800000;
+    n_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((opt = getopt(argc, argv, "p:i:d:r:j:n:s:D:P:h")) != -1) {
+        int ok = 0;
+        switch (opt) {
+            case 'p': ok = parse_axis(optarg, &ax_p); break;
+            case 'i': ok = parse_axis(optarg, &ax_i); break;
+            case 'd': ok = parse_axis(optarg, &ax_d); break;
+            case 'j': n_workers = atoi(optarg); break;
+            case 'n': top = atoi(optarg); break;
+            case 's': base_cfg.setpoint = atoi(optarg); break;
+            case 'D': base_cfg.duration_ms = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'P': base_cfg.period_ms = (uint32_t)atoi(optarg); break;
+            case 'r':
+                if (strcmp(optarg, "iae") == 0) {
+                    rank_by = RANK_IAE;
+                } else if (strcmp(optarg, "overshoot") == 0) {
+                    rank_by = RANK_OVERSHOOT;
+                } else if (strcmp(optarg, "settling") == 0) {
+                    rank_by = RANK_SETTLING;
+                } else {
+                    ok = -1;
+                }
+                break;
+            default:
+                ok = -1;
+                break;
+        }
+        if (ok != 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    n_workers = (n_workers < 1) ? 1 : (n_workers > MAX_WORKERS) ? MAX_WORKERS : n_workers;
+    int total = ax_p.n * ax_i.n * ax_d.n;
+    if (total < 1 || top < 1 || base_cfg.period_ms == 0 || base_cfg.duration_ms == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    cands = calloc(total, sizeof(*cands));
+    if (cands == NULL) {
+        perror("calloc");
+        return 1;
+    }
+    for (int a = 0, idx = 0; a < ax_p.n; a++) {
+        for (int b = 0; b < ax_i.n; b++) {
+            for (int c = 0; c < ax_d.n; c++, idx++) {
+                cands[idx].kp = sendable(axis_value(&ax_p, a));
+                cands[idx].ki = sendable(axis_value(&ax_i, b));
+                cands[idx].kd = sendable(axis_value(&ax_d, c));
+            }
+        }
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (int k = 0; k < n_workers; k++) {
+        struct worker *w = &workers[k];
+        pthread_mutex_init(&w->lock, NULL);
+        w->id = k;
+        w->head = (int)((long)total * k / n_workers);
+        w->tail = (int)((long)total * (k + 1) / n_workers);
+    }
+    for (int k = 0; k < n_workers; k++) {
+        pthread_create(&workers[k].thread, NULL, worker_main, &workers[k]);
+    }
+    for (int k = 0; k < n_workers; k++) {
+        pthread_join(workers[k].thread, NULL);
+        pthread_mutex_destroy(&workers[k].lock);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    qsort(cands, total, sizeof(*cands), cmp_candidates);
+
+    static const char *rank_names[] = { "iae", "overshoot", "settling" };
+    printf("{\n  \"candidates\": %d,\n  \"threads\": %d,\n  \"simulated_s_each\": %.0f,\n"
+           "  \"wall_ms\": %.1f,\n  \"sims_per_sec\": %.0f,\n  \"rank_by\": \"%s\",\n  \"workers\": [",
+           total, n_workers, base_cfg.duration_ms / 1000.0, wall_ms,
+           (wall_ms > 0.0) ? total * 1000.0 / wall_ms : 0.0, rank_names[rank_by]);
+    for (int k = 0; k < n_workers; k++) {
+        printf("%s{\"done\": %lu, \"steals\": %lu}", k ? ", " : "", workers[k].done, workers[k].steals);
+    }
+    printf("],\n  \"top\": [");
+
+    for (int k = 0; k < top && k < total; k++) {
+        const struct candidate *c = &cands[k];
+        printf("%s\n    {\"kp\": %g, \"ki\": %g, \"kd\": %g, \"iae\": %.1f, \"overshoot_c\": %.3f, "
+               "\"rise_time_s\": %.2f, \"settling_time_s\": %.2f, \"final_error_c\": %.3f, "
+               "\"duty\": %.4f, \"switches\": %u}",
+               k ? "," : "", c->kp, c->ki, c->kd, c->res.iae, c->res.overshoot_c,
+               c->res.rise_time_s, c->res.settling_time_s, c->res.final_error_c, c->res.duty,
+               (unsigned)c->res.switches);
+    }
+
+    char cmds[3][16];
+    build_command(cmds[0], 'p', cands[0].kp);
+    build_command(cmds[1], 'i', cands[0].ki);
+    build_command(cmds[2], 'd', cands[0].kd);
+    int verified = verify_commands(cmds, &cands[0]);
+
+    printf("\n  ],\n  \"commands\": [\"%s\", \"%s\", \"%s\"],\n  \"commands_verified\": %s\n}\n",
+           cmds[0], cmds[1], cmds[2], (verified == 0) ? "true" : "false");
+
+    free(cands);
+    return (verified == 0) ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#include "unity.h"
+#include "taskstats.h"
+
+
+/** \file taskstats_tests.c
+*   \brief Unit tests of the per-task timing statistics
+**
+*        Checks the histogram bucket edges, the percentiles reported
+*       from them and the job timestamps, including counter wrap
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+    taskstats_init(1);
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test small values are exact, larger ones report the upper edge of their bucket and huge ones the maximum
+ */
+void test_TaskStats_BucketEdges(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Histogram Bucket Edges  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────╯\n");
+
+    struct taskstats_summary s;
+
+    // Below 4 cycles every value has its own bucket
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 2);
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 100);
+    taskstats_get(TASK_PID, TASKSTATS_EXEC, &s);
+    printf("   ─> Samples 2 and 100: median %u\n", s.p50);
+    TEST_ASSERT_EQUAL(2, s.p50);
+
+    // 8 and 9 share the bucket [8, 10), 10 starts the next one [10, 12)
+    taskstats_reset();
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 8);
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 100);
+    taskstats_get(TASK_PID, TASKSTATS_EXEC, &s);
+    TEST_ASSERT_EQUAL(9, s.p50);
+
+    taskstats_reset();
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 10);
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 100);
+    taskstats_get(TASK_PID, TASKSTATS_EXEC, &s);
+    printf("   ─> Samples 10 and 100: median %u\n", s.p50);
+    TEST_ASSERT_EQUAL(11, s.p50);
+
+    // The upper edge never goes past the exact extremes
+    taskstats_reset();
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 10);
+    taskstats_get(TASK_PID, TASKSTATS_EXEC, &s);
+    TEST_ASSERT_EQUAL(10, s.p50);
+    TEST_ASSERT_EQUAL(10, s.p99);
+
+    // Values past 2^28 cycles go to the last bucket, reported as the maximum
+    taskstats_reset();
+    taskstats_record(TASK_PID, TASKSTATS_EXEC, 1u << 30);
+    taskstats_get(TASK_PID, TASKSTATS_EXEC, &s);
+    printf("   ─> Sample 2^30: p99 %u, max %u\n", s.p99, s.max);
+    TEST_ASSERT_EQUAL_UINT32(1u << 30, s.p99);
+    TEST_ASSERT_EQUAL_UINT32(1u << 30, s.max);
+    printf("   ─> Test passed: Buckets round up to their upper edge\n\n");
+}
+
+/**
+ * @brief Test the percentile ranks, an empty histogram, invalid arguments and the unit conversion
+ */
+void test_TaskStats_Percentiles(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Histogram Percentiles  === == - │\n");
+    printf(" ╰────────────────────────────────────────────────╯\n");
+
+    struct taskstats_summary s;
+
+    // Nothing recorded yet
+    TEST_ASSERT_EQUAL(0, taskstats_get(TASK_HEATER, TASKSTATS_RESPONSE, &s));
+    TEST_ASSERT_EQUAL(0, s.count);
+    TEST_ASSERT_EQUAL(0, s.p50);
+    TEST_ASSERT_EQUAL(-1, taskstats_get(TASK_COUNT, TASKSTATS_EXEC, &s));
+    TEST_ASSERT_EQUAL(-1, taskstats_get(TASK_PID, TASKSTATS_METRICS, &s));
+
+    // One outlier in 100 samples stays out of the 99th percentile...
+    for (int i = 0; i < 99; i++) {
+        taskstats_record(TASK_PID, TASKSTATS_RESPONSE, 10);
+    }
+    taskstats_record(TASK_PID, TASKSTATS_RESPONSE, 1000);
+    taskstats_get(TASK_PID, TASKSTATS_RESPONSE, &s);
+    printf("   ─> 100 samples: min %u, p50 %u, p99 %u, max %u\n", s.min, s.p50, s.p99, s.max);
+    TEST_ASSERT_EQUAL(100, s.count);
+    TEST_ASSERT_EQUAL(10, s.min);
+    TEST_ASSERT_EQUAL(11, s.p50);
+    TEST_ASSERT_EQUAL(11, s.p99);
+    TEST_ASSERT_EQUAL(1000, s.max);
+
+    // ...a second one in 101 samples moves it to the outlier's bucket, bounded by the maximum
+    taskstats_record(TASK_PID, TASKSTATS_RESPONSE, 1000);
+    taskstats_get(TASK_PID, TASKSTATS_RESPONSE, &s);
+    printf("   ─> 101 samples: p50 %u, p99 %u\n", s.p50, s.p99);
+    TEST_ASSERT_EQUAL(11, s.p50);
+    TEST_ASSERT_EQUAL(1000, s.p99);
+
+    // Jobs split into jitter, execution and response, across a counter wrap, in microseconds
+    taskstats_init(64);
+    taskstats_record_job(TASK_SENSOR, 0xFFFFFFFFu - 639, 640, 640 + 64 * 250);
+    taskstats_get(TASK_SENSOR, TASKSTATS_JITTER, &s);
+    TEST_ASSERT_EQUAL(20, s.max);
+    taskstats_get(TASK_SENSOR, TASKSTATS_EXEC, &s);
+    TEST_ASSERT_EQUAL(250, s.max);
+    taskstats_get(TASK_SENSOR, TASKSTATS_RESPONSE, &s);
+    TEST_ASSERT_EQUAL(270, s.max);
+    printf("   ─> Test passed: Percentiles follow the sample ranks\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_TaskStats_BucketEdges);
+    RUN_TEST(test_TaskStats_Percentiles);
+
+    return UNITY_END();
+}
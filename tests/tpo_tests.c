@@ -0,0 +1,141 @@
+#include "unity.h"
+#include "tpo.h"
+
+
+/** \file tpo_tests.c
+*   \brief Unit tests of the time-proportional heater output
+**
+*        Checks the rounding of the duty to whole slots at the ends of
+*       its range and the on/off pattern as the slots wrap around
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+/**
+ * @brief Counts the slots on in one window.
+ */
+static int count_on(struct tpo *t) {
+    int on = 0;
+    for (int i = 0; i < t->slots; i++) {
+        on += tpo_tick(t);
+    }
+    return on;
+}
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test the duty is rounded to the nearest whole slot, with 0 and 1000 ‰ fully off and on
+ */
+void test_TPO_OnSlotRounding(void) {
+    printf("\n");
+    printf(" ╭───────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test On-Slot Rounding  === == - │\n");
+    printf(" ╰───────────────────────────────────────────╯\n");
+
+    struct tpo t;
+    tpo_init(&t, 100);
+    TEST_ASSERT_EQUAL(0, count_on(&t));
+
+    // 10 ‰ per slot: 1 ‰ rounds down to off, 5 ‰ rounds up to one slot
+    tpo_set_duty(&t, 0);
+    TEST_ASSERT_EQUAL(0, count_on(&t));
+    tpo_set_duty(&t, 1);
+    TEST_ASSERT_EQUAL(0, count_on(&t));
+    tpo_set_duty(&t, 4);
+    TEST_ASSERT_EQUAL(0, t.on_slots);
+    tpo_set_duty(&t, 5);
+    TEST_ASSERT_EQUAL(1, count_on(&t));
+
+    // 1000 ‰ (or more) keeps the output on for the whole window
+    tpo_set_duty(&t, 1000);
+    TEST_ASSERT_EQUAL(100, count_on(&t));
+    tpo_set_duty(&t, 1500);
+    TEST_ASSERT_EQUAL(100, t.on_slots);
+    TEST_ASSERT_EQUAL(100, count_on(&t));
+
+    // With one slot per ‰, 1 ‰ is one slot on
+    tpo_init(&t, 1000);
+    tpo_set_duty(&t, 1);
+    int on = count_on(&t);
+    printf("   ─> 1 ‰ on 1000 slots: %d slot(s) on\n", on);
+    TEST_ASSERT_EQUAL(1, on);
+
+    // A window needs at least one slot
+    tpo_init(&t, 0);
+    TEST_ASSERT_EQUAL(1, t.slots);
+    tpo_set_duty(&t, 499);
+    TEST_ASSERT_FALSE(tpo_tick(&t));
+    tpo_set_duty(&t, 500);
+    TEST_ASSERT_TRUE(tpo_tick(&t));
+    printf("   ─> Test passed: The duty is rounded to whole slots\n\n");
+}
+
+/**
+ * @brief Test the output switches at most twice per window as the slots wrap, and duty changes wait for the next slot
+ */
+void test_TPO_SlotWrap(void) {
+    printf("\n");
+    printf(" ╭────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Slot Wrap  === == - │\n");
+    printf(" ╰────────────────────────────────────╯\n");
+
+    struct tpo t;
+    char pattern[31] = { 0 };
+    int switches = 0;
+    bool last = false;
+
+    // 30 % on 10 slots, over three windows: on for the first 3 slots of each
+    tpo_init(&t, 10);
+    tpo_set_duty(&t, 300);
+    for (int i = 0; i < 30; i++) {
+        bool out = tpo_tick(&t);
+        TEST_ASSERT_EQUAL(i % 10 < 3, out);
+        switches += (out != last);
+        last = out;
+        pattern[i] = out ? '#' : '.';
+    }
+    printf("   ─> Pattern: %s\n", pattern);
+    TEST_ASSERT_EQUAL(6, switches);
+    TEST_ASSERT_EQUAL(0, t.slot);
+
+    // Raising the duty mid-window applies from the next slot, in the same window
+    for (int i = 0; i < 4; i++) {
+        tpo_tick(&t);
+    }
+    tpo_set_duty(&t, 600);
+    TEST_ASSERT_TRUE(tpo_tick(&t));
+    TEST_ASSERT_TRUE(tpo_tick(&t));
+    TEST_ASSERT_FALSE(tpo_tick(&t));
+    TEST_ASSERT_EQUAL(7, t.slot);
+    printf("   ─> Test passed: The slots wrap every window\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_TPO_OnSlotRounding);
+    RUN_TEST(test_TPO_SlotWrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,251 @@
+#include <string.h>
+#include "unity.h"
+#include "cmdproc.h"
+#include "rtdb.h"
+#include "profile.h"
+#include "uartrx.h"
+
+
+/** \file uartrx_tests.c
+*   \brief Unit tests of the UART receive path
+**
+*        Feeds frames through a model of the async UART driver, which
+*       fills one receive buffer while the next one is queued, and
+*       checks long frames reach the command processor whole
+**
+* \author Pedro Ramos, n.º 107348
+* \author Rafael Morgado, n.º 104277
+* \date 01/06/2025
+*/
+
+
+#define RX_CHUNK 7   /**< Characters per RX_RDY event (line idle between chunks) */
+
+/**
+ * @brief Model of the nRF UARTE async receiver.
+ *
+ * Requests the next buffer as soon as a buffer is in use, reports the
+ * received characters in chunks, and moves to the queued buffer when the
+ * current one is full. With no buffer queued, reception stops.
+ */
+struct uarte_model {
+    uint8_t *cur;       /**< Buffer being filled */
+    uint8_t *queued;    /**< Buffer queued by the last buffer request */
+    size_t pos;         /**< Characters in the current buffer */
+    size_t reported;    /**< Characters of the current buffer already reported */
+    int requests;       /**< Buffer requests raised */
+    int stopped;        /**< Times reception stopped for lack of a buffer */
+    int frames;         /**< Complete frames */
+    int overflows;      /**< Discarded frames */
+};
+
+static struct uartrx rx;
+static struct uarte_model uarte;
+
+/**
+ * @brief Buffer request: answered the way main.c does, with the other buffer.
+ */
+static void uarte_buf_request(void) {
+    uarte.requests++;
+    uarte.queued = uartrx_buf_next(&rx);
+    TEST_ASSERT_TRUE(uarte.queued != uarte.cur);
+}
+
+/**
+ * @brief RX_RDY: the new characters of the current buffer go to the frame assembler.
+ */
+static void uarte_rx_rdy(void) {
+    for (size_t i = uarte.reported; i < uarte.pos; i++) {
+        switch (uartrx_char(&rx, uarte.cur[i])) {
+            case UARTRX_FRAME:
+                uarte.frames++;
+                break;
+            case UARTRX_OVERFLOW:
+                uarte.overflows++;
+                break;
+            default:
+                break;
+        }
+    }
+    uarte.reported = uarte.pos;
+}
+
+/**
+ * @brief Enables reception, as at boot.
+ */
+static void uarte_enable(void) {
+    memset(&uarte, 0, sizeof(uarte));
+    uartrx_init(&rx);
+    uarte.cur = uartrx_buf_next(&rx);
+    uarte_buf_request();
+}
+
+/**
+ * @brief Receives a string, one character at a time, through the driver model.
+ */
+static void uarte_receive(const char *s, size_t len) {
+    for (size_t k = 0; k < len; k++) {
+        if (uarte.cur == NULL) {
+            //  Stopped: the character is lost until reception is enabled again
+            continue;
+        }
+        uarte.cur[uarte.pos++] = (uint8_t)s[k];
+
+        if (uarte.pos == UARTRX_DMA_SIZE) {
+            //  Buffer full: report it, release it and switch to the queued one
+            uarte_rx_rdy();
+            uarte.cur = uarte.queued;
+            uarte.queued = NULL;
+            uarte.pos = 0;
+            uarte.reported = 0;
+            if (uarte.cur == NULL) {
+                uarte.stopped++;
+            } else {
+                uarte_buf_request();
+            }
+        } else if (uarte.pos - uarte.reported == RX_CHUNK) {
+            uarte_rx_rdy();
+        }
+    }
+    if (uarte.cur != NULL) {
+        uarte_rx_rdy();
+    }
+}
+
+/**
+ * @brief Builds a frame around a payload, with its checksum.
+ * @return Frame length.
+ */
+static int make_frame(char *frame, const char *payload) {
+    return sprintf(frame, "#%s%03d!", payload, calcChecksum((unsigned char *)payload, strlen(payload)));
+}
+
+
+/**
+ * @brief Set up function executed before each test.
+ */
+void setUp(void) {
+    resetTxBuffer();
+    resetRxBuffer();
+    uarte_enable();
+}
+
+/**
+ * @brief Tear down function executed after each test.
+ */
+void tearDown(void) {
+}
+
+
+/**
+ * @brief Test an 8-point gain schedule, longer than two receive buffers, arrives whole over the async path
+ */
+void test_UartRx_GainScheduleFrame(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test 8-Point #B over the Async UART  === == - │\n");
+    printf(" ╰─────────────────────────────────────────────────────────╯\n");
+
+    char payload[UART_RX_SIZE], frame[UART_RX_SIZE + 8];
+    int n = sprintf(payload, "Bs%d", GAINSCHED_MAX);
+    for (int k = 0; k < GAINSCHED_MAX; k++) {
+        n += sprintf(payload + n, "%03d%05d%05d%05d", 20 + 10 * k, 1000 + 500 * k, 100 + k, 10 * k);
+    }
+    int len = make_frame(frame, payload);
+    printf("   ─> Frame of %d characters, receive buffers of %d\n", len, UARTRX_DMA_SIZE);
+    TEST_ASSERT_EQUAL(8 + 18 * GAINSCHED_MAX, len);
+    TEST_ASSERT_GREATER_THAN(2 * UARTRX_DMA_SIZE, len);
+
+    // Some noise on the line first, so the frame straddles the buffer switches
+    uarte_receive("xx", 2);
+    uarte_receive(frame, len);
+    printf("   ─> Buffer requests: %d, stops: %d, frames: %d\n", uarte.requests, uarte.stopped, uarte.frames);
+    TEST_ASSERT_EQUAL(0, uarte.stopped);
+    TEST_ASSERT_EQUAL(3, uarte.requests);
+    TEST_ASSERT_EQUAL(1, uarte.frames);
+
+    // The command processor gets the whole frame and installs the schedule
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+
+    struct gain_schedule gs;
+    rtdb_get_gain_schedule(&gs);
+    TEST_ASSERT_EQUAL(GAINSCHED_MAX, gs.count);
+    TEST_ASSERT_EQUAL(GAINSCHED_SETPOINT, gs.key);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 90.0f, gs.points[GAINSCHED_MAX - 1].temp_c);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 4.5f, gs.points[GAINSCHED_MAX - 1].kp);
+    printf("   ─> Test passed: The schedule arrived in one frame\n\n");
+}
+
+/**
+ * @brief Test a full 8-segment profile arrives whole over the async path
+ */
+void test_UartRx_ProfileFrame(void) {
+    printf("\n");
+    printf(" ╭───────────────────────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test 8-Segment #F over the Async UART  === == - │\n");
+    printf(" ╰───────────────────────────────────────────────────────────╯\n");
+
+    char payload[UART_RX_SIZE], frame[UART_RX_SIZE + 8];
+    int n = sprintf(payload, "F%d", PROFILE_MAX);
+    for (int k = 0; k < PROFILE_MAX; k++) {
+        n += sprintf(payload + n, "%04d%04d%05d", 50 + 10 * k, 300 + 50 * k, 60 * (k + 1));
+    }
+    int len = make_frame(frame, payload);
+    printf("   ─> Frame of %d characters, receive buffers of %d\n", len, UARTRX_DMA_SIZE);
+    TEST_ASSERT_EQUAL(7 + 13 * PROFILE_MAX, len);
+
+    uarte_receive(frame, len);
+    TEST_ASSERT_EQUAL(0, uarte.stopped);
+    TEST_ASSERT_EQUAL(1, uarte.frames);
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+
+    struct profile prog;
+    rtdb_get_profile(&prog);
+    printf("   ─> Profile of %u segments, last target %.1f C\n", prog.count, prog.segments[PROFILE_MAX - 1].target_c);
+    TEST_ASSERT_EQUAL(PROFILE_MAX, prog.count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 65.0f, prog.segments[PROFILE_MAX - 1].target_c);
+    TEST_ASSERT_EQUAL(480000, prog.segments[PROFILE_MAX - 1].hold_ms);
+    printf("   ─> Test passed: The profile arrived in one frame\n\n");
+}
+
+/**
+ * @brief Test a frame longer than UART_RX_SIZE is dropped and the next one still gets through
+ */
+void test_UartRx_Overflow(void) {
+    printf("\n");
+    printf(" ╭─────────────────────────────────────────╮\n");
+    printf(" │ - == ===  Test Frame Overflow  === == - │\n");
+    printf(" ╰─────────────────────────────────────────╯\n");
+
+    char junk[UART_RX_SIZE + 20];
+    memset(junk, '1', sizeof(junk));
+    junk[0] = SOF_SYM;
+    uarte_receive(junk, sizeof(junk));
+    TEST_ASSERT_EQUAL(1, uarte.overflows);
+    TEST_ASSERT_EQUAL(0, uarte.frames);
+
+    // The rest of the long frame is ignored, the next frame is not
+    char frame[16];
+    int len = make_frame(frame, "D");
+    uarte_receive("1111!", 5);
+    uarte_receive(frame, len);
+    printf("   ─> Overflows: %d, frames: %d\n", uarte.overflows, uarte.frames);
+    TEST_ASSERT_EQUAL(1, uarte.frames);
+    TEST_ASSERT_EQUAL(0, cmdProcessor());
+    printf("   ─> Test passed: Overlong frames are dropped\n\n");
+}
+
+
+/**
+ * @brief Main function to run all unit tests.
+ * @return Test result (0 if all tests pass, otherwise failure).
+ */
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_UartRx_GainScheduleFrame);
+    RUN_TEST(test_UartRx_ProfileFrame);
+    RUN_TEST(test_UartRx_Overflow);
+
+    return UNITY_END();
+}